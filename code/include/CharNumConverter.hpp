@@ -11,6 +11,8 @@
 
 #include <stdio.h>
 #include <vector>
+#include <stdexcept>
+#include <boost/cstdint.hpp>
 
 #include "Sequence.hpp"
 #include "AlphabetDNA.hpp"
@@ -28,13 +30,15 @@ namespace gmsuite {
      * a character in the alphabet.
      *
      * Accordingly, this class handles the conversion of characters to and from numbers
-     * based on the supplied alphabet.
+     * based on the supplied alphabet. Conversions are done through 256-entry lookup tables
+     * (indexed directly by character or element), so that whole genomes can be converted
+     * without a search per letter.
      */
     class CharNumConverter {
         
     public:
         
-        typedef int element_t;                  /**< type of the element */
+        typedef boost::uint8_t element_t;       /**< type of the element (one byte: alphabets have far fewer than 256 characters) */
         typedef vector<element_t> seq_t;        /**< type of a sequence of elements */
         
         /**
@@ -70,6 +74,19 @@ namespace gmsuite {
         void convert(Sequence::const_iterator begin, Sequence::const_iterator end, seq_t &result) const;
         
         
+        /**
+         * Convert sequence text (e.g. straight from a file) to its numeric representation,
+         * skipping whitespace such as line breaks.
+         *
+         * @param begin the start of the text
+         * @param end the end of the text
+         * @param result the output numeric representation of the text
+         *
+         * @exception out_of_range if a non-whitespace character is not in the converter's alphabet
+         */
+        void convertText(const char* begin, const char* end, seq_t &result) const;
+        
+        
         /**
          * Convert a single character to its numeric representation.
          *
@@ -123,15 +140,37 @@ namespace gmsuite {
          */
         element_t complement(element_t original) const;
         
+        /**
+         * Reverse complement a numeric DNA sequence in place
+         *
+         * @param begin the start of the sequence
+         * @param end the end of the sequence
+         * @exception out_of_range if numeric element is not in the valid conversion range
+         */
+        void reverseComplement(seq_t::iterator begin, seq_t::iterator end) const;
+        
         
     private:
         
+        static const element_t NO_ELEMENT = 0xFF;       /**< marks table entries with no element */
+        
         const AlphabetDNA* alphabet;                    /**< the alphabet used by the converter */
-        map<char, element_t> charToNum;                 /**< convert from character to element */
-        map<element_t, char> numToChar;                 /**< convert from element to character */
-        map<element_t, element_t> complementDNA;        /**< complement DNA "elements" */
+        element_t charToNum[256];                       /**< convert from character to element (NO_ELEMENT if not in alphabet) */
+        char numToChar[256];                            /**< convert from element to character */
+        element_t complementDNA[256];                   /**< complement DNA "elements" (NO_ELEMENT if out of range) */
+        element_t numElements;                          /**< number of elements (i.e. alphabet size) */
         
     };
+    
+    
+    // Complement DNA element
+    inline CharNumConverter::element_t CharNumConverter::complement(element_t original) const {
+        element_t result = complementDNA[original];
+        if (result == NO_ELEMENT)
+            throw std::out_of_range("Element is not in the converter's alphabet.");
+        
+        return result;
+    }
 
     
 }
@@ -12,6 +12,7 @@
 #include <stdio.h>
 
 #include "NumSequence.hpp"
+#include "SequenceBatch.hpp"
 
 namespace gmsuite {
     
@@ -29,33 +30,35 @@ namespace gmsuite {
         virtual ~CountModels();
         
         /**
-         * Construct counts from a set of motifs.
+         * Construct counts from a set of motifs. Invalid rows of the batch are not counted.
          *
          * @param sequences the sequences
          * @param positions the positions of motifs in these sequences
          */
-        virtual void construct(const vector<NumSequence> &sequences, const vector<NumSequence::size_type> &positions) = 0;
+        virtual void construct(const SequenceBatch &sequences, const vector<NumSequence::size_type> &positions) = 0;
         
         
         /**
          * Decount a motif
          *
-         * @param sequence the sequence to decount
+         * @param sequences the sequences
+         * @param n the row of the sequence to decount
          * @param pos the position of the motif in the sequence
          *
          * @exception invalid_argument if pos is not a valid motif location in the sequence
          */
-        virtual void decount(const NumSequence &sequence, NumSequence::size_type pos) = 0;
+        virtual void decount(const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos) = 0;
         
         /**
          * Count a motif
          *
-         * @param sequence the sequence to count
+         * @param sequences the sequences
+         * @param n the row of the sequence to count
          * @param pos the position of the motif in the sequence
          *
          * @exception invalid_argument if pos is not a valid motif location in the sequence
          */
-        virtual void count(const NumSequence &sequence, NumSequence::size_type pos) = 0;
+        virtual void count(const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos) = 0;
         
         /**
          * Get string representation of counting models
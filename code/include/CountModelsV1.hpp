@@ -21,6 +21,15 @@
 
 namespace gmsuite {
     
+    /**
+     * @class CountModelsV1
+     * @brief Motif, background and position counts of a motif alignment
+     *
+     * Background counts are made up of all words of the sequences, minus the words that
+     * overlap a motif. The words of all sequences are counted once on construction, so
+     * that counting or decounting a motif only touches the words overlapping its window,
+     * i.e. O(width + order) rather than O(sequence length).
+     */
     class CountModelsV1 : public CountModels {
         
         friend class ProbabilityModelsV1;
@@ -50,33 +59,37 @@ namespace gmsuite {
         
         
         /**
-         * Construct counts from a set of motifs.
+         * Construct counts from a set of motifs. Invalid rows of the batch are not counted.
          *
          * @param sequences the sequences
          * @param positions the positions of motifs in these sequences
          */
-        void construct(const vector<NumSequence> &sequences, const vector<NumSequence::size_type> &positions);
+        void construct(const SequenceBatch &sequences, const vector<NumSequence::size_type> &positions);
         
         
         /**
-         * Decount a motif
+         * Decount a motif. The words overlapping the motif are returned to the background.
+         * The sequence must be one of those the counts were constructed from.
          *
-         * @param sequence the sequence to decount
+         * @param sequences the sequences
+         * @param n the row of the sequence to decount
          * @param pos the position of the motif in the sequence
          *
          * @exception invalid_argument if pos is not a valid motif location in the sequence
          */
-        void decount(const NumSequence &sequence, NumSequence::size_type pos);
+        void decount(const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos);
         
         /**
-         * Count a motif
+         * Count a motif. The words overlapping the motif are removed from the background.
+         * The sequence must be one of those the counts were constructed from.
          *
-         * @param sequence the sequence to count
+         * @param sequences the sequences
+         * @param n the row of the sequence to count
          * @param pos the position of the motif in the sequence
          *
          * @exception invalid_argument if pos is not a valid motif location in the sequence
          */
-        void count(const NumSequence &sequence, NumSequence::size_type pos);
+        void count(const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos);
         
         
         /**
@@ -87,6 +100,17 @@ namespace gmsuite {
         
     private:
         
+        /**
+         * Get the region of a sequence whose background words overlap a motif window;
+         * i.e. the words fully contained in [begin, end) are those overlapping the window.
+         *
+         * @param length the length of the sequence
+         * @param pos the position of the motif in the sequence
+         * @param begin the output start of the region
+         * @param end the output end of the region (exclusive)
+         */
+        void backgroundRegion(NumSequence::size_type length, NumSequence::size_type pos, NumSequence::size_type &begin, NumSequence::size_type &end) const;
+        
         const NumAlphabetDNA* alphabet;                /**< alphabet */
         NumSequence::size_type width;               /**< motif width */
         unsigned motifOrder;                        /**< order for motif model */
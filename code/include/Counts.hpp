@@ -13,6 +13,7 @@
 
 #include "NumAlphabetDNA.hpp"
 #include "NumSequence.hpp"
+#include "NumSequenceView.hpp"
 
 namespace gmsuite {
     
@@ -59,6 +60,24 @@ namespace gmsuite {
         virtual void decount(NumSequence::const_iterator begin, NumSequence::const_iterator end, bool reverseComplement=false);
         
         
+        /**
+         * Count a sequence view. Negative-strand views are counted through the reverse
+         * complement option, so the view's elements are never copied.
+         *
+         * @param view the view
+         */
+        void count(const NumSequenceView &view);
+        
+        
+        /**
+         * Decount a sequence view.
+         *
+         * @param view the view
+         * @see count(const NumSequenceView&)
+         */
+        void decount(const NumSequenceView &view);
+        
+        
         /**
          * Get the model's order
          *
@@ -12,11 +12,14 @@
 #include <stdio.h>
 #include <string>
 #include <map>
+#include <boost/thread/mutex.hpp>
 
 #include "Label.hpp"
+#include "LabelSet.hpp"
 
 #include "UnivariatePDF.hpp"
 #include "NumSequence.hpp"
+#include "NumSequenceIndex.hpp"
 #include "NumGeneticCode.hpp"
 #include "UniformMarkov.hpp"
 #include "OptionsMFinder.hpp"
@@ -24,6 +27,7 @@
 #include "NonUniformMarkov.hpp"
 #include "ProkGeneStartModel.hpp"
 #include "OptionsGMS2Training.hpp"
+#include "ModelWriter.hpp"
 
 using std::map;
 using std::string;
@@ -31,6 +35,10 @@ using std::pair;
 
 namespace gmsuite {
     
+    class CodingCounts;
+    class NonCodingCounts;
+    class NonUniformCounts;
+    
     
     class GMS2TrainerParameters {
         
@@ -127,6 +135,8 @@ namespace gmsuite {
     public:
         
         typedef ProkGeneStartModel::genome_group_t genome_group_t;
+        typedef vector<const NumSequence*> contig_set_t;            /**< Contigs of a genome (not owned by the trainer) */
+        typedef vector<vector<Label*> > contig_labels_t;            /**< Labels of each contig, in contig coordinates */
         
         class Builder;                  // used for easy building of the many GMS2Trainer parameters
         /**
@@ -236,19 +246,61 @@ namespace gmsuite {
          */
         void estimateParameters(const NumSequence &sequence, const vector<Label*> &labels);
         
+        /**
+         * Train on a genome made up of several contigs (e.g. a draft assembly). Labels are given
+         * per contig, in the contig's coordinates and sorted by left position. Coding, noncoding,
+         * start-context and start/stop counts are accumulated contig by contig, with contigs
+         * distributed over worker threads; motif searches are run once, over the upstream regions
+         * of all contigs. No k-mer or operon spans two contigs.
+         *
+         * With more than one thread, the motif models are estimated while contigs are counted,
+         * and the promoter and RBS searches of a genome group run at the same time. The threads
+         * are one budget, whatever the number of threads in the motif-finder options: counting
+         * takes at most half of them, and the motif searches run their restarts on the rest
+         * (split between the two searches of a group).
+         *
+         * @param contigs the genome's contigs
+         * @param labels the labels of each contig
+         * @param numThreads the number of threads used in training
+         *
+         * @throw invalid_argument if labels and contigs differ in number, or if a label is NULL
+         * or lies outside its contig
+         */
+        void estimateParameters(const vector<NumSequence> &contigs, const contig_labels_t &labels, unsigned numThreads = 1);
+        
+        /**
+         * Train on a genome made up of several contigs, with the labels of each contig given as
+         * a compact label set. Labels for the coding model are selected from the label sets'
+         * columns; see estimateParameters(const vector<NumSequence>&, const contig_labels_t&, unsigned).
+         *
+         * @throw invalid_argument if labels and contigs differ in number, or if a label lies
+         * outside its contig
+         */
+        void estimateParameters(const vector<NumSequence> &contigs, const vector<LabelSet> &labels, unsigned numThreads = 1);
+        
+        /**
+         * Use prebuilt prefix-count indexes of the contigs (e.g. kept across trainings), instead of
+         * building them during the next training. Indexes that were not built from the contigs
+         * being trained on are ignored.
+         *
+         * @param indexes the index of each contig
+         */
+        void setContigIndexes(const vector<NumSequenceIndex> &indexes);
+        
         void estimateParamtersCoding(const NumSequence &sequence, const vector<Label *> &labels, NumSequence::size_type scSize = 0, const vector<bool> &use = vector<bool>());
         void estimateParamtersNonCoding(const NumSequence &sequence, const vector<Label *> &labels, const vector<bool> &use = vector<bool>());
         void estimateParametersStartContext(const NumSequence &sequence, const vector<Label *> &labels, const vector<bool> &use = vector<bool>());
         void estimateParametersMotifModel(const NumSequence &sequence, const vector<Label *> &labels, const vector<bool> &use = vector<bool>());
+        void estimateParametersMotifModel(const contig_set_t &contigs, const contig_labels_t &labels, const vector<vector<bool> > &use = vector<vector<bool> >());
         void estimateParametersStartStopCodons(const NumSequence &sequence, const vector<Label*> &labels, const vector<bool> &use = vector<bool>());
         
-        void estimateParametersMotifModel_GroupA(const NumSequence &sequence, const vector<Label *> &labels);
-        void estimateParametersMotifModel_groupA2(const NumSequence &sequence, const vector<Label *> &labels);
-        void estimateParametersMotifModel_GroupB(const NumSequence &sequence, const vector<Label *> &labels);
-        void estimateParametersMotifModel_GroupC(const NumSequence &sequence, const vector<Label *> &labels);
-        void estimateParametersMotifModel_GroupC2(const NumSequence &sequence, const vector<Label *> &labels);
-        void estimateParametersMotifModel_GroupD(const NumSequence &sequence, const vector<Label *> &labels);
-        void estimateParametersMotifModel_GroupE(const NumSequence &sequence, const vector<Label*> &labels);
+        void estimateParametersMotifModel_GroupA(const contig_set_t &contigs, const contig_labels_t &labels);
+        void estimateParametersMotifModel_groupA2(const contig_set_t &contigs, const contig_labels_t &labels);
+        void estimateParametersMotifModel_GroupB(const contig_set_t &contigs, const contig_labels_t &labels);
+        void estimateParametersMotifModel_GroupC(const contig_set_t &contigs, const contig_labels_t &labels);
+        void estimateParametersMotifModel_GroupC2(const contig_set_t &contigs, const contig_labels_t &labels);
+        void estimateParametersMotifModel_GroupD(const contig_set_t &contigs, const contig_labels_t &labels);
+        void estimateParametersMotifModel_GroupE(const contig_set_t &contigs, const contig_labels_t &labels);
         
         
         // public variables for models
@@ -272,13 +324,84 @@ namespace gmsuite {
         
         
         
-        void toModFile(vector<pair<string, string> > &toMod, const OptionsGMS2Training &options) const;
+        /**
+         * Write the models and parameters to a model file, in a single streaming pass
+         *
+         * @param writer the model writer
+         * @param options the training options (some of which are written to the file)
+         */
+        void toModFile(ModelWriter &writer, const OptionsGMS2Training &options) const;
         
     private:
         void deallocAllModels();
         
         
         void selectLabelsForCodingParameters(const vector<Label*> &labels, vector<bool> &useCoding) const;
+        void selectLabelsForCodingParameters(const LabelSet &labels, vector<bool> &useCoding) const;
+        
+        struct contig_counts_t;             // counts accumulated over contigs (defined in source file)
+        
+        /**
+         * Contigs shared between counting workers
+         */
+        typedef struct {
+            size_t nextContig;                          // next contig to be claimed by a worker
+            boost::mutex lock;                          // protects the above
+        } contig_queue_t;
+        
+        /**
+         * Train on a set of contigs; see estimateParameters(const vector<NumSequence>&, ...).
+         * The labels of each contig used for the coding model are selected by the caller.
+         */
+        void estimateParametersContigs(const contig_set_t &contigs, const contig_labels_t &labels, const vector<vector<bool> > &useCoding, unsigned numThreads);
+        
+        /**
+         * Count contigs on countingThreads workers, and build the coding, noncoding, start-context and
+         * start/stop codon models from the counts. These do not depend on the motif models, and
+         * may be built while the motif models are being estimated.
+         */
+        void estimateParametersFromCounts(const contig_set_t &contigs, const contig_labels_t &labels, const vector<vector<bool> > &useCoding);
+        
+        /**
+         * Run the promoter and RBS motif searches, which set the promoter and RBS models and their
+         * spacers. With more than one motif thread, both searches run at the same time, and the
+         * motif threads are split between their restarts.
+         */
+        void runMotifFinders(const vector<NumSequenceView> &upstreamsPromoter, const OptionsMFinder &optionsPromoter, size_t upstreamLengthPromoter,
+                             const vector<NumSequenceView> &upstreamsRBS, const OptionsMFinder &optionsRBS, size_t upstreamLengthRBS);
+        
+        /**
+         * Worker loop: repeatedly claim the next uncounted contig and add its counts to the
+         * worker's own counts, until all contigs are counted.
+         *
+         * @param contigs the contigs
+         * @param labels the labels of each contig
+         * @param useCoding the labels of each contig selected for coding parameters
+         * @param counts the worker's counts
+         * @param queue the contigs shared between workers
+         */
+        void countContigs(const contig_set_t &contigs, const contig_labels_t &labels, const vector<vector<bool> > &useCoding, contig_counts_t &counts, contig_queue_t &queue) const;
+        
+        // count a single sequence into existing counts
+        void countCoding(const NumSequence &sequence, const vector<Label *> &labels, NumSequence::size_type scSize, const vector<bool> &use, CodingCounts &counts) const;
+        void countNonCoding(const NumSequence &sequence, const vector<Label *> &labels, const vector<bool> &use, NonCodingCounts &counts) const;
+        void countStartContext(const NumSequence &sequence, const vector<Label *> &labels, const vector<bool> &use, NonUniformCounts &counts) const;
+        void countStartStopCodons(const NumSequence &sequence, const vector<Label*> &labels, map<CharNumConverter::seq_t, double> &startCounts, map<CharNumConverter::seq_t, double> &stopCounts) const;
+        
+        // build models from counts
+        void constructStartContext(const NonUniformCounts &counts);
+        void constructStartStopProbs(const map<CharNumConverter::seq_t, double> &startCounts, const map<CharNumConverter::seq_t, double> &stopCounts);
+        
+        unsigned countingThreads;                       // threads counting contigs (set by estimateParameters)
+        unsigned motifThreads;                          // threads running motif searches (set by estimateParameters)
+        vector<NumSequenceIndex> contigIndexes;         // prefix counts of the contigs being trained on (see indexContigs)
+        
+        /**
+         * Get the prefix-count index of each contig, used to check upstream regions for ambiguous
+         * elements. The index is built on first use (unless given through setContigIndexes) and
+         * kept while training the motif models.
+         */
+        const vector<NumSequenceIndex>& indexContigs(const contig_set_t &contigs);
         
         
     public:                 // parameters
@@ -0,0 +1,128 @@
+//
+//  GenomeCache.hpp
+//  GeneMark Suite
+//
+
+#ifndef GenomeCache_hpp
+#define GenomeCache_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "AlphabetDNA.hpp"
+#include "CharNumConverter.hpp"
+#include "NumAlphabetDNA.hpp"
+#include "NumSequence.hpp"
+#include "NumSequenceIndex.hpp"
+#include "LabelSet.hpp"
+
+using std::string;
+using std::vector;
+using std::map;
+using std::pair;
+
+namespace gmsuite {
+    
+    /**
+     * @class GenomeCache
+     * @brief Keeps genomes and label sets loaded across runs of several modules (e.g. in a session)
+     *
+     * Sequence files are read once into their numeric form (one sequence per contig), and label
+     * files once into a label set per contig. Prefix-count indexes of the contigs are built on
+     * first use. Each entry remembers the inode, size and modification time of its file, and
+     * is reloaded when any of them changes (e.g. when labels are rewritten between iterations).
+     *
+     * References returned by the cache remain valid until the same file is requested again
+     * after it changed.
+     */
+    class GenomeCache {
+        
+    public:
+        
+        GenomeCache();
+        
+        /**
+         * Get the contigs of a sequence file, in their numeric form
+         *
+         * @param fnSequence the sequence file
+         * @param contigIDs if not NULL, set to the contigs' identifiers
+         */
+        const vector<NumSequence>& contigs(const string &fnSequence, vector<string> *contigIDs = NULL);
+        
+        /**
+         * Get the prefix-count index of each contig of a sequence file
+         *
+         * @param fnSequence the sequence file
+         */
+        const vector<NumSequenceIndex>& contigIndexes(const string &fnSequence);
+        
+        /**
+         * Get the labels of each contig of a sequence file, from a label file (see LabelFile::read)
+         *
+         * @param fnLabels the label file
+         * @param fnSequence the sequence file, whose contig identifiers the labels are matched to
+         */
+        const vector<LabelSet>& labels(const string &fnLabels, const string &fnSequence);
+        
+        /**
+         * Get the alphabet with which sequences are converted to their numeric form
+         */
+        const NumAlphabetDNA& getAlphabet() const;
+        
+        /**
+         * Drop all cached genomes and labels
+         */
+        void clear();
+        
+        
+    private:
+        
+        // identity, size and modification time of a file
+        typedef struct {
+            long long inode;
+            long long size;
+            long long modified;
+            long long modifiedNanoseconds;
+        } signature_t;
+        
+        typedef struct {
+            signature_t signature;
+            vector<NumSequence> contigs;
+            vector<string> contigIDs;
+            vector<NumSequenceIndex> indexes;           // built on first use
+            size_t version;                             // distinct for each read of a sequence file
+        } genome_t;
+        
+        typedef struct {
+            signature_t signature;
+            size_t genomeVersion;                       // version of the genome the labels were matched to
+            vector<LabelSet> labels;
+        } labels_t;
+        
+        AlphabetDNA alph;
+        CharNumConverter cnc;
+        NumAlphabetDNA numAlph;
+        
+        map<string, genome_t> genomes;                          /**< genomes, by sequence file */
+        map<pair<string, string>, labels_t> labelSets;          /**< labels, by label and sequence file */
+        size_t numGenomeReads;                                  /**< number of sequence files read so far (gives genome versions) */
+        
+        /**
+         * Get a genome, (re)reading it if it's not cached or its file changed
+         */
+        genome_t& genome(const string &fnSequence);
+        
+        /**
+         * Get the signature of a file
+         *
+         * @exception invalid_argument if the file cannot be checked (e.g. it doesn't exist)
+         */
+        static signature_t fileSignature(const string &path);
+        
+        static bool sameSignature(const signature_t &a, const signature_t &b);
+    };
+}
+
+#endif /* GenomeCache_hpp */
@@ -12,12 +12,15 @@
 #include <stdio.h>
 #include <string>
 #include <vector>
+#include <map>
 #include <boost/iostreams/device/mapped_file.hpp>
 
 #include "Label.hpp"
+#include "LabelSet.hpp"
 
 using std::string;
 using std::vector;
+using std::map;
 namespace io = boost::iostreams;
 
 namespace gmsuite {
@@ -61,6 +64,56 @@ namespace gmsuite {
         void read(vector<Label*> &output) const;
         
         
+        /**
+         * Read labels from file into a contiguous vector, without allocating each label
+         * separately. This behaves differently for separate file formats.
+         *
+         * @param output the labels that have been read from the file.
+         */
+        void read(vector<Label> &output) const;
+        
+        
+        /**
+         * Read labels from file into a compact label set.
+         *
+         * @param output the labels that have been read from the file.
+         */
+        void read(LabelSet &output) const;
+        
+        
+        /**
+         * Read labels from file, grouped by the sequence (e.g. contig) they belong to. For LST
+         * files, the sequence of a label is the ID given in the closest SequenceID line above it.
+         *
+         * @param output the label pointers of each sequence, keyed by sequence ID
+         */
+        void read(map<string, vector<Label*> > &output) const;
+        
+        
+        /**
+         * Read the labels of each of the given sequences (e.g. contigs), matching them by sequence
+         * ID. If no ID in the file matches a sequence, IDs are taken as 1-based ordinals of the
+         * sequences instead (e.g. "SequenceID: 1"). If a single sequence is given and the file has a
+         * single sequence ID, the sequence takes all labels in the file.
+         *
+         * @param sequenceIDs the IDs of the sequences
+         * @param output the label pointers of each sequence, in the order of sequenceIDs
+         * @exception invalid_argument if the file has labels, and one of its IDs matches no sequence
+         */
+        void read(const vector<string> &sequenceIDs, vector<vector<Label*> > &output) const;
+        
+        
+        /**
+         * Read the labels of each of the given sequences (e.g. contigs) into compact label sets,
+         * matching them as read(sequenceIDs, vector<vector<Label*> >&) does.
+         *
+         * @param sequenceIDs the IDs of the sequences
+         * @param output the label set of each sequence, in the order of sequenceIDs
+         * @exception invalid_argument if the file has labels, and one of its IDs matches no sequence
+         */
+        void read(const vector<string> &sequenceIDs, vector<LabelSet> &output) const;
+        
+        
         /**
          * Write labels to file. 
          *
@@ -97,11 +150,13 @@ namespace gmsuite {
         
         
         /**
-         * Read labels from LST file.
+         * Read labels from LST file, in a single pass over the mapped file.
          *
-         * @param output a vector label pointers that have been read from the file.
+         * @param output the labels that have been read from the file.
+         * @param sequenceIDs the IDs of the sequences, in the order they appear in the file
+         * @param sequenceOfLabel for each label, the index of its sequence ID in sequenceIDs
          */
-        void read_lst(vector<Label*> &output) const;
+        void read_lst(LabelSet &output, vector<string> &sequenceIDs, vector<size_t> &sequenceOfLabel) const;
         
         /**
          * Write labels to LST file.
@@ -0,0 +1,140 @@
+//
+//  LabelIndex.hpp
+//  GeneMark Suite
+//
+
+#ifndef LabelIndex_hpp
+#define LabelIndex_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "Label.hpp"
+#include "LabelSet.hpp"
+
+using std::vector;
+
+namespace gmsuite {
+    
+    /**
+     * @class LabelIndex
+     * @brief An interval index over a list of labels, for neighbor and overlap queries
+     *
+     * The index is built once per list of labels, which need not be sorted and may contain
+     * overlapping or nested genes. Labels are referred to by their position in the original
+     * list. It keeps the labels sorted by left-end, with the label that reaches furthest to
+     * the right among each prefix, and sorted by right-end, with the label that starts
+     * furthest to the left among each suffix; queries then take O(log n).
+     *
+     * Queries can be restricted to labels on one strand; Label::NONE means any strand.
+     */
+    class LabelIndex {
+        
+    public:
+        
+        static const size_t NO_LABEL = (size_t) -1;         /**< Returned when no label satisfies a query */
+        
+        /**
+         * Constructor: build the index over a list of labels
+         *
+         * @param labels the labels
+         * @throw invalid_argument if a label is NULL
+         */
+        LabelIndex(const vector<Label*> &labels);
+        
+        /**
+         * Constructor: build the index over a label set
+         *
+         * @param labels the labels
+         */
+        LabelIndex(const LabelSet &labels);
+        
+        size_t size() const;                                /**< Number of labels */
+        size_t left(size_t n) const;                        /**< Left-end of label n */
+        size_t right(size_t n) const;                       /**< Right-end of label n */
+        Label::strand_t strand(size_t n) const;             /**< Strand of label n */
+        
+        /**
+         * Get the label that ends closest to (or furthest past) a position, among labels that
+         * start before it; i.e. the label with the largest right-end whose left-end is less
+         * than position.
+         *
+         * @param position the position
+         * @param strand if POS or NEG, only labels on that strand are considered
+         * @return the label's index, or NO_LABEL if there is none
+         */
+        size_t closestEndBefore(size_t position, Label::strand_t strand = Label::NONE) const;
+        
+        /**
+         * Get the label that starts closest to (or furthest before) a position, among labels
+         * that end after it; i.e. the label with the smallest left-end whose right-end is
+         * greater than position.
+         *
+         * @param position the position
+         * @param strand if POS or NEG, only labels on that strand are considered
+         * @return the label's index, or NO_LABEL if there is none
+         */
+        size_t closestStartAfter(size_t position, Label::strand_t strand = Label::NONE) const;
+        
+        /**
+         * Get the nearest label upstream of label n: for a label on the positive strand, the
+         * label closest to its left-end (see closestEndBefore); for a label on the negative
+         * strand, the label closest to its right-end (see closestStartAfter).
+         *
+         * @param n the label's index
+         * @param strand if POS or NEG, only labels on that strand are considered
+         * @return the upstream label's index, or NO_LABEL if there is none
+         */
+        size_t upstreamNeighbor(size_t n, Label::strand_t strand = Label::NONE) const;
+        
+        /**
+         * Get the length of the region upstream of label n that is free of other labels,
+         * up to the nearest label or to the sequence boundary.
+         *
+         * @param n the label's index
+         * @param sequenceLength the length of the sequence that the labels are on
+         * @return the free upstream length; 0 if label n overlaps its upstream neighbor
+         */
+        size_t freeUpstreamLength(size_t n, size_t sequenceLength) const;
+        
+        /**
+         * Check whether any label overlaps a region.
+         *
+         * @param left the left-end of the region (inclusive)
+         * @param right the right-end of the region (inclusive)
+         * @return true if a label shares at least one position with the region
+         */
+        bool overlapsLabel(size_t left, size_t right) const;
+        
+        /**
+         * Get the label at a given rank, when labels are sorted by left-end (ties by right-end).
+         *
+         * @param k the rank
+         * @return the label's index
+         */
+        size_t sortedByLeft(size_t k) const;
+        
+        
+    private:
+        
+        vector<size_t> lefts;                           /**< left-end of each label */
+        vector<size_t> rights;                          /**< right-end of each label */
+        vector<Label::strand_t> strands;                /**< strand of each label */
+        
+        vector<size_t> byLeft;                          /**< labels sorted by left-end */
+        vector<size_t> sortedLefts;                     /**< left-ends, in byLeft order */
+        vector<size_t> rightmostEnd[3];                 /**< per strand (POS, NEG, any), label with largest right-end in byLeft[0..k] */
+        
+        vector<size_t> byRight;                         /**< labels sorted by right-end */
+        vector<size_t> sortedRights;                    /**< right-ends, in byRight order */
+        vector<size_t> leftmostStart[3];                /**< per strand (POS, NEG, any), label with smallest left-end in byRight[k..] */
+        
+        /**
+         * Sort the labels and build the prefix/suffix tables, once lefts, rights and strands are set.
+         */
+        void build();
+        
+    };
+}
+
+#endif /* LabelIndex_hpp */
@@ -0,0 +1,129 @@
+//
+//  LabelSet.hpp
+//  GeneMark Suite
+//
+
+#ifndef LabelSet_hpp
+#define LabelSet_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "Label.hpp"
+
+using std::string;
+using std::vector;
+
+namespace gmsuite {
+    
+    /**
+     * @class LabelSet
+     * @brief A compact, column-wise list of labels
+     *
+     * A LabelSet holds the same information as a list of Label objects, but stores each
+     * field in its own array: left, right, strand, and gene class. Gene classes are interned
+     * (each distinct class name is stored once, and labels hold a small class ID), and the
+     * meta strings of all labels live in a single string arena.
+     *
+     * Note: left and right indices start from 0.
+     */
+    class LabelSet {
+        
+    public:
+        
+        typedef unsigned int coord_t;           /**< Type of left/right coordinates */
+        typedef unsigned char class_t;          /**< Type of interned gene class ID */
+        
+        /**
+         * Create an empty label set
+         */
+        LabelSet();
+        
+        /**
+         * Add a label to the end of the set.
+         *
+         * @param left the index of the left-end of the fragment (inclusive)
+         * @param right the index of the right-end of the fragment (inclusive)
+         * @param strand the strand (+,-)
+         * @param classBegin start of the gene class name
+         * @param classEnd end of the gene class name
+         * @param metaBegin start of the meta information
+         * @param metaEnd end of the meta information
+         * @throw invalid_argument if a coordinate (or the meta arena) does not fit in coord_t, or if there are too many gene classes
+         */
+        void add(size_t left, size_t right, Label::strand_t strand, const char* classBegin, const char* classEnd,
+                 const char* metaBegin, const char* metaEnd);
+        
+        /**
+         * Add a label to the end of the set.
+         *
+         * @param label the label
+         */
+        void add(const Label &label);
+        
+        size_t size() const;                                /**< Number of labels */
+        bool empty() const;                                 /**< True if there are no labels */
+        void reserve(size_t numLabels);                     /**< Reserve space for labels */
+        void clear();                                       /**< Remove all labels and classes */
+        
+        coord_t left(size_t n) const;                       /**< Left-end of label n */
+        coord_t right(size_t n) const;                      /**< Right-end of label n */
+        Label::strand_t strand(size_t n) const;             /**< Strand of label n */
+        class_t geneClass(size_t n) const;                  /**< Gene class ID of label n */
+        string meta(size_t n) const;                        /**< Meta information of label n */
+        
+        size_t numClasses() const;                          /**< Number of distinct gene classes */
+        const string& className(class_t geneClass) const;   /**< Name of a gene class */
+        
+        /**
+         * Create a Label object for a label in the set.
+         *
+         * @param n the index of the label
+         * @return the label
+         */
+        Label label(size_t n) const;
+        
+        /**
+         * Create Label objects for all labels in the set, in a contiguous vector.
+         *
+         * @param output the labels
+         */
+        void toLabels(vector<Label> &output) const;
+        
+        /**
+         * Mark the labels whose gene class name contains a given text (e.g. "native").
+         *
+         * @param text the text to look for
+         * @param marked set to true for the labels whose class contains the text; false otherwise
+         */
+        void markClassContaining(const string &text, vector<bool> &marked) const;
+        
+        /**
+         * Remove labels that are shorter than a minimum length, keeping the order of the others.
+         *
+         * @param minimumLength the minimum length of labels that are kept
+         */
+        void removeShorterThan(size_t minimumLength);
+        
+        
+    private:
+        
+        vector<coord_t> lefts;                  /**< left-end of each label */
+        vector<coord_t> rights;                 /**< right-end of each label */
+        vector<unsigned char> strands;          /**< strand of each label */
+        vector<class_t> classes;                /**< gene class ID of each label */
+        vector<coord_t> metaEnds;               /**< end of each label's meta in the arena; it starts at the previous end */
+        string metaArena;                       /**< meta information of all labels, concatenated */
+        
+        vector<string> classNames;              /**< name of each interned gene class */
+        
+        /**
+         * Get the ID of a gene class, interning its name if it's new.
+         */
+        class_t internClass(const char* begin, const char* end);
+        
+    };
+}
+
+#endif /* LabelSet_hpp */
@@ -13,6 +13,8 @@
 #include <vector>
 
 #include "Label.hpp"
+#include "LabelSet.hpp"
+#include "LabelIndex.hpp"
 
 using std::vector;
 
@@ -31,6 +33,16 @@ namespace gmsuite {
         static void partitionBasedOnOperonStatus(const vector<Label*> &labels, size_t fgioThresh, size_t nfgioThresh,
                                                  vector<operon_status_t> &status);
         
+        static void partitionBasedOnOperonStatus(const LabelSet &labels, size_t fgioThresh, size_t nfgioThresh,
+                                                 vector<operon_status_t> &status);
+        
+        /**
+         * Partition labels based on operon status, comparing each label to its nearest upstream
+         * gene in the index. Labels need not be sorted, and may overlap.
+         */
+        static void partitionBasedOnOperonStatus(const LabelIndex &index, size_t fgioThresh, size_t nfgioThresh,
+                                                 vector<operon_status_t> &status);
+        
         static void splitBasedOnPartition(const vector<Label*> &labels, const vector<operon_status_t> &status, vector<Label*> &labelsFGIO, vector<Label*> &labelsIGIO, vector<Label*> &labelsAMBIG );
         
     };
@@ -17,6 +17,8 @@
 
 namespace gmsuite {
     
+    class ModelWriter;
+    
     /**
      * @class Markov
      * @brief An abstract class for Markov models
@@ -94,6 +96,16 @@ namespace gmsuite {
         virtual string toString() const = 0;
         
         
+        /**
+         * Write the model to a model writer, as the value of a key, one row at a time.
+         * The output is the same as that of toString, without building the string.
+         *
+         * @param writer the model writer
+         * @param key the key
+         */
+        virtual void writeTable(ModelWriter &writer, const string &key) const = 0;
+        
+        
         /**
          * Compute the KL-divergence of two Markov models
          *
@@ -15,6 +15,8 @@
 #include <map>
 
 #include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/utility/string_ref.hpp>
 namespace io = boost::iostreams;
 
 using std::map;
@@ -31,6 +33,16 @@ namespace gmsuite {
      * This class is used to handle model files, in which model parameters are stored.
      * The parameters are in a key-value pair format, where keys are signified by
      * the $ sign.
+     *
+     * When a file is opened for reading, it is scanned once to index the position of every
+     * key and value in the mapped file; lookups then go through the index, without
+     * rescanning the file.
+     *
+     * Model files can also be written as a binary image (see writeBinary), which holds the
+     * same key-value pairs, along with numeric values parsed once into flat arrays of
+     * doubles. Images are recognized when opened for reading, and can be read through the
+     * same methods as text files; numeric values are then available from the mapped image
+     * without parsing (see numbersForKey). The text form remains the canonical one.
      */
     class ModelFile {
         
@@ -58,6 +70,13 @@ namespace gmsuite {
          */
         void read(map<string, string> &output) const;
         
+        /**
+         * Read all key-value pairs from the file, in file order
+         *
+         * @param output a list of key-value pair strings where the output is placed
+         */
+        void read(vector<pair<string, string> > &output) const;
+        
         /**
          * Read key-value pairs from the file, for a specific list of keys
          *
@@ -74,17 +93,58 @@ namespace gmsuite {
         string readValueForKey(string key) const;
         
         
+        /**
+         * Get a view of the value of a given key, directly in the mapped file (i.e. without
+         * copying it). The view is valid as long as the file is open.
+         *
+         * @param key the key
+         * @exception invalid_argument if the key is not in the file
+         */
+        boost::string_ref valueViewForKey(const string &key) const;
+        
+        /**
+         * Get the numeric form of the value of a given key, directly in the mapped image, as a
+         * flat row-major array. Values are numeric if they are a single number, or lines that
+         * each hold a label followed by the same number of numbers (e.g. a Markov matrix); the
+         * labels are kept in the text value only. A single line that starts with a number (e.g.
+         * "1 2 3", or a one-entry distribution "0 1.0") is not numeric, since it could either be a
+         * list of numbers or a row labelled by a number; its text value must be parsed instead.
+         *
+         * @param key the key
+         * @param rows set to the number of rows
+         * @param cols set to the number of numbers per row
+         * @return the numbers, or NULL if the value is not numeric or the file is not a binary image
+         * @exception invalid_argument if the key is not in the file
+         */
+        const double* numbersForKey(const string &key, size_t &rows, size_t &cols) const;
+        
         /**
          * Check if the key exists.
          */
         bool keyExists(string key) const;
         
+        /**
+         * Check whether the file is a binary model image.
+         */
+        bool isBinary() const;
+        
+        /**
+         * Get the section header of the file (e.g. NATIVE); empty if it has none.
+         */
+        string getSectionHeader() const;
+        
         
         /**
          * Write model parameters to file in key-value pair format.
          */
         void write(const vector<pair<string, string> > &keyValue, string sectionHeader = "");
         
+        /**
+         * Write model parameters to file as a binary model image. Values are trimmed as in
+         * write(), so that converting the image back to text gives the same file.
+         */
+        void writeBinary(const vector<pair<string, string> > &keyValue, string sectionHeader = "");
+        
         
         
     protected:
@@ -103,6 +163,37 @@ namespace gmsuite {
         char* begin_write;                /**< Start of readwrite mapped file */
         char* end_write;                  /**< End of readwrite mapped file */
         
+        /**
+         * Location of a key-value pair in the mapped file (without the $ sign or surrounding whitespace)
+         */
+        typedef struct {
+            const char* keyBegin;
+            const char* keyEnd;
+            const char* valueBegin;
+            const char* valueEnd;
+            const double* numbers;              // numeric form of the value (binary images only)
+            size_t rows;
+            size_t cols;
+        } entry_t;
+        
+        vector<entry_t> entries;                            /**< key-value pairs, in file order */
+        boost::unordered_map<string, size_t> keyIndex;      /**< entry of each key's first occurrence */
+        
+        bool binary;                                        /**< whether the file is a binary model image */
+        string sectionHeader;                               /**< section header of the file (without the leading __) */
+        
+        /**
+         * Scan the mapped file once, and index all of its key-value pairs
+         */
+        void buildIndex();
+        
+        /**
+         * Check the mapped binary image, and index its key-value pairs from its directory
+         *
+         * @exception invalid_argument if the image is of another version, truncated, or corrupted
+         */
+        void buildIndexFromImage();
+        
 
         /**
          * (Re)open file and reset parameters
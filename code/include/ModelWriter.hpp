@@ -0,0 +1,160 @@
+//
+//  ModelWriter.hpp
+//  GeneMark Suite
+//
+
+#ifndef ModelWriter_hpp
+#define ModelWriter_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <boost/unordered_map.hpp>
+
+#include "Markov.hpp"
+#include "UnivariatePDF.hpp"
+
+using std::string;
+using std::vector;
+
+namespace gmsuite {
+    
+    /**
+     * @class ModelWriter
+     * @brief Writes model parameters to a model file, in a single streaming pass
+     *
+     * The output has the same key-value format as ModelFile::write, but values are
+     * serialized straight into a buffered output as they are given: models write their
+     * tables row by row (see Markov::writeTable), and numbers are formatted without
+     * going through string streams. No intermediate key-value strings are built.
+     *
+     * Values can be overridden by key (e.g. from a settings file): when an overridden
+     * key is written, its override is written in its place. Overrides whose keys are
+     * never written are added at the end of the file, when the writer is closed.
+     */
+    class ModelWriter {
+        
+    public:
+        
+        /**
+         * Constructor: open a model file for writing
+         *
+         * @param path the file's path
+         * @param sectionHeader if not empty, the file starts with the section header (e.g. NATIVE)
+         * @exception invalid_argument if the file cannot be opened
+         */
+        ModelWriter(string path, string sectionHeader = "");
+        
+        /**
+         * Destructor: close the file, if it's still open
+         */
+        ~ModelWriter();
+        
+        /**
+         * Set the values that override those written for the same keys
+         *
+         * @param overrides the values, by key
+         */
+        void setOverrides(const boost::unordered_map<string, string> &overrides);
+        
+        /**
+         * Write a key with a textual value. As in ModelFile::write, the value is trimmed and
+         * written on the key's line, unless it spans multiple lines.
+         */
+        void write(const string &key, const string &value);
+        
+        /**
+         * Write a key with a number in fixed notation (as printed by a stream set to fixed).
+         *
+         * @param key the key
+         * @param value the number
+         * @param precision the number of digits after the decimal point
+         */
+        void writeFixed(const string &key, double value, int precision = 6);
+        
+        /**
+         * Write a key with the table of a Markov model (see Markov::writeTable)
+         */
+        void write(const string &key, const Markov &model);
+        
+        /**
+         * Write a key with a distribution, with one row per position
+         */
+        void write(const string &key, const UnivariatePDF &pdf);
+        
+        /**
+         * Start writing a key whose value is a table; rows are then added with writeRow,
+         * and the table ends with endTable.
+         *
+         * @param key the key
+         * @param precision the number of digits after the decimal point of the table's numbers
+         */
+        void beginTable(const string &key, int precision = 6);
+        
+        /**
+         * Add a row to the current table: its label followed by tab-separated numbers.
+         *
+         * @param label the row's label (e.g. a word)
+         * @param values the row's numbers
+         * @param numValues the number of numbers
+         */
+        void writeRow(const string &label, const double *values, size_t numValues);
+        
+        /**
+         * End the current table.
+         */
+        void endTable();
+        
+        /**
+         * Write the overrides that were not used, flush the buffer, and close the file.
+         */
+        void close();
+        
+        /**
+         * Append a number in fixed notation to a string. The output is the same as that of
+         * a stream set to fixed with the given precision.
+         *
+         * @param output the string to append to
+         * @param value the number
+         * @param precision the number of digits after the decimal point
+         */
+        static void appendFixed(string &output, double value, int precision);
+        
+        
+    private:
+        
+        std::ofstream out;                                  /**< output file */
+        string buffer;                                      /**< pending output, flushed once it's large enough */
+        
+        boost::unordered_map<string, string> overrides;     /**< override values, by key */
+        boost::unordered_map<string, bool> overridden;      /**< keys whose override has been written */
+        
+        // current table
+        bool inTable;                                       /**< whether a table is being written */
+        bool skipTable;                                     /**< whether the current table was overridden */
+        int tablePrecision;                                 /**< precision of the current table's numbers */
+        size_t numRows;                                     /**< number of rows in the current table so far */
+        string firstRow;                                    /**< first row of the current table, until a second row decides its layout */
+        
+        /**
+         * Write a key's override if it has one
+         *
+         * @return true if the key was overridden
+         */
+        bool writeOverride(const string &key);
+        
+        /**
+         * Write a key-value pair as is, without checking for overrides
+         */
+        void writeKeyValue(const string &key, const string &value);
+        
+        /**
+         * Write the buffer to the file, once it's large enough (or always if forced)
+         */
+        void flush(bool force = false);
+    };
+}
+
+#endif /* ModelWriter_hpp */
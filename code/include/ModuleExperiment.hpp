@@ -13,6 +13,8 @@
 
 #include "Module.hpp"
 #include "OptionsExperiment.hpp"
+#include "GenomeCache.hpp"
+#include "ModelFile.hpp"
 
 namespace gmsuite {
     
@@ -28,8 +30,9 @@ namespace gmsuite {
          * Constructor: initialize the ModuleExperiment module with optino parameters
          *
          * @param options the parameters defining how experiments are to be run
+         * @param cache if not NULL, sequences and labels are taken from (and kept in) the cache
          */
-        ModuleExperiment(const OptionsExperiment& options);
+        ModuleExperiment(const OptionsExperiment& options, GenomeCache *cache = NULL);
         
         /**
          * Run module according to the provided options
@@ -39,6 +42,7 @@ namespace gmsuite {
     private:
         
         const OptionsExperiment& options;       /**< Module options */
+        GenomeCache *cache;                     /**< Genomes and labels kept across runs (optional) */
         
         // Each experiment requires a separate run command
         void runMatchSeqToUpstream();
@@ -56,6 +60,25 @@ namespace gmsuite {
         void runPromoterAndRBSMatch();
         void runRbsConsensus16SMatch();
         void runRbsIsLocalized();
+        void runValidateGroups();
+        
+        // Group-validation checks: each gives the output of its experiment, from an open mod file
+        string checkMatchRBSTo16S(const OptionsExperiment::MatchRBSTo16S &expOptions, bool verbose) const;
+        string checkPromoterIsValidForArchaea(const OptionsExperiment::PromoterIsValidForArchaea &expOptions, const ModelFile &mfile) const;
+        string checkPromoterIsValidForBacteria(const OptionsExperiment::PromoterIsValidForBacteria &expOptions, const ModelFile &mfile) const;
+        string checkPromoterAndRBSMatch(const OptionsExperiment::PromoterAndRBSMatch &expOptions, const ModelFile &mfile) const;
+        string checkRbsConsensus16SMatch(const OptionsExperiment::RBSConsensusAnd16SMatch &expOptions, const ModelFile &mfile) const;
+        string checkRbsIsLocalized(const OptionsExperiment::RBSIsLocalized &expOptions, const ModelFile &mfile) const;
+        
+        /**
+         * Run one check of a batch (see runValidateGroups)
+         *
+         * @param check the check
+         * @param mfile the mod file being checked
+         * @param verdict set to the check's output
+         * @param error set to the reason the check failed, if it did
+         */
+        void runValidationCheck(OptionsExperiment::experiment_t check, const ModelFile &mfile, string &verdict, string &error) const;
     };
 }
 
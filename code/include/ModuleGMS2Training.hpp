@@ -13,6 +13,7 @@
 #include "Module.hpp"
 #include "Sequence.hpp"
 #include "OptionsGMS2Training.hpp"
+#include "GenomeCache.hpp"
 
 namespace gmsuite {
     
@@ -28,8 +29,9 @@ namespace gmsuite {
          * Constructor: initialize the MFinder module with option parameters
          *
          * @param options the parameters defining how the module is to be run
+         * @param cache if not NULL, the sequence and labels are taken from (and kept in) the cache
          */
-        ModuleGMS2Training(const OptionsGMS2Training& options);
+        ModuleGMS2Training(const OptionsGMS2Training& options, GenomeCache *cache = NULL);
         
         /**
          * Run the GMS2 module according to the provided options.
@@ -39,6 +41,7 @@ namespace gmsuite {
     private:
         
         const OptionsGMS2Training& options;         /**< Module option */
+        GenomeCache *cache;                         /**< Genomes and labels kept across runs (optional) */
         
         
         
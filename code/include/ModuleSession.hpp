@@ -0,0 +1,77 @@
+//
+//  ModuleSession.hpp
+//  GeneMark Suite
+//
+
+#ifndef ModuleSession_hpp
+#define ModuleSession_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <istream>
+
+#include "Module.hpp"
+#include "GenomeCache.hpp"
+
+using std::string;
+using std::vector;
+
+namespace gmsuite {
+    
+    /**
+     * @class ModuleSession
+     * @brief A long-lived module that runs commands read one per line, sharing loaded genomes
+     *
+     * Each line holds the arguments of one run of biogem, starting with its mode (e.g.
+     * "gms2-training -s genome.fna -l labels.lst -m out.mod --genome-group A", or
+     * "experiment promoter-is-valid-for-bacteria --fnmod out.mod"). Arguments are separated by
+     * whitespace, and may be quoted. The modes gms2-training, experiment and utilities can be
+     * run; genomes and labels are kept in a GenomeCache across commands, so that a driver
+     * iterating over the same genome does not reread and reencode it at every step.
+     *
+     * After each command, a status line is printed to the standard output (after the command's
+     * own output): "##status ok", or "##status error" followed by a message. Empty lines are
+     * skipped; "clear-cache" drops the cached genomes, and "quit" (or end of input) ends the
+     * session.
+     */
+    class ModuleSession : public Module {
+        
+    public:
+        
+        /**
+         * Constructor: initialize a session over a stream of commands
+         *
+         * @param commands the stream from which commands are read (e.g. standard input)
+         */
+        ModuleSession(std::istream &commands);
+        
+        /**
+         * Run commands until the end of the stream, or until "quit"
+         */
+        void run();
+        
+        /**
+         * Split a command line into its arguments, on whitespace outside of quotes.
+         *
+         * @param line the command line
+         * @param words where the arguments are placed
+         * @throw invalid_argument if a quote is not closed
+         */
+        static void splitCommand(const string &line, vector<string> &words);
+        
+    private:
+        
+        std::istream &commands;                 /**< Stream of commands */
+        GenomeCache cache;                      /**< Genomes and labels kept across commands */
+        
+        /**
+         * Run a single command (mode followed by its arguments)
+         *
+         * @throw invalid_argument if the mode is unknown or its arguments cannot be parsed
+         */
+        void runCommand(const vector<string> &words);
+    };
+}
+
+#endif /* ModuleSession_hpp */
@@ -13,8 +13,16 @@
 #include <limits.h>
 #include "AlphabetDNA.hpp"
 #include "NumSequence.hpp"
+#include "NumSequenceView.hpp"
+#include "SequenceBatch.hpp"
 #include "MFinderModelParams.hpp"
 #include "OptionsMFinder.hpp"
+#include "UnivariatePDF.hpp"
+#include "CountModels.hpp"
+#include "ProbabilityModels.hpp"
+
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 
 namespace gmsuite {
@@ -44,6 +52,12 @@ namespace gmsuite {
          * @param maxIter the maximum number of gibbs iterations per try
          * @param maxEMIter the maximum number of iterations for the EM phase
          * @param shiftEvery the number of iterations between every shift-operation
+         * @param filterThresh threshold below which motif positions are filtered out
+         * @param numThreads the number of threads on which tries are run concurrently
+         * @param seed the seed from which the random stream of every try is derived
+         * @param convergeAfter number of iterations without improvement after which a phase stops (0 to disable)
+         * @param timeBudget wall-clock budget in seconds for a findMotifs call, spread across tries (0 for none)
+         * @param iterBudget budget of iterations for a findMotifs call, spread across tries (0 for none)
          */
         MotifFinder(unsigned width,
                     unsigned motifOrder     =   0,
@@ -54,40 +68,138 @@ namespace gmsuite {
                     unsigned maxIter        =   100,
                     unsigned maxEMIter      =   10,
                     unsigned shiftEvery     =   20,
-                    double filterThresh     =   -std::numeric_limits<double>::infinity());
+                    double filterThresh     =   -std::numeric_limits<double>::infinity(),
+                    unsigned numThreads     =   1,
+                    RandomGenerator::result_type seed           =   RandomGenerator::DEFAULT_SEED,
+                    unsigned convergeAfter  =   0,
+                    double timeBudget       =   0,
+                    unsigned iterBudget     =   0);
         
         
         /**
-         * Find motifs in sequences.
+         * Find motifs in sequences. The tries are independent of each other, and are
+         * distributed over numThreads worker threads. Each try draws from its own random
+         * stream (split from the seed by try index), and the best try is chosen in try
+         * order, so the result depends only on the seed and not on the number of threads.
+         *
+         * If a time or iteration budget is set, every try is allotted an even share of the
+         * budget remaining when it starts (a try that converges early leaves its unused
+         * iterations to later tries). Results then also depend on timing, or for iteration
+         * budgets, on the order in which tries complete when running on several threads.
          *
          * @param sequences the sequences to be searched
          * @param positions the motif positions in each sequence
          */
         void findMotifs (const vector<NumSequence> &sequences, vector<NumSequence::size_type> &positions);
         
+        /**
+         * Find motifs in sequence views (e.g. upstream regions extracted from a genome). The search
+         * reads every window of every sequence on each iteration, so the views are copied once into
+         * a batch before the search starts.
+         *
+         * @param sequences the sequences to be searched
+         * @param positions the motif positions in each sequence
+         */
+        void findMotifs (const vector<NumSequenceView> &sequences, vector<NumSequence::size_type> &positions);
+        
+        /**
+         * Find motifs in the valid rows of a batch. Invalid rows are skipped, and get position
+         * NumSequence::npos; the search over the valid rows is the same as over a vector holding
+         * only those rows.
+         *
+         * @param sequences the sequences to be searched
+         * @param positions the motif positions in each row
+         */
+        void findMotifs (const SequenceBatch &sequences, vector<NumSequence::size_type> &positions);
+        
+        unsigned getBestTry() const { return bestTry; }         /**< Get the try whose positions the last findMotifs call output */
+        double getBestScore() const { return bestScore; }       /**< Get the alignment score of that try */
+        
         
     private:
         
+        /**
+         * The budget allotted to a single try
+         */
+        typedef struct {
+            size_t maxIterations;                       // maximum number of iterations (gibbs and EM)
+            boost::posix_time::ptime deadline;          // no iteration is started after this time (not_a_date_time if none)
+        } try_budget_t;
+        
+        /**
+         * Tries shared between workers, and the budget they draw from
+         */
+        typedef struct {
+            unsigned nextTry;                           // next try to be claimed by a worker
+            unsigned numWorkers;                        // number of workers running tries
+            size_t reservedIterations;                  // iterations allotted to tries so far (unused ones are returned)
+            boost::posix_time::ptime start;             // start time of the findMotifs call
+            boost::mutex lock;                          // protects all of the above
+        } try_queue_t;
         
         /**
          * Run a single try of gibbs-finder to search for the best motif alignment.
+         * Each phase (gibbs without filtering, gibbs with filtering, and EM) stops early after
+         * convergeAfter iterations without improvement; EM also stops once no position changes.
          *
          * @param sequences the sequences to be searched
          * @param positions the motif positions in each sequence
+         * @param rng the random stream of the try
+         * @param budget the budget of the try; at least one iteration is always run
+         * @param iterations the output number of iterations run
          * @return the alignment's probability
          */
-        double gibbsFinder(const vector<NumSequence> &sequences, vector<NumSequence::size_type> &positions);
+        double gibbsFinder(const SequenceBatch &sequences, vector<NumSequence::size_type> &positions, RandomGenerator &rng, const try_budget_t &budget, size_t &iterations);
+        
+        /**
+         * Allot a budget to a try, as a share of the remaining budget (called with the queue locked)
+         *
+         * @param queue the queue of tries
+         * @param t the try's index
+         */
+        try_budget_t allotBudget(try_queue_t &queue, unsigned t) const;
+        
+        
+        /**
+         * Worker loop: repeatedly claim the next unprocessed try and run gibbs-finder on it,
+         * until all tries are done. Results are stored at the try's index.
+         *
+         * @param sequences the sequences to be searched
+         * @param generator the generator from which the random stream of each try is split
+         * @param scores the output alignment score for each try
+         * @param positions the output motif positions for each try
+         * @param queue the tries shared between workers
+         */
+        void runTries(const SequenceBatch &sequences, const RandomGenerator &generator, vector<double> &scores, vector<vector<NumSequence::size_type> > &positions, try_queue_t &queue);
         
         
         /**
-         * Attempt to shift positions, and return the sampled amount to shift
+         * Attempt to shift positions, and return the sampled amount to shift. Each shift is
+         * scored by moving the motifs of the existing counts in place (only the words
+         * entering and leaving each motif window are updated), from one shift to the next,
+         * and moving them back after the last.
+         * The models follow each moved motif through their incremental update, and are never
+         * rebuilt from the counts (unless they were built from other counts).
+         *
+         * @param sequences the sequences
+         * @param positions the current motif positions, which the counts were built from
+         * @param counts the counts of the current positions; unchanged on return
+         * @param probs the probability models used to score shifts; current with the counts on entry and on return
+         * @param rng the random number generator
+         */
+        int attemptShift(const SequenceBatch &sequences, const vector<NumSequence::size_type> &positions, CountModels *counts, ProbabilityModels *probs, RandomGenerator &rng);
+        
+        /**
+         * Move motifs in counts from one set of positions to another, updating only the
+         * sequences whose position differs. If probability models are given, they are updated
+         * incrementally after each motif is decounted, and after it is counted again.
          */
-        int attemptShift(const vector<NumSequence> &sequences, const vector<NumSequence::size_type> &positions);
+        void moveMotifs(const SequenceBatch &sequences, const vector<NumSequence::size_type> &from, const vector<NumSequence::size_type> &to, CountModels *counts, ProbabilityModels *probs = NULL) const;
         
         /**
          * Shift positions by a certain amount
          */
-        void shiftPositions(const vector<NumSequence::size_type> &original, int shiftAmount, const vector<NumSequence> &sequences, vector<NumSequence::size_type> &result);
+        void shiftPositions(const vector<NumSequence::size_type> &original, int shiftAmount, const SequenceBatch &sequences, vector<NumSequence::size_type> &result);
         
         
         
@@ -103,6 +215,13 @@ namespace gmsuite {
         AlphabetDNA alphabet                        ;       /**< the alphabet used by the sampler; at the moment, only DNA is available */
         MFinderModelParams::align_t align           ;       /**< whether to align sequences first and use length distribution */
         double filterThresh                         ;       /**< allows filtering of sequences with low scores */
+        unsigned numThreads                         ;       /**< number of threads used to run tries */
+        RandomGenerator::result_type seed           ;       /**< seed of the random streams */
+        unsigned convergeAfter                      ;       /**< number of iterations without improvement before a phase stops (0 to disable) */
+        double timeBudget                           ;       /**< wall-clock budget (in seconds) for finding motifs (0 for none) */
+        unsigned iterBudget                         ;       /**< iteration budget for finding motifs (0 for none) */
+        unsigned bestTry                            ;       /**< try chosen by the last findMotifs call */
+        double bestScore                            ;       /**< alignment score of the try chosen by the last findMotifs call */
         
     };
     
@@ -125,6 +244,11 @@ namespace gmsuite {
         bool        allSeqsPerIter;
         MFinderModelParams::align_t align;
         double        filterThresh;
+        unsigned    numThreads;
+        RandomGenerator::result_type seed;
+        unsigned    convergeAfter;
+        double      timeBudget;
+        unsigned    iterBudget;
         
         
     public:
@@ -141,6 +265,11 @@ namespace gmsuite {
             align           =   MFinderModelParams::NONE;
             allSeqsPerIter  =   true;
             filterThresh    =   -std::numeric_limits<double>::infinity();
+            numThreads      =   1;
+            seed            =   RandomGenerator::DEFAULT_SEED;
+            convergeAfter   =   0;
+            timeBudget      =   0;
+            iterBudget      =   0;
         }
         
         
@@ -157,10 +286,15 @@ namespace gmsuite {
         Builder& setAlign       (const MFinderModelParams::align_t v)       { this->align = v;      return *this;   }
         Builder& fullLoopPerIter(const bool v)                              { this->allSeqsPerIter = v; return *this; }
         Builder& setFilterThresh(const double v)                            { this->filterThresh = v; return *this; }
+        Builder& setNumThreads  (const unsigned v)                          { this->numThreads = v; return *this;   }
+        Builder& setSeed        (const RandomGenerator::result_type v)      { this->seed = v;       return *this;   }
+        Builder& setConvergeAfter(const unsigned v)                         { this->convergeAfter = v; return *this; }
+        Builder& setTimeBudget  (const double v)                            { this->timeBudget = v; return *this;   }
+        Builder& setIterBudget  (const unsigned v)                          { this->iterBudget = v; return *this;   }
         
         // build motif finder with set parameters
         MotifFinder build() {
-            return MotifFinder(width, motifOrder, backOrder, pcounts, align, tries, MAX_ITER, MAX_EM_ITER, shiftEvery, filterThresh);
+            return MotifFinder(width, motifOrder, backOrder, pcounts, align, tries, MAX_ITER, MAX_EM_ITER, shiftEvery, filterThresh, numThreads, seed, convergeAfter, timeBudget, iterBudget);
         }
         
         MotifFinder build(const OptionsMFinder &options) {
@@ -168,6 +302,9 @@ namespace gmsuite {
             this->setMotifOrder(options.motifOrder).setBackOrder(options.bkgdOrder).setWidth(options.width).setPcounts(options.pcounts);
             this->setAlign(options.align);
             this->setFilterThresh(options.filterThresh);
+            this->setNumThreads(options.numThreads);
+            this->setSeed(options.seed);
+            this->setConvergeAfter(options.convergeAfter).setTimeBudget(options.timeBudget).setIterBudget(options.iterBudget);
             return build();
         }
 
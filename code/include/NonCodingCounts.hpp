@@ -19,6 +19,9 @@ namespace gmsuite {
         
     public:
         
+        using Counts::count;
+        using Counts::decount;
+        
         /**
          * Constructor: Create a uniform count model by defining it's order and alphabet
          *
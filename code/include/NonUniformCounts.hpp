@@ -26,6 +26,7 @@ namespace gmsuite {
     class NonUniformCounts : public Counts {
         
         friend class NonUniformMarkov;
+        friend class ProbabilityModelsV1;
         
     public:
         
@@ -70,6 +71,17 @@ namespace gmsuite {
         void resetCounts();
         
         
+        /**
+         * Add the counts of another model with the same order and structure (e.g. counts
+         * of a different part of the genome)
+         *
+         * @param other the model whose counts are added
+         *
+         * @throw invalid_argument if the models' structures differ
+         */
+        void add(const NonUniformCounts &other);
+        
+        
     protected:
         
         /**
@@ -73,6 +73,11 @@ namespace gmsuite {
          */
         string toString() const;
         
+        /**
+         * Write the model to a model writer, as the value of a key (see Markov::writeTable)
+         */
+        void writeTable(ModelWriter &writer, const string &key) const;
+        
         /**
          * Get the length of the non-uniform Markov model
          *
@@ -19,6 +19,9 @@ namespace gmsuite {
     /**
      * @class NumAlphabetDNA
      * @brief A class that represents alphabet DNA in numeric form
+     *
+     * Membership and complement queries are answered from 256-entry tables indexed by element,
+     * since they are made for every element of a sequence when counting.
      */
     class NumAlphabetDNA {
         
@@ -109,11 +112,29 @@ namespace gmsuite {
         vector<element_t> alphValid;             /**< Characters that make up the valid alphabet (e.g. A, C, G, T) */
         vector<element_t> alphAmbiguous;         /**< Characters that make up the invalid alphabet (e.g. N, R, S, ...) */
         
-        map<element_t, element_t> complementDNA;      /**< complement nucleotides for DNA alphabet */
+        bool validElement[256];                  /**< whether an element is valid */
+        bool ambiguousElement[256];              /**< whether an element is ambiguous */
+        element_t complementDNA[256];            /**< complement nucleotides for DNA alphabet (identity for non-nucleotides) */
         
     };
     
     
+    // Check if character is valid (i.e. non-ambiguous)
+    inline bool NumAlphabetDNA::isValid(element_t c) const {
+        return validElement[c];
+    }
+    
+    // Check if character is ambiguous (i.e. N, R, S, ...)
+    inline bool NumAlphabetDNA::isAmbiguous(element_t c) const {
+        return ambiguousElement[c];
+    }
+    
+    // complement a character (characters without a complement are returned as they are)
+    inline NumAlphabetDNA::element_t NumAlphabetDNA::complement(element_t c) const {
+        return complementDNA[c];
+    }
+    
+    
 }
 
 #endif /* NumAlphabetDNA_hpp */
@@ -28,6 +28,10 @@ namespace gmsuite {
      * Numeric representation of DNA sequences allow for quick computations
      * e.g. in HMM
      *
+     * Elements are stored one byte each (see CharNumConverter::element_t), ambiguous
+     * letters included, so that a genome takes as much memory as its text, and the
+     * iterators remain plain random-access iterators over contiguous elements.
+     *
      * Note to Alex: For now, I'm keeping the variable numSeq as public. This variable contains
      * the actual numeric sequence. That said, you should initialize the variable using the constructor
      * that takes a Sequence and CharNumConverter (which is used for converting the characters to numbers).
@@ -40,9 +44,9 @@ namespace gmsuite {
         
     public:
         
-        typedef vector<int>::size_type size_type;                       // type for numeric sequence size
-        static const size_type npos = Sequence::npos;                   /**< Returned to indicate no matches */
         typedef CharNumConverter::element_t num_t;                      /**< define generic type for number @see CharNumConverter */
+        typedef vector<num_t>::size_type size_type;                     // type for numeric sequence size
+        static const size_type npos = Sequence::npos;                   /**< Returned to indicate no matches */
         
         /**
          * Default constructor: create an empty numeric sequence.
@@ -57,6 +61,16 @@ namespace gmsuite {
          */
         NumSequence(const Sequence &sequence, const CharNumConverter &converter);
         
+        /**
+         * Constructor: create a numeric sequence directly from sequence text (e.g. a record
+         * in a mapped file), skipping whitespace. No intermediate Sequence is created.
+         *
+         * @param begin the start of the text
+         * @param end the end of the text
+         * @param converter the object used to convert character sequences to numeric sequences
+         */
+        NumSequence(const char* begin, const char* end, const CharNumConverter &converter);
+        
         
         /**
          * Constructor: create a numeric sequence a vector of num_t elements. This simply
@@ -72,14 +86,14 @@ namespace gmsuite {
          *
          * @param idx the index of the element
          */
-        const int&  operator[](size_type idx) const;
+        const num_t& operator[](size_type idx) const;
         
         /**
          * Access an element from a numeric sequence
          *
          * @param idx the index of the element
          */
-        int& operator[](size_type idx);
+        num_t& operator[](size_type idx);
         
         /**
          * Get the size of the sequence (equivalent to sequence length()).
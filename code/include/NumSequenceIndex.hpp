@@ -0,0 +1,122 @@
+//
+//  NumSequenceIndex.hpp
+//  GeneMark Suite
+//
+
+#ifndef NumSequenceIndex_hpp
+#define NumSequenceIndex_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "NumSequence.hpp"
+#include "NumSequenceView.hpp"
+#include "NumAlphabetDNA.hpp"
+
+using std::vector;
+
+namespace gmsuite {
+    
+    /**
+     * @class NumSequenceIndex
+     * @brief Prefix counts of ambiguous and G/C elements over a sequence (e.g. a genome)
+     *
+     * The index is built once per sequence, in a single pass. It then answers, for any window,
+     * whether it contains ambiguous elements and how many of its elements are G or C, in O(1)
+     * and without reading the window.
+     *
+     * Each element is marked by a bit in a 64-bit word per block of 64 elements, and the number
+     * of marked elements before each block is kept; a count is then the block's prefix count
+     * plus the population count of part of one word. Since the complement of G/C is C/G, the GC
+     * counts hold for both strands.
+     *
+     * The index refers to the sequence it was built from, which must outlive it.
+     */
+    class NumSequenceIndex {
+        
+    public:
+        
+        typedef NumSequence::size_type size_type;
+        
+        /**
+         * Constructor: build the index over a sequence
+         *
+         * @param sequence the sequence
+         * @param alph the DNA alphabet of the sequence, used to identify ambiguous and G/C elements
+         */
+        NumSequenceIndex(const NumSequence &sequence, const NumAlphabetDNA &alph);
+        
+        size_type size() const { return length; }               /**< Length of the indexed sequence */
+        
+        /**
+         * Check whether this is the index of a sequence (i.e. it was built from that sequence, which has not changed length).
+         */
+        bool isIndexOf(const NumSequence &sequence) const { return this->sequence == &sequence && length == sequence.size(); }
+        
+        /**
+         * Count the ambiguous elements in a window.
+         *
+         * @param left the index of the window's first element
+         * @param length the number of elements in the window
+         * @throw out_of_range if the window goes past the end of the sequence
+         */
+        size_type numAmbiguous(size_type left, size_type length) const;
+        
+        /**
+         * Count the G and C elements in a window.
+         *
+         * @param left the index of the window's first element
+         * @param length the number of elements in the window
+         * @throw out_of_range if the window goes past the end of the sequence
+         */
+        size_type numGC(size_type left, size_type length) const;
+        
+        /**
+         * Check whether a window contains ambiguous elements.
+         *
+         * @param left the index of the window's first element
+         * @param length the number of elements in the window
+         * @throw out_of_range if the window goes past the end of the sequence
+         */
+        bool containsInvalid(size_type left, size_type length) const;
+        
+        /**
+         * Check whether a view contains ambiguous elements.
+         *
+         * @param view a view over the indexed sequence (on either strand)
+         * @throw invalid_argument if the view is over a different sequence
+         */
+        bool containsInvalid(const NumSequenceView &view) const;
+        
+        /**
+         * Get the GC content of a window, as a percentage; 0 for an empty window.
+         *
+         * @param left the index of the window's first element
+         * @param length the number of elements in the window
+         * @throw out_of_range if the window goes past the end of the sequence
+         */
+        double gc(size_type left, size_type length) const;
+        
+        
+    private:
+        
+        typedef unsigned long long block_t;
+        
+        const NumSequence *sequence;            /**< indexed sequence */
+        size_type length;                       /**< length of the indexed sequence */
+        
+        vector<block_t> ambiguousBits;          /**< bit per element, set if ambiguous; 64 elements per block */
+        vector<size_type> ambiguousBefore;      /**< number of ambiguous elements before each block */
+        vector<block_t> gcBits;                 /**< bit per element, set if G or C; 64 elements per block */
+        vector<size_type> gcBefore;             /**< number of G/C elements before each block */
+        
+        // number of marked elements before a position
+        static size_type rank(const vector<block_t> &bits, const vector<size_type> &before, size_type position);
+        
+        // check that a window lies in the sequence
+        void checkWindow(size_type left, size_type length) const;
+        
+    };
+}
+
+#endif /* NumSequenceIndex_hpp */
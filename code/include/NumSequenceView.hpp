@@ -0,0 +1,159 @@
+//
+//  NumSequenceView.hpp
+//  GeneMark Suite
+//
+
+#ifndef NumSequenceView_hpp
+#define NumSequenceView_hpp
+
+#include <stdio.h>
+#include <iterator>
+#include <cstddef>
+
+#include "NumSequence.hpp"
+#include "NumAlphabetDNA.hpp"
+#include "CharNumConverter.hpp"
+
+namespace gmsuite {
+
+    /**
+     * @class NumSequenceView
+     * @brief A read-only window over a numeric sequence, on either strand
+     *
+     * A view refers to 'length' elements of a sequence (e.g. a genome) starting at 'offset',
+     * without copying them. A view on the negative strand reads the window's reverse complement:
+     * its iterators walk the window backwards and complement each element as it is read, so
+     * no reverse-complemented copy is ever made.
+     *
+     * Views are meant for the many short regions (upstreams, start contexts) extracted from a
+     * genome; they are small enough to be copied by value. A view must not outlive the sequence
+     * and converter it was created from.
+     *
+     * @see NumSequence
+     * @see SequenceParser
+     */
+    class NumSequenceView {
+
+    public:
+
+        typedef NumSequence::size_type size_type;           /**< type for view size */
+        typedef NumSequence::num_t num_t;                   /**< type of an element */
+
+        /**
+         * @class const_iterator
+         * @brief Random-access iterator over the elements of a view, in reading order
+         *
+         * On the negative strand, the iterator holds the position after the element it reads
+         * (as std::reverse_iterator does), so that a view starting at the beginning of a
+         * sequence never points before it.
+         */
+        class const_iterator {
+
+        public:
+
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef num_t value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const num_t* pointer;
+            typedef num_t reference;                        // elements are complemented on read, so returned by value
+
+            const_iterator() : base(), reverse(false), cnc(NULL) { }
+            const_iterator(NumSequence::const_iterator base, bool reverse, const CharNumConverter *cnc) : base(base), reverse(reverse), cnc(cnc) { }
+
+            num_t operator*() const { return reverse ? cnc->complement(*(base-1)) : *base; }         /**< Read the current element */
+            num_t operator[](difference_type n) const { return *(*this + n); }                           /**< Read the element n positions ahead */
+
+            const_iterator& operator++() { reverse ? --base : ++base; return *this; }
+            const_iterator& operator--() { reverse ? ++base : --base; return *this; }
+            const_iterator operator++(int) { const_iterator old = *this; ++(*this); return old; }
+            const_iterator operator--(int) { const_iterator old = *this; --(*this); return old; }
+
+            const_iterator& operator+=(difference_type n) { base += (reverse ? -n : n); return *this; }
+            const_iterator& operator-=(difference_type n) { base -= (reverse ? -n : n); return *this; }
+            const_iterator operator+(difference_type n) const { const_iterator it = *this; return it += n; }
+            const_iterator operator-(difference_type n) const { const_iterator it = *this; return it -= n; }
+            difference_type operator-(const const_iterator &other) const { return reverse ? other.base - base : base - other.base; }
+
+            bool operator==(const const_iterator &other) const { return base == other.base; }
+            bool operator!=(const const_iterator &other) const { return base != other.base; }
+            bool operator<(const const_iterator &other) const { return (*this - other) < 0; }
+            bool operator>(const const_iterator &other) const { return other < *this; }
+            bool operator<=(const const_iterator &other) const { return !(other < *this); }
+            bool operator>=(const const_iterator &other) const { return !(*this < other); }
+
+        private:
+
+            NumSequence::const_iterator base;               /**< position of the element being read (or after it, on the negative strand) */
+            bool reverse;                                   /**< whether reading the reverse complement */
+            const CharNumConverter *cnc;                    /**< converter used to complement elements */
+        };
+
+        /**
+         * Default constructor: create an empty view.
+         */
+        NumSequenceView();
+
+        /**
+         * Constructor: create a view over part of a sequence.
+         *
+         * @param sequence the underlying sequence
+         * @param cnc the char-num converter holding the complement information of the sequence's alphabet
+         * @param offset the index of the window's first (leftmost) element in the sequence
+         * @param length the number of elements in the window
+         * @param reverseComplement if set, the view reads the window's reverse complement
+         *
+         * @exception std::invalid_argument if the window goes past the end of the sequence
+         */
+        NumSequenceView(const NumSequence &sequence, const CharNumConverter &cnc, size_type offset, size_type length, bool reverseComplement = false);
+
+        size_type size() const { return length; }                                   /**< Get the number of elements in the view */
+        bool isReverseComplement() const { return reverse; }                        /**< Whether the view reads the negative strand */
+        size_type getOffset() const { return offset; }                              /**< Get the index of the window's leftmost element in the sequence */
+        const NumSequence* getSequence() const { return sequence; }                 /**< Get the underlying sequence (NULL for an empty view) */
+
+        num_t operator[](size_type idx) const { return begin()[idx]; }              /**< Read an element, in reading order */
+
+        const_iterator begin() const;                                               /**< Start of iterator */
+        const_iterator end() const;                                                 /**< End of iterator */
+
+        /**
+         * Get the window's elements, as they lie in the underlying sequence (i.e. on the positive strand).
+         * Together with isReverseComplement(), these can be passed to the counting methods, which read
+         * the reverse complement themselves.
+         */
+        NumSequence::const_iterator sequenceBegin() const;
+        NumSequence::const_iterator sequenceEnd() const;                            /**< @see sequenceBegin */
+
+        /**
+         * Get a view of part of this view
+         *
+         * @param n the start index of the subview, in reading order (inclusive)
+         * @param length the length of the subview
+         *
+         * @exception std::invalid_argument thrown if n is larger than the view's
+         * length, or if n + length is larger than the view's length.
+         */
+        NumSequenceView subview(size_type n, size_type length) const;
+
+        /**
+         * Check whether the view contains ambiguous elements.
+         */
+        bool containsInvalid(const NumAlphabetDNA &alph) const;
+
+        /**
+         * Copy the view's elements, in reading order, into a new numeric sequence.
+         */
+        NumSequence toNumSequence() const;
+
+    private:
+
+        const NumSequence *sequence;            /**< underlying sequence */
+        const CharNumConverter *cnc;            /**< converter used to complement elements */
+        size_type offset;                       /**< index of the window's leftmost element in the sequence */
+        size_type length;                       /**< number of elements in the window */
+        bool reverse;                           /**< whether the view reads the reverse complement */
+    };
+
+}
+
+#endif /* NumSequenceView_hpp */
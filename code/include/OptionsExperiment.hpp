@@ -39,7 +39,8 @@ namespace gmsuite {
             START_MODEL_STRATEGY_2,
             PROMOTER_AND_RBS_MATCH,
             RBS_CONSENSUS_AND_16S_MATCH,
-            RBS_IS_LOCALIZED
+            RBS_IS_LOCALIZED,
+            VALIDATE_GROUPS
         }
         experiment_t;
         
@@ -225,6 +226,21 @@ namespace gmsuite {
         }
         rbsIsLocalized;
         
+        // validate-groups: run several group-validation checks on one mod file
+        struct ValidateGroups : public GenericOptions {
+            string fnmod;                                       // mod file shared by all checks
+            vector<string> checkNames;                          // names of the checks, in output order
+            vector<experiment_t> checks;                        // the checks (set from their names while parsing)
+            
+            PromoterIsValidForArchaea promoterIsValidForArchaea;
+            PromoterIsValidForBacteria promoterIsValidForBacteria;
+            RBSIsLocalized rbsIsLocalized;
+            MatchRBSTo16S matchRBSTo16S;
+            PromoterAndRBSMatch promoterAndRBSMatch;
+            RBSConsensusAnd16SMatch rbsConsensusAnd16SMatch;
+        }
+        validateGroups;
+        
         
         /**********************************************\
          *              Option Processing             *
@@ -235,17 +251,18 @@ namespace gmsuite {
         static void addProcessOptions_BuildStartModelsOptions(BuildStartModelsOptions &options, po::options_description &processOptions);
         static void addProcessOptions_BuildStartModels2Options(BuildStartModels2Options &options, po::options_description &processOptions);
         static void addProcessOptions_BuildStartModels3Options(BuildStartModels3Options &options, po::options_description &processOptions);
-        static void addProcessOptions_MatchRBSTo16SOptions(MatchRBSTo16S &options, po::options_description &processOptions);
+        static void addProcessOptions_MatchRBSTo16SOptions(MatchRBSTo16S &options, po::options_description &processOptions, string prefix = "");
         
         static void addProcessOptions_ScoreStarts(ScoreStarts &options, po::options_description &processOptions);
         static void addProcessOptions_ScoreLabeledStarts(ScoreLabeledStarts &options, po::options_description &processOptions);
-        static void addProcessOptions_PromoterIsValidForArchaea(PromoterIsValidForArchaea &options, po::options_description &processOptions);
-        static void addProcessOptions_PromoterIsValidForBacteria(PromoterIsValidForBacteria &options, po::options_description &processOptions);
+        static void addProcessOptions_PromoterIsValidForArchaea(PromoterIsValidForArchaea &options, po::options_description &processOptions, string prefix = "");
+        static void addProcessOptions_PromoterIsValidForBacteria(PromoterIsValidForBacteria &options, po::options_description &processOptions, string prefix = "");
         
         static void addProcessOptions_StartModelStrategy2Options(StartModelStrategy2Options &options, po::options_description &processOptions);
-        static void addProcessOptions_PromoterAndRBSMatchOptions(PromoterAndRBSMatch &options, po::options_description &processOptions);
-        static void addProcessOptions_RBSConsensusAnd16SMatch(RBSConsensusAnd16SMatch &options, po::options_description &processOptions);
-        static void addProcessOptions_RBSIsLocalized(RBSIsLocalized &options, po::options_description &processOptions);
+        static void addProcessOptions_PromoterAndRBSMatchOptions(PromoterAndRBSMatch &options, po::options_description &processOptions, string prefix = "");
+        static void addProcessOptions_RBSConsensusAnd16SMatch(RBSConsensusAnd16SMatch &options, po::options_description &processOptions, string prefix = "");
+        static void addProcessOptions_RBSIsLocalized(RBSIsLocalized &options, po::options_description &processOptions, string prefix = "");
+        static void addProcessOptions_ValidateGroups(ValidateGroups &options, po::options_description &processOptions);
         
         
     };
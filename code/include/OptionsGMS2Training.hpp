@@ -55,6 +55,7 @@ namespace gmsuite {
         string fn_labels;               /**< Input filename containing labels */
         string fn_outmod;               /**< Output model file */
         string fn_settings;             /**< Settings to place in output mod file */
+        unsigned numThreads;            /**< Number of threads used in training (counting and motif searches) */
         
         // prediction parameters
         double nonProbN;
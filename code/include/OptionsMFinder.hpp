@@ -58,6 +58,11 @@ namespace gmsuite {
         unsigned maxEMIter;             /**< Number of EM iterations per single try */
         unsigned shiftEvery;            /**< Number of iterations before attempting to shift the motif left and right */
         double filterThresh;            /**< Threshold used to filter unwanted */
+        unsigned numThreads;            /**< Number of threads on which restarts are run concurrently */
+        unsigned long long seed;        /**< Seed of the random number generator; the same seed gives the same results at any number of threads */
+        unsigned convergeAfter;         /**< Number of iterations without improvement after which the sampler moves on (0 to disable) */
+        double timeBudget;              /**< Wall-clock budget in seconds for a motif search, spread across restarts (0 for none) */
+        unsigned iterBudget;            /**< Iteration budget for a motif search, spread across restarts (0 for none) */
         
         
     };
@@ -39,7 +39,8 @@ namespace gmsuite {
             EXTRACT_SC_PER_OPERON_STATUS,
             EXTRACT_SC_PER_MOTIF_STATUS,
             COMPUTE_GC,
-            SEPARATE_FGIO_AND_IG
+            SEPARATE_FGIO_AND_IG,
+            CONVERT_MODEL
         }
         utility_t;
         
@@ -111,6 +112,7 @@ namespace gmsuite {
             string fn_mod;                  // input model file containing noncoding model
             string fn_out;                  // sequence output file
             NumSequence::size_type length;  // length of non-coding sequence
+            unsigned long long seed;        // seed of the random number generator
         } emitNonCoding;
         
         struct CountNumORF : public GenericOptions {
@@ -158,6 +160,12 @@ namespace gmsuite {
             size_t distThreshIG;            // distance threshold below which genes are declared IG
         } separateFGIOAndIG;
         
+        struct ConvertModel : public GenericOptions {
+            string fn_mod;                  // model filename (text or binary image)
+            string fn_out;                  // output filename
+            bool binary;                    // if set, output is written as a binary image; otherwise as text
+        } convertModel;
+        
         static void addProcessOptions_ExtractUpstream(ExtractUpstreamUtility &options, po::options_description &processOptions);
         static void addProcessOptions_StartModelInfo(StartModelInfoUtility &options, po::options_description &processOptions);
         static void addProcessOptions_LabelsSimilarityCheck(LabelsSimilarityCheck &options, po::options_description &processOptions);
@@ -167,6 +175,7 @@ namespace gmsuite {
         static void addProcessOptions_ExtractStartContextPerMotifStatus(ExtractStartContextPerMotifStatus &options, po::options_description &processOptions);
         static void addProcessOptions_ComputeGC(ComputeGC &options, po::options_description &processOptions);
         static void addProcessOptions_SeparateFGIOAndIG(SeparateFGIOAndIG &options, po::options_description &processOption);
+        static void addProcessOptions_ConvertModel(ConvertModel &options, po::options_description &processOptions);
     };
 }
 
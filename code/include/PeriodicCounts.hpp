@@ -68,6 +68,17 @@ namespace gmsuite {
          * Reset all counts to zero
          */
         void resetCounts();
+        
+        
+        /**
+         * Add the counts of another model with the same order and structure (e.g. counts
+         * of a different part of the genome)
+         *
+         * @param other the model whose counts are added
+         *
+         * @throw invalid_argument if the models' structures differ
+         */
+        void add(const PeriodicCounts &other);
 
         
     protected:
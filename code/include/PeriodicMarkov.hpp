@@ -75,6 +75,11 @@ namespace gmsuite {
          */
         string toString() const;
         
+        /**
+         * Write the model to a model writer, as the value of a key (see Markov::writeTable)
+         */
+        void writeTable(ModelWriter &writer, const string &key) const;
+        
         
     protected:
         
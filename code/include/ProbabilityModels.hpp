@@ -13,6 +13,7 @@
 
 #include "Sequence.hpp"
 #include "CountModels.hpp"
+#include "UnivariatePDF.hpp"
 
 namespace gmsuite {
     
@@ -35,7 +36,7 @@ namespace gmsuite {
          * @param sequences the sequences
          * @param positions the positions of motifs in these sequences
          */
-        virtual void construct(const vector<NumSequence> &sequences, const vector<NumSequence::size_type> &positions) = 0;
+        virtual void construct(const SequenceBatch &sequences, const vector<NumSequence::size_type> &positions) = 0;
         
         
         /**
@@ -46,6 +47,19 @@ namespace gmsuite {
         virtual void construct(const CountModels* counts) = 0;
         
         
+        /**
+         * Update probabilities after a single motif has been counted or decounted in the
+         * counts that were last passed to construct. Only the probabilities affected by that
+         * motif are recomputed.
+         *
+         * @param counts the (updated) counts
+         * @param sequences the sequences
+         * @param n the row of the sequence that was counted or decounted
+         * @param pos the position of the motif in the sequence
+         */
+        virtual void update(const CountModels* counts, const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos) = 0;
+        
+        
         /**
          * Compute conditional log-likelihood
          */
@@ -55,29 +69,33 @@ namespace gmsuite {
         /**
          * Compute the score for a given motif position
          *
-         * @param sequence the sequence
+         * @param sequences the sequences
+         * @param n the row of the sequence
          * @param pos the position of the motif in the sequence
          */
-        virtual double computePositionScore(const NumSequence &sequence, NumSequence::size_type pos) = 0;
+        virtual double computePositionScore(const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos) = 0;
         
         
         /**
          * Compute the scores for each valid motif position in the sequence
          *
-         * @param sequence the sequence
+         * @param sequences the sequences
+         * @param n the row of the sequence
          * @param scores the output scores of all valid positions in the sequence
          */
-        virtual void computePositionScores(const NumSequence &sequence, vector<double> &scores) = 0;
+        virtual void computePositionScores(const SequenceBatch &sequences, SequenceBatch::size_type n, vector<double> &scores) = 0;
         
         /**
          * Sample the position for motif in sequences
          *
-         * @param sequence the sequence
+         * @param sequences the sequences
+         * @param n the row of the sequence
+         * @param rng the random engine used for sampling
          * @param getMax if set, the position with the highest probability is returned; otherwise it is sampled.
          *
          * @return the position of a motif
          */
-        virtual NumSequence::size_type samplePosition(const NumSequence &sequence, bool getMax = false) = 0;
+        virtual NumSequence::size_type samplePosition(const SequenceBatch &sequences, SequenceBatch::size_type n, RandomGenerator &rng, bool getMax = false) = 0;
         
         /**
          * Get string representation of counting models
@@ -18,10 +18,13 @@
 #include "CountModels.hpp"
 #include "NonUniformCounts.hpp"
 #include "UnivariatePDF.hpp"
+#include "SlidingWindowScorer.hpp"
 //#include "Distribution.hpp"
 
 namespace gmsuite {
     
+    class CountModelsV1;
+    
     /**
      * @class ProbabilityModels
      * @brief A class to hold probabilities (used in MotifFinder)
@@ -57,7 +60,7 @@ namespace gmsuite {
          * @param sequences the sequences
          * @param positions the positions of motifs in these sequences
          */
-        void construct(const vector<NumSequence> &sequences, const vector<NumSequence::size_type> &positions);
+        void construct(const SequenceBatch &sequences, const vector<NumSequence::size_type> &positions);
         
         
         /**
@@ -69,7 +72,23 @@ namespace gmsuite {
         
         
         /**
-         * Compute conditional log-likelihood
+         * Update probabilities after a single motif has been counted or decounted in the
+         * counts that were last passed to construct. Only the motif rows, background words and
+         * position touched by that sequence are recomputed; the full Markov models are only
+         * rebuilt when next read by toString (scoring and computeCLL work from the tables).
+         *
+         * @param counts the (updated) counts
+         * @param sequences the sequences
+         * @param n the row of the sequence that was counted or decounted
+         * @param pos the position of the motif in the sequence
+         */
+        void update(const CountModels* counts, const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos);
+        
+        
+        /**
+         * Compute conditional log-likelihood. This works directly from the live scoring
+         * tables (whose background entries are the raised-order conditionals, updated only
+         * when background counts change), and allocates nothing.
          */
         double computeCLL();
         
@@ -77,34 +96,39 @@ namespace gmsuite {
         /**
          * Compute the score for a given motif position
          *
-         * @param sequence the sequence
+         * @param sequences the sequences
+         * @param n the row of the sequence
          * @param pos the position of the motif in the sequence
          */
-        double computePositionScore(const NumSequence &sequence, NumSequence::size_type pos);
+        double computePositionScore(const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos);
         
         
         /**
          * Compute the scores for each valid motif position in the sequence
          *
-         * @param sequence the sequence
+         * @param sequences the sequences
+         * @param n the row of the sequence
          * @param scores the output scores of all valid positions in the sequence
          */
-        void computePositionScores(const NumSequence &sequence, vector<double> &scores);
+        void computePositionScores(const SequenceBatch &sequences, SequenceBatch::size_type n, vector<double> &scores);
         
         
         /**
          * Sample the position for motif in sequences
          *
-         * @param sequence the sequence
+         * @param sequences the sequences
+         * @param n the row of the sequence
+         * @param rng the random engine used for sampling
          * @param getMax if set, the position with the highest probability is returned; otherwise it is sampled.
          *
          * @return the position of a motif
          */
-        NumSequence::size_type samplePosition(const NumSequence &sequence, bool getMax = false);
+        NumSequence::size_type samplePosition(const SequenceBatch &sequences, SequenceBatch::size_type n, RandomGenerator &rng, bool getMax = false);
         
         
         /**
-         * Get string representation of counting models
+         * Get string representation of counting models. Models outdated by incremental
+         * updates are rebuilt from the counts first.
          */
         string toString() const;
         
@@ -124,6 +148,82 @@ namespace gmsuite {
         UnivariatePDF *positionDistribution;     /**< position distribution; defined by alignment */
         vector<double> positionCounts;          /**< position counts; defined by alignment */
         
+        // Scoring tables: these hold the same probabilities as the models above, but are
+        // kept as log-odds that can be updated entry by entry (see update)
+        const CountModelsV1 *source;                /**< counts that the probabilities were derived from */
+        mutable bool modelsCurrent;                 /**< false if the models above are outdated by incremental updates (rebuilt when next read) */
+        int markovPcounts;                          /**< pseudocounts, as applied by the Markov models */
+        size_t elementEncodingSize;                 /**< number of bits needed to encode a single letter */
+        size_t wordMask;                            /**< mask capturing a word of motifOrder+1 letters */
+        size_t jointEnd;                            /**< motif position at which the background joint probability is scored */
+        SlidingWindowScorer *scorer;                /**< log-odds of motif against background, for each motif position */
+        size_t backWordTable;                       /**< scorer table of negated background log-counts */
+        size_t backContextTable;                    /**< scorer table of background log-denominators, per context */
+        size_t backJointTable;                      /**< scorer table of negated background log-joints (unnormalized) */
+        vector<vector<double> > motifLogCounts;     /**< log of motif word counts (with pseudocounts), for each motif position */
+        vector<double> backCounts;                  /**< background word counts */
+        vector<double> backDenominators;            /**< sum of background word counts (with pseudocounts), per context */
+        double backTotal;                           /**< sum of background word counts (with pseudocounts) */
+        vector<double> positionLogWeights;          /**< log of position counts (with pseudocounts) */
+        double positionTotal;                       /**< sum of position counts (with pseudocounts) */
+        vector<double> logCache;                    /**< natural log of whole numbers, up to the largest expected count */
+        vector<double> positionScoreBuffer;         /**< scratch buffer for position scores when sampling (not copied) */
+        
+        /**
+         * Build the motif, background and position models from counts
+         */
+        void constructModels(const CountModelsV1 *counts) const;
+        
+        /**
+         * Copy scoring tables from another instance
+         */
+        void copyTables(const ProbabilityModelsV1 &other);
+        
+        /**
+         * Build all scoring tables from counts
+         */
+        void constructTables(const CountModelsV1 *counts);
+        
+        /**
+         * Recompute the block of motif conditional probabilities containing a word
+         */
+        void updateMotifBlock(size_t position, size_t word);
+        
+        /**
+         * Copy the count of a background word, and recompute its entries
+         */
+        void updateBackgroundWord(size_t word);
+        
+        /**
+         * Copy the count of a motif position, and update the position normalizer
+         */
+        void updatePosition(size_t idx);
+        
+        /**
+         * Recompute the background joint entry that marginalizes over a background word
+         */
+        void updateBackgroundJoint(size_t word);
+        
+        /**
+         * Get the natural log of a count (cached for whole numbers)
+         */
+        double logCount(double value) const;
+        
+        /**
+         * Get the negated natural log of a count (-infinity for a zero count)
+         */
+        double negLogCount(double value) const;
+        
+        /**
+         * Get the position log-score (relative to a uniform distribution) of a motif position
+         */
+        double positionLogScore(const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos) const;
+        
+        /**
+         * Compute the log-scores for each valid motif position in the sequence
+         */
+        void computePositionLogScores(const SequenceBatch &sequences, SequenceBatch::size_type n, vector<double> &scores) const;
+        
         
     };
 }
@@ -0,0 +1,99 @@
+//
+//  RandomGenerator.hpp
+//  GeneMark Suite
+//
+
+#ifndef RandomGenerator_hpp
+#define RandomGenerator_hpp
+
+#include <stdio.h>
+#include <boost/cstdint.hpp>
+
+namespace gmsuite {
+
+    /**
+     * @class RandomGenerator
+     * @brief A seedable random number generator, with support for independent streams
+     *
+     * The generator implements xoshiro256**, a small and fast generator with a 256-bit
+     * state. Its state is filled from a 64-bit seed via splitmix64, so any seed (including
+     * zero) gives a valid generator.
+     *
+     * Independent streams are obtained through split(), which derives a new generator
+     * from this generator's seed and a stream index (e.g. a try or thread number). The
+     * derived generator does not depend on how many values were already drawn from this
+     * one, so the same seed always gives the same streams, regardless of the number of
+     * threads or the order in which they run.
+     *
+     * The class satisfies the requirements of a uniform random number generator, and can
+     * therefore be used with the boost (and standard) distributions.
+     */
+    class RandomGenerator {
+
+    public:
+
+        typedef boost::uint64_t result_type;
+
+        static const result_type DEFAULT_SEED = 0x5EED;         /**< seed used when none is provided */
+
+        /**
+         * Constructor: create a generator from a seed
+         *
+         * @param seed the seed
+         */
+        explicit RandomGenerator(result_type seed = DEFAULT_SEED);
+
+        /**
+         * Reset the generator to the start of a seed's sequence
+         *
+         * @param seed the seed
+         */
+        void seed(result_type seed);
+
+        /**
+         * Create an independent generator for a stream (e.g. a try or a thread)
+         *
+         * @param stream the index of the stream
+         * @return a generator seeded from this generator's seed and the stream index
+         */
+        RandomGenerator split(result_type stream) const;
+
+        /**
+         * Draw the next 64-bit value
+         */
+        result_type operator()() {
+            const result_type result = rotl(state[1] * 5, 7) * 9;
+            const result_type t = state[1] << 17;
+
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotl(state[3], 45);
+
+            return result;
+        }
+
+        double uniform() { return ((*this)() >> 11) * (1.0 / 9007199254740992.0); }     /**< Draw a uniform value in [0,1) */
+
+        result_type getSeed() const { return initialSeed; }                             /**< Get the seed of this generator */
+
+        static result_type min() { return 0; }                                          /**< Smallest value that can be drawn */
+        static result_type max() { return ~((result_type) 0); }                         /**< Largest value that can be drawn */
+
+    private:
+
+        result_type state[4];           /**< xoshiro256** state */
+        result_type initialSeed;        /**< the seed the state was filled from */
+
+        static result_type rotl(result_type x, int k) { return (x << k) | (x >> (64 - k)); }
+
+        /**
+         * Advance a splitmix64 state and return its next output
+         */
+        static result_type splitmix(result_type &x);
+    };
+}
+
+#endif /* RandomGenerator_hpp */
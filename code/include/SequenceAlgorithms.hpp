@@ -12,6 +12,8 @@
 #include <stdio.h>
 #include <vector>
 #include "NumSequence.hpp"
+#include "NumSequenceView.hpp"
+#include "NumSequenceIndex.hpp"
 #include "Label.hpp"
 
 namespace gmsuite {
@@ -29,9 +31,16 @@ namespace gmsuite {
                                             const std::vector<std::pair<NumSequence::num_t, NumSequence::num_t> >& subs = std::vector<std::pair<NumSequence::num_t, NumSequence::num_t> > ()
                                              );
         
+        static NumSequence longestMatchTo16S(const NumSequence &A, const NumSequenceView &B,
+                                            std::pair<NumSequence::size_type, NumSequence::size_type>& positionsOfMatches,
+                                            const std::vector<std::pair<NumSequence::num_t, NumSequence::num_t> >& subs = std::vector<std::pair<NumSequence::num_t, NumSequence::num_t> > ()
+                                             );
+        
         static double computeGC(const Sequence &seq);
         
         static  void computeGC(const Sequence &seq, const vector<Label*> &labels, vector<double> &gcs);
+        
+        static void computeGC(const NumSequenceIndex &index, const vector<Label*> &labels, vector<double> &gcs);
     };
     
     
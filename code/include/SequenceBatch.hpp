@@ -0,0 +1,123 @@
+//
+//  SequenceBatch.hpp
+//  GeneMark Suite
+//
+
+#ifndef SequenceBatch_hpp
+#define SequenceBatch_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "NumSequence.hpp"
+#include "NumSequenceView.hpp"
+#include "NumAlphabetDNA.hpp"
+
+using std::vector;
+
+namespace gmsuite {
+
+    /**
+     * @class SequenceBatch
+     * @brief A set of short numeric sequences (e.g. upstream regions), stored contiguously
+     *
+     * All sequences (rows) are stored in a single buffer, one every 'stride' elements, so that
+     * a search over many equal-length regions reads them back to back instead of from as many
+     * separate allocations. Rows may be shorter than the stride; each keeps its own length.
+     *
+     * Every row also has a validity flag. Invalid rows (e.g. regions with ambiguous letters)
+     * keep their place in the batch, so that row indices still match the labels they were
+     * extracted for, but are ignored by MotifFinder and the models it builds.
+     *
+     * Rows are read through NumSequence::const_iterator, so the counting and scoring code
+     * reads a row exactly as it would read a NumSequence.
+     */
+    class SequenceBatch {
+
+    public:
+
+        typedef NumSequence::size_type size_type;               /**< type for sizes and indices */
+        typedef NumSequence::num_t num_t;                       /**< type of an element */
+        typedef NumSequence::const_iterator const_iterator;     /**< iterator over the elements of a row */
+
+        /**
+         * Constructor: create an empty batch
+         *
+         * @param stride the maximum length of a row
+         */
+        explicit SequenceBatch(size_type stride = 0);
+
+        /**
+         * Constructor: create a batch holding copies of sequences, all valid. The stride is the
+         * length of the longest sequence.
+         */
+        SequenceBatch(const vector<NumSequence> &sequences);
+
+        /**
+         * Constructor: create a batch holding copies of sequence views (in their reading order),
+         * all valid. The stride is the length of the longest view.
+         */
+        SequenceBatch(const vector<NumSequenceView> &sequences);
+
+        /**
+         * Reserve space for a number of rows
+         */
+        void reserve(size_type numRows);
+
+        /**
+         * Append a copy of a sequence as a new row
+         *
+         * @param sequence the sequence
+         * @param valid whether the row is valid
+         *
+         * @exception invalid_argument if the sequence is longer than the stride
+         */
+        void push_back(const NumSequence &sequence, bool valid = true);
+
+        /**
+         * Append a copy of a sequence view (in its reading order) as a new row
+         *
+         * @param sequence the view
+         * @param valid whether the row is valid
+         *
+         * @exception invalid_argument if the view is longer than the stride
+         */
+        void push_back(const NumSequenceView &sequence, bool valid = true);
+
+        /**
+         * Mark all rows that contain ambiguous letters as invalid
+         *
+         * @param alph the alphabet defining ambiguous letters
+         */
+        void invalidateAmbiguous(const NumAlphabetDNA &alph);
+
+        size_type size() const { return lengths.size(); }                                   /**< Get the number of rows */
+        size_type stride() const { return rowStride; }                                      /**< Get the maximum length of a row */
+        size_type length(size_type n) const { return lengths[n]; }                          /**< Get the length of a row */
+        bool isValid(size_type n) const { return valid[n] != 0; }                           /**< Check whether a row is valid */
+        void setValid(size_type n, bool isValid) { valid[n] = isValid; }                    /**< Set whether a row is valid */
+
+        const_iterator begin(size_type n) const { return data.begin() + n * rowStride; }   /**< Start of a row */
+        const_iterator end(size_type n) const { return begin(n) + lengths[n]; }            /**< End of a row */
+
+        /**
+         * Get the number of valid rows
+         */
+        size_type numValid() const;
+
+        /**
+         * Copy a row into a new numeric sequence
+         */
+        NumSequence toNumSequence(size_type n) const;
+
+    private:
+
+        size_type rowStride;                    /**< number of elements reserved for every row */
+        vector<num_t> data;                     /**< all rows, one every rowStride elements */
+        vector<size_type> lengths;              /**< length of each row */
+        vector<char> valid;                     /**< validity of each row */
+    };
+
+}
+
+#endif /* SequenceBatch_hpp */
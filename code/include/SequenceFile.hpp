@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "Sequence.hpp"
+#include "NumSequence.hpp"
 
 #include <boost/iostreams/device/mapped_file.hpp>
 namespace io = boost::iostreams;
@@ -36,6 +37,25 @@ namespace gmsuite {
         typedef enum {READ, WRITE} access_t;                    /**< Read or write access to file */
         typedef enum {FASTA, PLAIN, AUTO} format_t;             /**< File format (defines how sequences are read/written) */
         
+        /**
+         * @struct record_t
+         * @brief A single record of a sequence file, as spans of the mapped file
+         *
+         * Nothing is copied: the spans point into the mapped file, and remain valid for as
+         * long as the SequenceFile is open. The sequence span is the raw text of the sequence,
+         * and may contain line breaks. For PLAIN files, a record is a line, and has an empty
+         * definition.
+         */
+        struct record_t {
+            const char* defBegin;               /**< start of the definition (after '>') */
+            const char* defEnd;                 /**< end of the definition */
+            const char* seqBegin;               /**< start of the sequence text */
+            const char* seqEnd;                 /**< end of the sequence text */
+            
+            string definition() const { return string(defBegin, defEnd); }        /**< Copy the definition */
+            string identifier() const;                                              /**< Copy the first word of the definition */
+        };
+        
         /**
          * Constructor: Create a sequence file at a given path, with read/write access,
          * and using a specific format.
@@ -84,6 +104,43 @@ namespace gmsuite {
          */
         Sequence read() const;
         
+        /**
+         * Read single sequence from file, and convert it straight to its numeric form. Only
+         * the first record is parsed (see read()), and the numeric sequence is the only copy
+         * made of it.
+         *
+         * @param cnc the converter used to convert characters to elements
+         *
+         * @exception out_of_range if a character is not in the converter's alphabet
+         */
+        NumSequence read(const CharNumConverter &cnc) const;
+        
+        /**
+         * Read all sequences (e.g. contigs) from file, converting each straight to its numeric
+         * form. Only one copy of the sequences is made.
+         *
+         * @param output the numeric sequences
+         * @param identifiers the identifier (first word of the definition) of each sequence
+         * @param cnc the converter used to convert characters to elements
+         *
+         * @exception out_of_range if a character is not in the converter's alphabet
+         */
+        void read(vector<NumSequence> &output, vector<string> &identifiers, const CharNumConverter &cnc) const;
+        
+        /**
+         * Start of the records in the file, to be passed to readNextRecord.
+         */
+        const char* beginRecords() const { return begin_read; }
+        
+        /**
+         * Read the next record from the file, without copying it.
+         *
+         * @param current the position in the file; it is moved past the record that was read
+         * @param record the output record
+         * @return false if no records remain; true otherwise
+         */
+        bool readNextRecord(const char* &current, record_t &record) const;
+        
         
         /**
          * Write sequences to file. This behaves differently for separate
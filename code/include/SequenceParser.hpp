@@ -13,6 +13,7 @@
 
 #include "Label.hpp"
 #include "NumSequence.hpp"
+#include "NumSequenceView.hpp"
 #include "CharNumConverter.hpp"
 
 
@@ -24,10 +25,29 @@ namespace gmsuite {
         
         static NumSequence extractUpstreamSequence(const NumSequence& sequence, const Label &label, const CharNumConverter &cnc, NumSequence::size_type upstrLength);
         
+        /**
+         * Get a view of the upstream region of a label, on the label's strand (i.e. reverse
+         * complemented for labels on the negative strand). Nothing is copied.
+         *
+         * @exception out_of_range if the sequence doesn't have upstrLength elements upstream of the label
+         */
+        static NumSequenceView extractUpstreamView(const NumSequence& sequence, const Label &label, const CharNumConverter &cnc, NumSequence::size_type upstrLength);
+        
         static void extractUpstreamSequences(const NumSequence& sequence, const vector<Label*> &labels, const CharNumConverter &cnc, NumSequence::size_type upstrLength, vector<NumSequence> &upstreams, bool allowOverlapWithCDS = false, size_t minimumGeneLength=0, const vector<bool> &use = vector<bool>());
         
+        /**
+         * Extract the upstream regions of labels as views over the sequence, without copying them.
+         * Labels are skipped as in the version that copies the regions.
+         */
+        static void extractUpstreamSequences(const NumSequence& sequence, const vector<Label*> &labels, const CharNumConverter &cnc, NumSequence::size_type upstrLength, vector<NumSequenceView> &upstreams, bool allowOverlapWithCDS = false, size_t minimumGeneLength=0, const vector<bool> &use = vector<bool>());
+        
         static void extractStartContextSequences(const NumSequence& sequence, const vector<Label*> &labels, const CharNumConverter &cnc, long long posRelToStart, NumSequence::size_type length, vector<NumSequence> &contexts, const vector<bool> &use = vector<bool>());
         
+        /**
+         * Extract the start contexts of labels as views over the sequence, without copying them.
+         */
+        static void extractStartContextSequences(const NumSequence& sequence, const vector<Label*> &labels, const CharNumConverter &cnc, long long posRelToStart, NumSequence::size_type length, vector<NumSequenceView> &contexts, const vector<bool> &use = vector<bool>());
+        
         static NumSequence extractStartContextSequence(const NumSequence& sequence, const Label &labels, const CharNumConverter &cnc, long long posRelToStart, NumSequence::size_type length, const vector<bool> &use = vector<bool>());
         
     };
@@ -0,0 +1,148 @@
+//
+//  SlidingWindowScorer.hpp
+//  GeneMark Suite
+//
+
+#ifndef SlidingWindowScorer_hpp
+#define SlidingWindowScorer_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "NumSequence.hpp"
+#include "NumAlphabetDNA.hpp"
+
+using std::vector;
+
+namespace gmsuite {
+
+    /**
+     * @class SlidingWindowScorer
+     * @brief Scores all windows of a sequence from tables of position-specific log-scores
+     *
+     * Every position p of a window of length 'width' has its own table, holding a log-score
+     * for each word ending at p. Words are made up of min(p, order)+1 letters, and are
+     * indexed the same way as in the Markov models (i.e. 2 bits per letter for DNA).
+     * In addition, positions may be attached to shared tables, whose entries are added to
+     * those of the position's own table. A shared table holds words of a fixed length, and
+     * is looked up with the first letters of a position's word (e.g. a table of 2-letter
+     * words attached to a position with 3-letter words is looked up with its first 2 letters).
+     * Shared tables allow terms that do not depend on the position (e.g. a background model)
+     * to be updated once for all positions.
+     *
+     * The score of a window is the sum of the table entries of its words, plus a constant
+     * offset. To score all windows of a sequence, each word index is built once (by rolling
+     * the previous index in a single pass over the sequence), and the tables are then added
+     * to all windows one position at a time. The word indexes are kept in a buffer that is
+     * reused across calls, so a scorer must not score sequences on several threads at once.
+     */
+    class SlidingWindowScorer {
+
+    public:
+
+        /**
+         * Constructor: create a scorer with all table entries set to zero, and no shared tables
+         *
+         * @param width the window width
+         * @param order the number of preceding letters that a word's score depends on
+         * @param alph the alphabet of the scored sequences
+         */
+        SlidingWindowScorer(size_t width, unsigned order, const NumAlphabetDNA &alph);
+
+        void set(size_t position, size_t word, double value) { table[position][word] = value; }     /**< Set the log-score of a word at a window position */
+        double get(size_t position, size_t word) const { return table[position][word]; }            /**< Get the log-score of a word at a window position (excluding shared tables) */
+        size_t numWords(size_t position) const { return table[position].size(); }                   /**< Get the number of words at a window position */
+
+        /**
+         * Add a shared table with all entries set to zero
+         *
+         * @param wordLength the number of letters in the words of the table
+         * @return the index of the new table
+         */
+        size_t addSharedTable(size_t wordLength);
+
+        /**
+         * Attach a shared table to a window position. A position can have several shared tables.
+         *
+         * @param position the position in the window
+         * @param table the index of the shared table
+         *
+         * @exception invalid_argument if the table's words are longer than words at that position
+         */
+        void attachSharedTable(size_t position, size_t table);
+
+        void setShared(size_t table, size_t word, double value) { shared[table][word] = value; }     /**< Set the log-score of a word in a shared table */
+        double getShared(size_t table, size_t word) const { return shared[table][word]; }            /**< Get the log-score of a word in a shared table */
+
+        /**
+         * Set the constant log-score added to every window
+         */
+        void setOffset(double offset);
+
+        /**
+         * Compute the log-score of a single window
+         *
+         * @param sequence the sequence
+         * @param pos the start of the window in the sequence
+         * @return the log-score of the window
+         */
+        double score(const NumSequence &sequence, NumSequence::size_type pos) const;
+        
+        /**
+         * Compute the log-score of a single window
+         *
+         * @param window the first element of the window
+         * @return the log-score of the window
+         */
+        double score(NumSequence::const_iterator window) const;
+
+        /**
+         * Compute the log-scores of all windows in a sequence
+         *
+         * @param sequence the sequence
+         * @param scores the output log-scores, one for every valid window start
+         *
+         * @exception invalid_argument if the sequence is shorter than the window
+         */
+        void scoreAll(const NumSequence &sequence, vector<double> &scores) const;
+        
+        /**
+         * Compute the log-scores of all windows in a sequence, given by its elements (e.g. a row
+         * of a SequenceBatch)
+         *
+         * @param begin the first element of the sequence
+         * @param length the length of the sequence
+         * @param scores the output log-scores, one for every valid window start
+         *
+         * @exception invalid_argument if the sequence is shorter than the window
+         */
+        void scoreAll(NumSequence::const_iterator begin, NumSequence::size_type length, vector<double> &scores) const;
+        
+        /**
+         * Compute the total log-score of a set of windows, from the number of times each word
+         * occurs at each window position (e.g. the counts of a motif alignment). Words with a
+         * zero count, or an infinite log-score, do not contribute.
+         *
+         * @param counts the count of each word, for every window position (indexed as the tables)
+         * @return the sum of the log-scores of all windows
+         */
+        double scoreCounts(const vector<vector<double> > &counts) const;
+
+    private:
+
+        size_t width;                           /**< window width */
+        unsigned order;                         /**< number of preceding letters in a word */
+        size_t elementEncodingSize;             /**< number of bits needed to encode a single letter */
+        size_t wordMask;                        /**< mask capturing a word of order+1 letters */
+        vector<size_t> masks;                   /**< mask capturing the word at each window position */
+        vector<vector<double> > table;          /**< log-score of each word, for every window position */
+        vector<vector<double> > shared;         /**< shared tables */
+        vector<size_t> sharedLength;            /**< number of letters in the words of each shared table */
+        vector<vector<size_t> > sharedOf;       /**< indices of shared tables attached to each window position */
+        vector<vector<size_t> > sharedShift;    /**< shift that reduces a position's word to the word of each attached table */
+        double offset;                          /**< log-score added to every window */
+        mutable vector<size_t> wordBuffer;      /**< scratch buffer for the word ending at every letter, when scoring all windows */
+    };
+}
+
+#endif /* SlidingWindowScorer_hpp */
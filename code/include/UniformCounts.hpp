@@ -21,6 +21,7 @@ namespace gmsuite {
     class UniformCounts : public Counts {
         
         friend class UniformMarkov;
+        friend class ProbabilityModelsV1;
        
     public:
         
@@ -53,6 +54,17 @@ namespace gmsuite {
          * Reset all counts to zero
          */
         virtual void resetCounts();
+        
+        
+        /**
+         * Add the counts of another model with the same order and structure (e.g. counts
+         * of a different part of the genome)
+         *
+         * @param other the model whose counts are added
+         *
+         * @throw invalid_argument if the models' structures differ
+         */
+        void add(const UniformCounts &other);
 
     
     protected:
@@ -11,6 +11,7 @@
 
 #include <stdio.h>
 #include "Markov.hpp"
+#include "RandomGenerator.hpp"
 
 namespace gmsuite {
     
@@ -72,6 +73,11 @@ namespace gmsuite {
          */
         string toString() const;
         
+        /**
+         * Write the model to a model writer, as the value of a key (see Markov::writeTable)
+         */
+        void writeTable(ModelWriter &writer, const string &key) const;
+        
         
         /**
          * Change the model's order. Note: changing to a lower order model will
@@ -88,8 +94,9 @@ namespace gmsuite {
          * Emit a sequence from the markov model
          *
          * @param length the length of the sequence
+         * @param rng the random number generator from which letters are drawn
          */
-        NumSequence emit(NumSequence::size_type length) const;
+        NumSequence emit(NumSequence::size_type length, RandomGenerator &rng) const;
         
         
     protected:
@@ -13,6 +13,8 @@
 #include <vector>
 #include <string>
 
+#include "RandomGenerator.hpp"
+
 using std::string;
 using std::vector;
 
@@ -22,7 +24,11 @@ namespace gmsuite {
      * @class UnivariatePDF
      * @brief This class implements a linear distribution
      *
-     * Operations such as sample and sample-in-log-space allow simple usage
+     * Operations such as sample and sample-in-log-space allow simple usage.
+     *
+     * Sampling uses a binary search over the cumulative distribution. For one-off draws
+     * (e.g. in the Gibbs loop), sampleFromLogWeights samples directly from a buffer of
+     * unnormalized log-weights, without constructing a distribution.
      */
     class UnivariatePDF {
         
@@ -41,7 +47,9 @@ namespace gmsuite {
          *
          * @param weights the set of weights
          * @param lnspace if set, then the weights are converted from natural logspace back
-         * into linear space, before the normalization is created.
+         * into linear space, before the normalization is created. When normalizing, the
+         * weights are shifted by their maximum first (log-sum-exp), so large log-values
+         * do not overflow.
          * @param normalize whether the weights should be normalized to sum to one
          */
         UnivariatePDF(const vector<double> &weights, bool lnspace=false, double pcounts=0, bool normalize=true);
@@ -53,16 +61,34 @@ namespace gmsuite {
          *
          * @param weights the set of weights
          * @param lnspace if set, then the weights are converted from natural logspace back
-         * into linear space, before the normalization is created.
+         * into linear space, before the normalization is created. When normalizing, the
+         * weights are shifted by their maximum first (log-sum-exp), so large log-values
+         * do not overflow.
          * @param normalize whether the weights should be normalized to sum to one
          */
         void construct(const vector<double> &weights, bool lnspace=false, double pcounts=0, bool normalize=true);
         
         
         /**
-         * Sample a value from this distribution
+         * Sample a value from this distribution. The uniform variate is drawn from the
+         * given generator, so that independent (e.g. per-thread) streams can be used.
+         *
+         * @param rng the random number generator
+         */
+        size_t sample(RandomGenerator &rng) const;
+        
+        /**
+         * Sample an index from a buffer of unnormalized natural-log weights, without
+         * constructing a distribution. The weights are shifted by their maximum before
+         * being exponentiated, so large log-values do not overflow. The buffer is
+         * overwritten with the cumulative (shifted) linear weights.
+         *
+         * @param logWeights the log-weights; on return, cumulative sums of their shifted exponentials
+         * @param rng the random number generator
+         *
+         * @exception domain_error if the buffer is empty
          */
-        size_t sample() const;
+        static size_t sampleFromLogWeights(vector<double> &logWeights, RandomGenerator &rng);
         
         
         const double& operator[] (size_t pos) const;
@@ -91,8 +117,10 @@ namespace gmsuite {
         
         /**
          * Convert values from log-space to linear space
+         *
+         * @param shift if set, values are shifted by their maximum first (only valid if normalized afterwards)
          */
-        void convertFromLinearToLogspace();
+        void convertFromLinearToLogspace(bool shift);
         
         /**
          * Compute the cumulative distribution for easy sampling
@@ -104,6 +132,17 @@ namespace gmsuite {
          */
         void normalize();
         
+        /**
+         * Select the sample corresponding to a uniform value in [0,1]
+         */
+        size_t sampleFromUniform(double u) const;
+        
+        /**
+         * Select the index of a cumulative buffer corresponding to a uniform value in [0,1],
+         * via binary search
+         */
+        static size_t sampleFromCumulative(const vector<double> &cumulative, double u);
+        
     };
 }
 
@@ -10,11 +10,15 @@
 
 #include <stdexcept>
 #include <iterator>     // std::distance
+#include <algorithm>    // std::fill
+#include <cctype>       // isspace
 
 
 using namespace gmsuite;
 using std::invalid_argument;
 
+const CharNumConverter::element_t CharNumConverter::NO_ELEMENT;
+
 // Constructor: create a converter using the given alphabet
 CharNumConverter::CharNumConverter(const AlphabetDNA* alphabet) {
     
@@ -22,23 +26,34 @@ CharNumConverter::CharNumConverter(const AlphabetDNA* alphabet) {
         throw invalid_argument("Alphabet cannot be NULL");
     }
     
+    if (alphabet->size() >= NO_ELEMENT) {
+        throw invalid_argument("Alphabet is too large for one-byte elements");
+    }
+    
     this->alphabet = alphabet;
     
+    // mark all table entries as empty
+    std::fill(charToNum, charToNum + 256, NO_ELEMENT);
+    std::fill(numToChar, numToChar + 256, '\0');
+    std::fill(complementDNA, complementDNA + 256, NO_ELEMENT);
+    
     // create converters
     element_t current = 0;
     
     // iterate over each character in the alphabet
     for (AlphabetDNA::const_iterator iter = this->alphabet->begin(); iter != this->alphabet->end(); iter++) {
-        this->charToNum[*iter] = current;           // char to number
-        this->numToChar[current] = *iter;           // number to char
+        this->charToNum[(unsigned char) *iter] = current;       // char to number
+        this->numToChar[current] = *iter;                       // number to char
         
         current++;
     }
     
-    // create complement map
+    numElements = current;
+    
+    // create complement table
     for (AlphabetDNA::const_iterator iter = this->alphabet->begin(); iter != this->alphabet->end(); iter++) {
-        element_t from = charToNum[*iter];
-        element_t to = charToNum[this->alphabet->complement(*iter)];
+        element_t from = charToNum[(unsigned char) *iter];
+        element_t to = charToNum[(unsigned char) this->alphabet->complement(*iter)];
         
         complementDNA[from] = to;
     }
@@ -48,32 +63,66 @@ CharNumConverter::CharNumConverter(const AlphabetDNA* alphabet) {
 
 // Convert a string sequence to its numeric representation.
 void CharNumConverter::convert(const string &str, seq_t &result) const {
-    
-    result.resize(str.length());        // allocate space for result
-    
-    for (string::size_type i = 0; i < str.size(); i++) {
-        result[i] = charToNum.at(str[i]);       // convert each character to number
-    }
+    convert(str.begin(), str.end(), result);
 }
 
 
+// Convert a Sequence to its numeric representation. The loop has no branches: characters
+// outside the alphabet are looked up as NO_ELEMENT, and reported after the whole sequence is converted.
 void CharNumConverter::convert(Sequence::const_iterator begin, Sequence::const_iterator end, seq_t &result) const {
     
-    Sequence::const_iterator current = begin;
     size_t seqLength = std::distance(begin, end);           // get sequence length
+    result.resize(seqLength);                               // allocate space for result
+    
+    if (seqLength == 0)
+        return;
     
-    result.resize(seqLength);        // allocate space for result
+    const char *in = &(*begin);
+    element_t *out = &result[0];
     
-    for (string::size_type i = 0; i < seqLength; i++) {
-        result[i] = charToNum.at(*current);          // convert each character to number
-        current++;                                  // next character
+    bool allFound = true;
+    for (size_t i = 0; i < seqLength; i++) {
+        element_t element = charToNum[(unsigned char) in[i]];     // convert each character to number
+        out[i] = element;
+        allFound &= (element != NO_ELEMENT);
     }
+    
+    if (!allFound)
+        throw std::out_of_range("Character is not in the converter's alphabet.");
+}
+
+
+// Convert sequence text to its numeric representation, skipping whitespace. The output is
+// sized for the whole text and trimmed once, so that it is filled in a single pass.
+void CharNumConverter::convertText(const char* begin, const char* end, seq_t &result) const {
+    
+    result.resize(end - begin);             // upper bound: every character is an element
+    
+    size_t length = 0;
+    bool allFound = true;
+    for (const char* current = begin; current != end; current++) {
+        if (isspace(*current))
+            continue;
+        
+        element_t element = charToNum[(unsigned char) *current];
+        result[length++] = element;
+        allFound &= (element != NO_ELEMENT);
+    }
+    
+    result.resize(length);
+    
+    if (!allFound)
+        throw std::out_of_range("Character is not in the converter's alphabet.");
 }
 
 
 // Convert a single character to its numeric representation.
 CharNumConverter::element_t CharNumConverter::convert(char c) const {
-    return charToNum.at(c);
+    element_t element = charToNum[(unsigned char) c];
+    if (element == NO_ELEMENT)
+        throw std::out_of_range("Character is not in the converter's alphabet.");
+    
+    return element;
 }
 
 
@@ -87,7 +136,7 @@ string CharNumConverter::convert(seq_t::const_iterator start, seq_t::const_itera
     
     // iterate from start to end
     for (seq_t::const_iterator curr = start; curr != end; curr++) {
-        result[l++] = numToChar.at(*curr);
+        result[l++] = convert(*curr);
     }
     
     return result;
@@ -97,37 +146,46 @@ string CharNumConverter::convert(seq_t::const_iterator start, seq_t::const_itera
 
 // Convert a numeric element back to a character.
 char CharNumConverter::convert(element_t element) const {
-    return numToChar.at(element);
+    if (element >= numElements)
+        throw std::out_of_range("Element is not in the converter's alphabet.");
+    
+    return numToChar[element];
 }
 
 
 
 // Complement DNA sequence
 void CharNumConverter::complement(const seq_t &original, seq_t &result) const {
-    result.resize(original.size());
-    
-    for (size_t n = 0; n < original.size(); n++) {
-        result[n] = complementDNA.at(original[original.size() - n - 1]);
-    }
-}
-
-CharNumConverter::element_t CharNumConverter::complement(element_t original) const {
-    return complementDNA.at(original);
+    result = original;
+    reverseComplement(result.begin(), result.end());
 }
 
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+// Reverse complement in place: swap symmetric elements from both ends, complementing each
+void CharNumConverter::reverseComplement(seq_t::iterator begin, seq_t::iterator end) const {
+    
+    size_t length = std::distance(begin, end);
+    if (length == 0)
+        return;
+    
+    element_t *left = &(*begin);
+    element_t *right = left + length - 1;
+    
+    bool allFound = true;
+    for ( ; left < right; left++, right--) {
+        element_t temp = complementDNA[*left];
+        *left = complementDNA[*right];
+        *right = temp;
+        
+        allFound &= (*left != NO_ELEMENT) & (temp != NO_ELEMENT);
+    }
+    
+    // if length is odd, complement the middle element
+    if (left == right) {
+        *left = complementDNA[*left];
+        allFound &= (*left != NO_ELEMENT);
+    }
+    
+    if (!allFound)
+        throw std::out_of_range("Element is not in the converter's alphabet.");
+}
@@ -8,6 +8,7 @@
 
 #include "CountModelsV1.hpp"
 #include <stdexcept>
+#include <algorithm>
 using namespace gmsuite;
 
 // constructor
@@ -74,7 +75,7 @@ CountModelsV1::~CountModelsV1() {
  * @param sequences the sequences
  * @param positions the positions of motifs in these sequences
  */
-void CountModelsV1::construct(const vector<NumSequence> &sequences, const vector<NumSequence::size_type> &positions) {
+void CountModelsV1::construct(const SequenceBatch &sequences, const vector<NumSequence::size_type> &positions) {
     
     mMotif->resetCounts();
     mBack->resetCounts();
@@ -82,40 +83,49 @@ void CountModelsV1::construct(const vector<NumSequence> &sequences, const vector
     if (align != MFinderModelParams::NONE) {
         // get maximum motif position
         Sequence::size_type maxSequenceSize = 0;
-        for (vector<NumSequence>::size_type n = 0; n < sequences.size(); n++) {
-            if (sequences[n].size() > maxSequenceSize) {
-                maxSequenceSize = sequences[n].size();
+        for (SequenceBatch::size_type n = 0; n < sequences.size(); n++) {
+            if (sequences.isValid(n) && sequences.length(n) > maxSequenceSize) {
+                maxSequenceSize = sequences.length(n);
             }
         }
         
         // allocate space for position counts
-        positionCounts.resize(maxSequenceSize-width+1, 0);
+        positionCounts.assign(maxSequenceSize-width+1, 0);
     }
     
     
-    // add all sequences to counts
-    for (vector<NumSequence>::size_type n = 0; n < sequences.size(); n++) {
-        count(sequences[n], positions[n]);
+    // background starts with all words of all sequences; counting motifs removes their words
+    for (SequenceBatch::size_type n = 0; n < sequences.size(); n++) {
+        if (sequences.isValid(n))
+            mBack->count(sequences.begin(n), sequences.end(n));
+    }
+    
+    // add all motifs to counts
+    for (SequenceBatch::size_type n = 0; n < sequences.size(); n++) {
+        if (sequences.isValid(n))
+            count(sequences, n, positions[n]);
     }
     
 }
 
 
 // Decount a motif
-void CountModelsV1::decount(const NumSequence &sequence, NumSequence::size_type pos) {
+void CountModelsV1::decount(const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos) {
     
     // if 'out of range'
     if (pos == NumSequence::npos)
         return;
     
+    SequenceBatch::const_iterator sequence = sequences.begin(n);
+    NumSequence::size_type length = sequences.length(n);
+    
     // decount motif model
-    mMotif->decount(sequence.begin() + pos, sequence.begin() + pos + width);
+    mMotif->decount(sequence + pos, sequence + pos + width);
     
-    // decount background model
-    if (pos > 0)
-        mBack->decount(sequence.begin(), sequence.begin() + pos);
-    if (pos < sequence.size() - width)
-        mBack->decount(sequence.begin()+pos+width, sequence.end());
+    // return words overlapping the motif to the background model
+    NumSequence::size_type begin, end;
+    backgroundRegion(length, pos, begin, end);
+    mBack->count(sequence + begin, sequence + end);
     
     // decount position
     if (align != MFinderModelParams::NONE) {
@@ -128,10 +138,10 @@ void CountModelsV1::decount(const NumSequence &sequence, NumSequence::size_type
         }
         // for right aligned
         else if (align == MFinderModelParams::RIGHT) {
-            if (positionCounts[sequence.size() - width - pos] == 0)
+            if (positionCounts[length - width - pos] == 0)
                 throw std::invalid_argument("Cannot decount position for sequence.");
             
-            positionCounts[sequence.size() - width - pos]--;  // increment position from right
+            positionCounts[length - width - pos]--;         // increment position from right
         }
     }
     
@@ -142,25 +152,28 @@ void CountModelsV1::decount(const NumSequence &sequence, NumSequence::size_type
 /**
  * Count a motif
  *
- * @param sequence the sequence to count
+ * @param sequences the sequences
+ * @param n the row of the sequence to count
  * @param pos the position of the motif in the sequence
  *
  * @exception invalid_argument if pos is not a valid motif location in the sequence
  */
-void CountModelsV1::count(const NumSequence &sequence, NumSequence::size_type pos) {
+void CountModelsV1::count(const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos) {
     
     // if 'out-of-range'
     if (pos == NumSequence::npos)
         return;
     
+    SequenceBatch::const_iterator sequence = sequences.begin(n);
+    NumSequence::size_type length = sequences.length(n);
+    
     // count motif model
-    mMotif->count(sequence.begin() + pos, sequence.begin() + pos + width);
+    mMotif->count(sequence + pos, sequence + pos + width);
     
-    // count background model
-    if (pos > 0)
-        mBack->count(sequence.begin(), sequence.begin() + pos);
-    if (pos < sequence.size() - width)
-        mBack->count(sequence.begin()+pos+width, sequence.end());
+    // remove words overlapping the motif from the background model
+    NumSequence::size_type begin, end;
+    backgroundRegion(length, pos, begin, end);
+    mBack->decount(sequence + begin, sequence + end);
     
     // count position
     if (align != MFinderModelParams::NONE) {
@@ -170,12 +183,22 @@ void CountModelsV1::count(const NumSequence &sequence, NumSequence::size_type po
         }
         // for right aligned
         else if (align == MFinderModelParams::RIGHT) {
-            positionCounts[sequence.size() - width - pos]++;  // increment position from right
+            positionCounts[length - width - pos]++;         // increment position from right
         }
     }
 }
 
 
+// Get the region of a sequence whose background words overlap a motif window
+void CountModelsV1::backgroundRegion(NumSequence::size_type length, NumSequence::size_type pos, NumSequence::size_type &begin, NumSequence::size_type &end) const {
+    
+    // a background word has motifOrder+1 letters, so it overlaps the window if it
+    // starts at most motifOrder letters before it, or ends at most motifOrder letters after it
+    begin = (pos > motifOrder ? pos - motifOrder : 0);
+    end = std::min(pos + width + motifOrder, length);
+}
+
+
 /**
  * Get string representation of counting models
  */
@@ -38,3 +38,15 @@ void Counts::count(NumSequence::const_iterator begin, NumSequence::const_iterato
 void Counts::decount(NumSequence::const_iterator begin, NumSequence::const_iterator end, bool reverseComplement) {
     updateCounts(begin, end, "decrement", reverseComplement);
 }
+
+
+// Count a sequence view.
+void Counts::count(const NumSequenceView &view) {
+    count(view.sequenceBegin(), view.sequenceEnd(), view.isReverseComplement());
+}
+
+
+// Decount a sequence view.
+void Counts::decount(const NumSequenceView &view) {
+    decount(view.sequenceBegin(), view.sequenceEnd(), view.isReverseComplement());
+}
@@ -15,12 +15,21 @@
 #include "CodingMarkov.hpp"
 #include "NonUniformCounts.hpp"
 #include "LabelsParser.hpp"
+#include "LabelIndex.hpp"
+#include "NumSequenceIndex.hpp"
 #include "NonCodingCounts.hpp"
 #include "SequenceParser.hpp"
 #include "CodingCounts.hpp"
 #include <boost/lexical_cast.hpp>
 #include "OptionsGMS2Training.hpp"
 #include "SequenceAlgorithms.hpp"
+#include "ModelWriter.hpp"
+
+#include <algorithm>
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/exception_ptr.hpp>
 
 using namespace std;
 using namespace gmsuite;
@@ -74,6 +83,8 @@ GMS2Trainer::GMS2Trainer() {
     rbsSpacer = NULL;
     promoterSpacer = NULL;
     
+    countingThreads = 1;
+    motifThreads = 1;
 }
 
 GMS2Trainer::GMS2Trainer(unsigned pcounts,
@@ -311,32 +322,28 @@ GMS2Trainer::GMS2Trainer(
     numGeneticCode = new NumGeneticCode(*geneticCode, *cnc);
     
     cutPromTrainSeqs = false;
-    
+    countingThreads = 1;
+    motifThreads = 1;
 }
 
 // Esimate parameters for start/stop codons
 void GMS2Trainer::estimateParametersStartStopCodons(const NumSequence &sequence, const vector<Label*> &labels, const vector<bool> &use) {
     
     // check if all labels should be used
-    bool useAll = true;
     if (use.size() > 0) {
-        useAll = false;
         if (use.size() != labels.size())
             throw invalid_argument("Labels and Use vector should have the same length");
     }
     
-    // get starts and stops from genetic code definition
-    vector<CharNumConverter::seq_t> starts = this->numGeneticCode->getStarts();
-    vector<CharNumConverter::seq_t> stops = this->numGeneticCode->getStops();
-    
-    // fill in maps
-    for (size_t n = 0; n < starts.size(); n++)
-        this->startProbs[starts[n]] = 0;
-    for (size_t n = 0; n < stops.size(); n++)
-        this->stopProbs[stops[n]] = 0;              // stop probabilities to 1
+    map<CharNumConverter::seq_t, double> startCounts;
+    map<CharNumConverter::seq_t, double> stopCounts;
     
-    size_t totalStarts = 0;
-    size_t totalStops = 0;
+    countStartStopCodons(sequence, labels, startCounts, stopCounts);
+    constructStartStopProbs(startCounts, stopCounts);
+}
+
+// Count start/stop codons of labels
+void GMS2Trainer::countStartStopCodons(const NumSequence &sequence, const vector<Label*> &labels, map<CharNumConverter::seq_t, double> &startCounts, map<CharNumConverter::seq_t, double> &stopCounts) const {
     
     for (vector<Label*>::const_iterator iter = labels.begin(); iter != labels.end(); iter++) {
         
@@ -360,15 +367,38 @@ void GMS2Trainer::estimateParametersStartStopCodons(const NumSequence &sequence,
         }
         
         // if it is a start, add it to counts
-        if (this->numGeneticCode->isStart(start)) {
-            this->startProbs[start] += 1;
-            totalStarts += 1;
-        }
+        if (this->numGeneticCode->isStart(start))
+            startCounts[start] += 1;
         
-        if (this->numGeneticCode->isStop(stop)) {
-            this->stopProbs[stop] += 1;
-            totalStops += 1;
-        }
+        if (this->numGeneticCode->isStop(stop))
+            stopCounts[stop] += 1;
+    }
+}
+
+// Convert start/stop codon counts to probabilities
+void GMS2Trainer::constructStartStopProbs(const map<CharNumConverter::seq_t, double> &startCounts, const map<CharNumConverter::seq_t, double> &stopCounts) {
+    
+    // get starts and stops from genetic code definition
+    vector<CharNumConverter::seq_t> starts = this->numGeneticCode->getStarts();
+    vector<CharNumConverter::seq_t> stops = this->numGeneticCode->getStops();
+    
+    // fill in maps
+    for (size_t n = 0; n < starts.size(); n++)
+        this->startProbs[starts[n]] = 0;
+    for (size_t n = 0; n < stops.size(); n++)
+        this->stopProbs[stops[n]] = 0;              // stop probabilities to 1
+    
+    size_t totalStarts = 0;
+    size_t totalStops = 0;
+    
+    for (map<CharNumConverter::seq_t, double>::const_iterator iter = startCounts.begin(); iter != startCounts.end(); iter++) {
+        this->startProbs[iter->first] += iter->second;
+        totalStarts += iter->second;
+    }
+    
+    for (map<CharNumConverter::seq_t, double>::const_iterator iter = stopCounts.begin(); iter != stopCounts.end(); iter++) {
+        this->stopProbs[iter->first] += iter->second;
+        totalStops += iter->second;
     }
     
     // add pseudocounts
@@ -396,6 +426,20 @@ void GMS2Trainer::estimateParametersStartStopCodons(const NumSequence &sequence,
 // Estimate parameters for gene coding model
 void GMS2Trainer::estimateParamtersCoding(const NumSequence &sequence, const vector<Label *> &labels, NumSequence::size_type scSize, const vector<bool> &use) {
     
+//    PeriodicCounts counts (codingOrder, 3, *this->alphabet);
+    CodingCounts counts (params.orderCoding, 3, *this->alphabet, *this->numGeneticCode);
+    countCoding(sequence, labels, scSize, use, counts);
+    
+    // convert counts to probabilities
+//    coding = new PeriodicMarkov(codingOrder, 3, *this->alphabet);
+    coding = new CodingMarkov(params.orderCoding, 3, *this->alphabet, *this->numGeneticCode);
+    coding->construct(&counts, params.pcounts);
+    
+}
+
+// Count genes for the coding model
+void GMS2Trainer::countCoding(const NumSequence &sequence, const vector<Label *> &labels, NumSequence::size_type scSize, const vector<bool> &use, CodingCounts &counts) const {
+    
     // check if all labels should be used
     bool useAll = true;
     if (use.size() > 0) {
@@ -404,9 +448,6 @@ void GMS2Trainer::estimateParamtersCoding(const NumSequence &sequence, const vec
             throw invalid_argument("Labels and Use vector should have the same length");
     }
     
-//    PeriodicCounts counts (codingOrder, 3, *this->alphabet);
-    CodingCounts counts (params.orderCoding, 3, *this->alphabet, *this->numGeneticCode);
-    
     // get counts for 3 period markov model given order
     size_t n = 0;
     for (vector<Label*>::const_iterator iter = labels.begin(); iter != labels.end(); iter++) {
@@ -439,17 +480,23 @@ void GMS2Trainer::estimateParamtersCoding(const NumSequence &sequence, const vec
         }
         
     }
-    
-    // convert counts to probabilities
-//    coding = new PeriodicMarkov(codingOrder, 3, *this->alphabet);
-    coding = new CodingMarkov(params.orderCoding, 3, *this->alphabet, *this->numGeneticCode);
-    coding->construct(&counts, params.pcounts);
-    
 }
 
 // this function assumes labels are sorted by "left" in increasing order
 void GMS2Trainer::estimateParamtersNonCoding(const NumSequence &sequence, const vector<Label *> &labels, const vector<bool> &use) {
     
+//    UniformCounts counts(noncodingOrder, *this->alphabet);
+    NonCodingCounts counts(params.orderNonCoding, *this->alphabet);
+    countNonCoding(sequence, labels, use, counts);
+    
+    // convert counts to probabilities
+    noncoding = new UniformMarkov(params.orderNonCoding, *this->alphabet);
+    noncoding->construct(&counts, params.pcounts);
+}
+
+// Count the regions between labels for the noncoding model (labels need not be sorted)
+void GMS2Trainer::countNonCoding(const NumSequence &sequence, const vector<Label *> &labels, const vector<bool> &use, NonCodingCounts &counts) const {
+    
     // check if all labels should be used
     bool useAll = true;
     if (use.size() > 0) {
@@ -458,44 +505,44 @@ void GMS2Trainer::estimateParamtersNonCoding(const NumSequence &sequence, const
             throw invalid_argument("Labels and Use vector should have the same length");
     }
     
-//    UniformCounts counts(noncodingOrder, *this->alphabet);
-    NonCodingCounts counts(params.orderNonCoding, *this->alphabet);
+    // walk over labels in order of their left-end
+    LabelIndex index (labels);
     
     // train non-coding on labels
     size_t leftNoncoding = 0;       // left position of current noncoding region
     
     // get counts for 3 period markov model given order
-    size_t n = 0;
-    for (vector<Label*>::const_iterator iter = labels.begin(); iter != labels.end(); iter++) {
-        if (!useAll && !use[n++])
+    for (size_t k = 0; k < index.size(); k++) {
+        size_t n = index.sortedByLeft(k);
+        if (!useAll && !use[n])
             continue;       // skip unwanted genes
         
-        if (*iter == NULL)
-            throw invalid_argument("Label can't be NULL");
-        
-        size_t left = (*iter)->left;                // get left position of fragment
-        size_t right = (*iter)->right;              // get right position of fragment
+        size_t left = index.left(n);                // get left position of fragment
+        size_t right = index.right(n);              // get right position of fragment
         
         if (leftNoncoding < left) {
             counts.count(sequence.begin() + leftNoncoding, sequence.begin() + left);
         }
         
-        // update left position of (possible) non-coding region after current gene
-        leftNoncoding = right+1;
+        // update left position of (possible) non-coding region after current gene; nested genes don't move it back
+        leftNoncoding = std::max(leftNoncoding, right+1);
         
     }
     
     // add last non-coding sequence
     counts.count(sequence.begin() + leftNoncoding, sequence.begin() + sequence.size());
-
-    
-    // convert counts to probabilities
-    noncoding = new UniformMarkov(params.orderNonCoding, *this->alphabet);
-    noncoding->construct(&counts, params.pcounts);
 }
 
 // Estimate parameters for start-context model
 void GMS2Trainer::estimateParametersStartContext(const NumSequence &sequence, const vector<Label *> &labels, const vector<bool> &use) {
+    
+    NonUniformCounts counts(params.orderStartContext, params.lengthStartContext, *this->alphabet);
+    countStartContext(sequence, labels, use, counts);
+    constructStartContext(counts);
+}
+
+// Count the start context of labels
+void GMS2Trainer::countStartContext(const NumSequence &sequence, const vector<Label *> &labels, const vector<bool> &use, NonUniformCounts &counts) const {
     // check if all labels should be used
     bool useAll = true;
     if (use.size() > 0) {
@@ -504,11 +551,6 @@ void GMS2Trainer::estimateParametersStartContext(const NumSequence &sequence, co
             throw invalid_argument("Labels and Use vector should have the same length");
     }
     
-    AlphabetDNA alph;
-    CharNumConverter cnc(&alph);
-    
-    NonUniformCounts counts(params.orderStartContext, params.lengthStartContext, *this->alphabet);
-    
     // get counts for start context model
     size_t n = 0;
     for (vector<Label*>::const_iterator iter = labels.begin(); iter != labels.end(); iter++) {
@@ -550,6 +592,10 @@ void GMS2Trainer::estimateParametersStartContext(const NumSequence &sequence, co
 //        cout << cnc.convert(s.begin(), s.end()) << endl;
         
     }
+}
+
+// Convert start-context counts to probabilities
+void GMS2Trainer::constructStartContext(const NonUniformCounts &counts) {
     
     // convert counts to probabilities
     if (!params.runMotifSearch) {
@@ -563,73 +609,147 @@ void GMS2Trainer::estimateParametersStartContext(const NumSequence &sequence, co
 }
 
 
-// Estimate parameters for motif models (based on genome group)
+// Estimate parameters for motif models of a single sequence
 void GMS2Trainer::estimateParametersMotifModel(const NumSequence &sequence, const vector<Label *> &labels, const vector<bool> &use) {
     
+    estimateParametersMotifModel(contig_set_t (1, &sequence), contig_labels_t (1, labels), vector<vector<bool> > (1, use));
+}
+
+
+// Estimate parameters for motif models (based on genome group)
+void GMS2Trainer::estimateParametersMotifModel(const contig_set_t &contigs, const contig_labels_t &labels, const vector<vector<bool> > &use) {
+    
+    if (labels.size() != contigs.size())
+        throw invalid_argument("Contigs and labels should have the same length");
+    
     // check if all labels should be used
-    if (use.size() > 0) {
-        if (use.size() != labels.size())
-            throw invalid_argument("Labels and Use vector should have the same length");
-    }
+    if (use.size() > 0 && use.size() != labels.size())
+        throw invalid_argument("Labels and Use vector should have the same length");
     
-    // copy only usable labels
-    size_t numUse = labels.size();
-    if (use.size() > 0) {
-        numUse = 0;
-        for (size_t n = 0; n < labels.size(); n++)
-            if (use[n])
-                numUse++;
-    }
+    // index the contigs once, for all upstream regions extracted below (unless given; see setContigIndexes)
+    indexContigs(contigs);
     
-    vector<Label*> useLabels (numUse);
-    size_t pos = 0;
-    for (size_t n = 0; n < labels.size(); n++) {
-        if (use[n])
-            useLabels[pos++] = labels[n];
+    // copy only usable labels
+    contig_labels_t useLabels (labels.size());
+    for (size_t c = 0; c < labels.size(); c++) {
+        
+        if (use.size() == 0 || use[c].size() == 0) {
+            useLabels[c] = labels[c];
+            continue;
+        }
+        
+        if (use[c].size() != labels[c].size())
+            throw invalid_argument("Labels and Use vector should have the same length");
+        
+        for (size_t n = 0; n < labels[c].size(); n++) {
+            if (use[c][n])
+                useLabels[c].push_back(labels[c][n]);
+        }
     }
 
     
     if (params.genomeGroup == ProkGeneStartModel::A) {
         this->genomeType = "group-a";
-        estimateParametersMotifModel_GroupA(sequence, useLabels);
+        estimateParametersMotifModel_GroupA(contigs, useLabels);
     }
     else if (params.genomeGroup == ProkGeneStartModel::A2) {
         this->genomeType = "group-a2";
-        estimateParametersMotifModel_groupA2(sequence, useLabels);
+        estimateParametersMotifModel_groupA2(contigs, useLabels);
     }
     else if (params.genomeGroup == ProkGeneStartModel::B) {
         this->genomeType = "group-b";
-        estimateParametersMotifModel_GroupB(sequence, useLabels);
+        estimateParametersMotifModel_GroupB(contigs, useLabels);
     }
     else if (params.genomeGroup == ProkGeneStartModel::C) {
         this->genomeType = "group-c";
-        estimateParametersMotifModel_GroupC(sequence, useLabels);
+        estimateParametersMotifModel_GroupC(contigs, useLabels);
     }
     else if (params.genomeGroup == ProkGeneStartModel::C2) {
         this->genomeType = "group-c2";
-        estimateParametersMotifModel_GroupC2(sequence,useLabels);
+        estimateParametersMotifModel_GroupC2(contigs, useLabels);
     }
     else if (params.genomeGroup == ProkGeneStartModel::D) {
         this->genomeType = "group-d";
-        estimateParametersMotifModel_GroupD(sequence, useLabels);
+        estimateParametersMotifModel_GroupD(contigs, useLabels);
     }
     else {
         this->genomeType = "group-e";
-        estimateParametersMotifModel_GroupE(sequence, useLabels);
+        estimateParametersMotifModel_GroupE(contigs, useLabels);
+    }
+    
+    contigIndexes.clear();          // contigs are not owned by the trainer
+}
+
+
+// Use prebuilt prefix-count indexes of the contigs for the next training
+void GMS2Trainer::setContigIndexes(const vector<NumSequenceIndex> &indexes) {
+    contigIndexes = indexes;
+}
+
+
+// Get the prefix-count index of each contig, building it unless it's already built for these contigs
+const vector<NumSequenceIndex>& GMS2Trainer::indexContigs(const contig_set_t &contigs) {
+    
+    bool built = (contigIndexes.size() == contigs.size());
+    for (size_t c = 0; built && c < contigs.size(); c++)
+        built = contigIndexes[c].isIndexOf(*contigs[c]);
+    
+    if (!built) {
+        contigIndexes.clear();
+        contigIndexes.reserve(contigs.size());
+        for (size_t c = 0; c < contigs.size(); c++)
+            contigIndexes.push_back(NumSequenceIndex(*contigs[c], *alphabet));
     }
+    
+    return contigIndexes;
 }
 
 
-void runMotifFinder(const vector<NumSequence> &sequencesRaw, const OptionsMFinder &optionsMFinder, const NumAlphabetDNA  &numAlph, size_t upstreamLength, NonUniformMarkov* &motifMarkov, UnivariatePDF* &motifSpacer) {
+// run a task, keeping any exception it throws for the thread that joins it
+static void runTaskCapturingException(const boost::function<void ()> &task, boost::exception_ptr &error) {
+    try {
+        task();
+    }
+    catch (...) {
+        error = boost::current_exception();
+    }
+}
+
+// Run two independent tasks: one after the other, or at the same time (the second on a new
+// thread) if concurrent. An exception thrown by either task is rethrown once both are done.
+static void runTasks(const boost::function<void ()> &first, const boost::function<void ()> &second, bool concurrent) {
+    
+    if (!concurrent) {
+        first();
+        second();
+        return;
+    }
+    
+    boost::exception_ptr secondError;
+    boost::thread worker (boost::bind(runTaskCapturingException, boost::cref(second), boost::ref(secondError)));
+    
+    try {
+        first();
+    }
+    catch (...) {
+        worker.join();
+        throw;
+    }
+    
+    worker.join();
+    if (secondError)
+        boost::rethrow_exception(secondError);
+}
+
+
+void runMotifFinder(const vector<NumSequenceView> &sequencesRaw, const OptionsMFinder &optionsMFinder, const NumAlphabetDNA  &numAlph, size_t upstreamLength, NonUniformMarkov* &motifMarkov, UnivariatePDF* &motifSpacer) {
     
 //    AlphabetDNA alph;
 //    CharNumConverter cnc(&alph);
     
-    vector<NumSequence> upstreams;
-    for (size_t n = 0; n < sequencesRaw.size(); n++) {
-        if (!sequencesRaw[n].containsInvalid(numAlph))
-            upstreams.push_back(sequencesRaw[n]);
-    }
+    // copy upstreams into a single batch; those with ambiguous letters are skipped by the search
+    SequenceBatch upstreams (sequencesRaw);
+    upstreams.invalidateAmbiguous(numAlph);
     
     MotifFinder::Builder b;
     MotifFinder mfinder = b.build(optionsMFinder);
@@ -641,7 +761,8 @@ void runMotifFinder(const vector<NumSequence> &sequencesRaw, const OptionsMFinde
     // build RBS model
     NonUniformCounts motifCounts(optionsMFinder.motifOrder, optionsMFinder.width, numAlph);
     for (size_t n = 0; n < upstreams.size(); n++) {
-        motifCounts.count(upstreams[n].begin()+positions[n], upstreams[n].begin()+positions[n]+optionsMFinder.width);
+        if (upstreams.isValid(n))
+            motifCounts.count(upstreams.begin(n)+positions[n], upstreams.begin(n)+positions[n]+optionsMFinder.width);
     }
     
     motifMarkov = new NonUniformMarkov(optionsMFinder.motifOrder, optionsMFinder.width, numAlph);
@@ -651,6 +772,9 @@ void runMotifFinder(const vector<NumSequence> &sequencesRaw, const OptionsMFinde
     // build histogram from positions
     vector<double> positionCounts (upstreamLength - optionsMFinder.width+1, 0);
     for (size_t n = 0; n < positions.size(); n++) {
+        if (!upstreams.isValid(n))
+            continue;
+        
         // FIXME account for LEFT alignment
         // below is only for right
         positionCounts[upstreamLength - optionsMFinder.width - positions[n]]++;        // increment position
@@ -662,37 +786,224 @@ void runMotifFinder(const vector<NumSequence> &sequencesRaw, const OptionsMFinde
 }
 
 
+// Run the promoter and RBS motif searches; they share no data, so they run at the same time when training has more than one thread
+void GMS2Trainer::runMotifFinders(const vector<NumSequenceView> &upstreamsPromoter, const OptionsMFinder &optionsPromoter, size_t upstreamLengthPromoter,
+                                  const vector<NumSequenceView> &upstreamsRBS, const OptionsMFinder &optionsRBS, size_t upstreamLengthRBS) {
+    
+    // the two searches split the training's threads between their restarts
+    OptionsMFinder promoterOptions (optionsPromoter);
+    OptionsMFinder rbsOptions (optionsRBS);
+    promoterOptions.numThreads = std::max(1u, (motifThreads + 1) / 2);
+    rbsOptions.numThreads = std::max(1u, motifThreads / 2);
+    
+    runTasks(boost::bind(runMotifFinder, boost::cref(upstreamsPromoter), boost::cref(promoterOptions), boost::cref(*this->alphabet), upstreamLengthPromoter, boost::ref(this->promoter), boost::ref(this->promoterSpacer)),
+             boost::bind(runMotifFinder, boost::cref(upstreamsRBS), boost::cref(rbsOptions), boost::cref(*this->alphabet), upstreamLengthRBS, boost::ref(this->rbs), boost::ref(this->rbsSpacer)),
+             motifThreads > 1);
+}
+
+
+// Counts of all models that are trained directly from labels
+struct GMS2Trainer::contig_counts_t {
+    
+    contig_counts_t(const GMS2TrainerParameters &params, const NumAlphabetDNA &alph, const NumGeneticCode &gc) :
+        coding (params.orderCoding, 3, alph, gc),
+        noncoding (params.orderNonCoding, alph),
+        startContext (params.orderStartContext, params.lengthStartContext, alph) {
+    }
+    
+    // add the counts of another worker
+    void add(const contig_counts_t &other) {
+        coding.add(other.coding);
+        noncoding.add(other.noncoding);
+        startContext.add(other.startContext);
+        
+        for (map<CharNumConverter::seq_t, double>::const_iterator iter = other.starts.begin(); iter != other.starts.end(); iter++)
+            starts[iter->first] += iter->second;
+        for (map<CharNumConverter::seq_t, double>::const_iterator iter = other.stops.begin(); iter != other.stops.end(); iter++)
+            stops[iter->first] += iter->second;
+    }
+    
+    CodingCounts coding;
+    NonCodingCounts noncoding;
+    NonUniformCounts startContext;
+    map<CharNumConverter::seq_t, double> starts;
+    map<CharNumConverter::seq_t, double> stops;
+};
+
 
 void GMS2Trainer::estimateParameters(const NumSequence &sequence, const vector<gmsuite::Label *> &labels) {
     
+    vector<vector<bool> > useCoding (1, vector<bool>(labels.size(), true));
+    selectLabelsForCodingParameters(labels, useCoding[0]);
+    
+    // a single sequence has no contigs to share, so its thread budget is that of the motif searches
+    estimateParametersContigs(contig_set_t (1, &sequence), contig_labels_t (1, labels), useCoding, this->params.optionsMFinder->numThreads);
+}
+
+
+// Train on a multi-contig genome
+void GMS2Trainer::estimateParameters(const vector<NumSequence> &contigs, const contig_labels_t &labels, unsigned numThreads) {
+    
+    if (labels.size() != contigs.size())
+        throw invalid_argument("Contigs and labels should have the same length");
+    
+    contig_set_t contigSet (contigs.size());
+    for (size_t c = 0; c < contigs.size(); c++)
+        contigSet[c] = &contigs[c];
+    
+    // labels need not be sorted: neighbors are looked up through a LabelIndex
+    vector<vector<bool> > useCoding (contigs.size());           // labels of each contig used for coding model (also used for motif search)
+    for (size_t c = 0; c < contigs.size(); c++) {
+        useCoding[c].assign(labels[c].size(), true);
+        selectLabelsForCodingParameters(labels[c], useCoding[c]);
+    }
+    
+    estimateParametersContigs(contigSet, labels, useCoding, numThreads);
+}
+
+
+// Train on a multi-contig genome, with labels in label sets
+void GMS2Trainer::estimateParameters(const vector<NumSequence> &contigs, const vector<LabelSet> &labels, unsigned numThreads) {
+    
+    if (labels.size() != contigs.size())
+        throw invalid_argument("Contigs and labels should have the same length");
+    
+    contig_set_t contigSet (contigs.size());
+    vector<vector<Label> > contigLabels (contigs.size());
+    contig_labels_t labelPointers (contigs.size());
+    vector<vector<bool> > useCoding (contigs.size());
+    
+    for (size_t c = 0; c < contigs.size(); c++) {
+        contigSet[c] = &contigs[c];
+        
+        // the models read labels through pointers, so lay each contig's labels out contiguously
+        labels[c].toLabels(contigLabels[c]);
+        labelPointers[c].resize(contigLabels[c].size());
+        for (size_t n = 0; n < contigLabels[c].size(); n++)
+            labelPointers[c][n] = &contigLabels[c][n];
+        
+        useCoding[c].assign(labels[c].size(), true);
+        selectLabelsForCodingParameters(labels[c], useCoding[c]);
+    }
+    
+    estimateParametersContigs(contigSet, labelPointers, useCoding, numThreads);
+}
+
+
+void GMS2Trainer::estimateParametersContigs(const contig_set_t &contigs, const contig_labels_t &labels, const vector<vector<bool> > &useCoding, unsigned numThreads) {
+    
+    if (labels.size() != contigs.size() || useCoding.size() != contigs.size())
+        throw invalid_argument("Contigs and labels should have the same length");
+    
+    // check labels before handing them to workers
+    for (size_t c = 0; c < contigs.size(); c++) {
+        for (size_t n = 0; n < labels[c].size(); n++) {
+            if (labels[c][n] == NULL)
+                throw invalid_argument("Label cannot be null");
+            if (labels[c][n]->right >= contigs[c]->size())
+                throw invalid_argument("Label lies outside of its contig");
+        }
+    }
+    
     // reset all models
     deallocAllModels();
     
-    // TODO: sort labels by 'left' in increasing order
-    vector<bool> useCoding (labels.size(), true);               // assume all labels should be used for coding model
-    vector<bool> useNonCoding (labels.size(), true);            // assume all labels should be used for noncoding model
-    vector<bool> useStartContext (labels.size(), true);         // assume all labels should be used for startcontext model
-    vector<bool> useMotif (labels.size(), true);                // assume all labels should be used for motif search model
+    numThreads = std::max(1u, numThreads);
+    countingThreads = numThreads;
+    motifThreads = numThreads;
+    
+    // the motif models only depend on the labels (not on the counts), so with more than one
+    // thread they are estimated while contigs are counted
+    void (GMS2Trainer::*motifModel)(const contig_set_t&, const contig_labels_t&, const vector<vector<bool> >&) = &GMS2Trainer::estimateParametersMotifModel;
+    
+    if (params.runMotifSearch) {
+        // counting and the motif searches then split the threads: counting takes at most half
+        if (numThreads > 1) {
+            countingThreads = (unsigned) std::max<size_t>(1, std::min<size_t>(numThreads / 2, contigs.size()));
+            motifThreads = numThreads - countingThreads;
+        }
+        
+        runTasks(boost::bind(&GMS2Trainer::estimateParametersFromCounts, this, boost::cref(contigs), boost::cref(labels), boost::cref(useCoding)),
+                 boost::bind(motifModel, this, boost::cref(contigs), boost::cref(labels), boost::cref(useCoding)),
+                 numThreads > 1);
+    }
+    else
+        estimateParametersFromCounts(contigs, labels, useCoding);
+}
+
+
+// Count contigs (on countingThreads workers), and build the models that are estimated directly from counts
+void GMS2Trainer::estimateParametersFromCounts(const contig_set_t &contigs, const contig_labels_t &labels, const vector<vector<bool> > &useCoding) {
+    
+    size_t numWorkers = std::max<size_t>(1, std::min<size_t>(countingThreads, contigs.size()));
+    
+    // each worker counts into its own models
+    vector<contig_counts_t*> workerCounts (numWorkers);
+    for (size_t w = 0; w < numWorkers; w++)
+        workerCounts[w] = new contig_counts_t(params, *this->alphabet, *this->numGeneticCode);
     
+    contig_queue_t queue;
+    queue.nextContig = 0;
+    
+    // count contigs on the current thread
+    if (numWorkers == 1) {
+        countContigs(contigs, labels, useCoding, *workerCounts[0], queue);
+    }
+    // otherwise, count contigs concurrently on a pool of workers
+    else {
+        boost::thread_group workers;
+        for (size_t w = 0; w < numWorkers; w++) {
+            workers.create_thread(boost::bind(&GMS2Trainer::countContigs, this, boost::cref(contigs), boost::cref(labels),
+                                              boost::cref(useCoding), boost::ref(*workerCounts[w]), boost::ref(queue)));
+        }
+        workers.join_all();
+    }
+    
+    // merge counts of all workers, in worker order
+    contig_counts_t &counts = *workerCounts[0];
+    for (size_t w = 1; w < numWorkers; w++)
+        counts.add(*workerCounts[w]);
     
     // estimate parameters for coding model
-    selectLabelsForCodingParameters(labels, useCoding);
-    estimateParamtersCoding(sequence, labels, params.lengthStartContext, useCoding);
+    coding = new CodingMarkov(params.orderCoding, 3, *this->alphabet, *this->numGeneticCode);
+    coding->construct(&counts.coding, params.pcounts);
     
-    estimateParametersStartStopCodons(sequence, labels);
+    constructStartStopProbs(counts.starts, counts.stops);
     
     // estimate parameters for noncoding model
-    useNonCoding = useCoding;                           // for now, assume
-    estimateParamtersNonCoding(sequence, labels);
+    noncoding = new UniformMarkov(params.orderNonCoding, *this->alphabet);
+    noncoding->construct(&counts.noncoding, params.pcounts);
     
     // estimate parameters for start context
-    useStartContext = useCoding;
-    estimateParametersStartContext(sequence, labels);
+    constructStartContext(counts.startContext);
     
-    // estimate parameters for motif models
-    if (params.runMotifSearch) {
-        useMotif = useCoding;
-        estimateParametersMotifModel(sequence, labels, useMotif);
+    for (size_t w = 0; w < numWorkers; w++)
+        delete workerCounts[w];
+}
+
+
+// Worker loop: claim contigs one at a time until none are left
+void GMS2Trainer::countContigs(const contig_set_t &contigs, const contig_labels_t &labels, const vector<vector<bool> > &useCoding, contig_counts_t &counts, contig_queue_t &queue) const {
+    
+    while (true) {
+        
+        // claim next contig
+        size_t c;
+        {
+            boost::mutex::scoped_lock scopedLock(queue.lock);
+            if (queue.nextContig >= contigs.size())
+                break;
+            c = queue.nextContig++;
+        }
+        
+        const NumSequence &sequence = *contigs[c];
+        const vector<Label*> &contigLabels = labels[c];
+        
+        // for now, the noncoding and start-context models use all labels
+        countCoding(sequence, contigLabels, params.lengthStartContext, useCoding[c], counts.coding);
+        countStartStopCodons(sequence, contigLabels, counts.starts, counts.stops);
+        countNonCoding(sequence, contigLabels, vector<bool>(), counts.noncoding);
+        countStartContext(sequence, contigLabels, vector<bool>(), counts.startContext);
     }
 }
 
@@ -718,122 +1029,116 @@ GMS2Trainer::~GMS2Trainer() {
 }
 
 // convert codon frequency models to model file output
-void codonFrequencyToMod(const map<CharNumConverter::seq_t, double> &codons, const CharNumConverter &cnc, vector<pair<string, string> > &toMod) {
+void codonFrequencyToMod(const map<CharNumConverter::seq_t, double> &codons, const CharNumConverter &cnc, ModelWriter &writer) {
     
     for (map<CharNumConverter::seq_t, double>::const_iterator iter = codons.begin(); iter != codons.end(); iter++) {
-        stringstream ssm; ssm << fixed;
-        
         string cod = cnc.convert(iter->first.begin(), iter->first.end());
-        ssm << iter->second;
-        
-        toMod.push_back(pair<string,string>(cod, ssm.str()));
+        writer.writeFixed(cod, iter->second);
     }
     
 }
 
-// Convert models and parameters to string in model file format
-void GMS2Trainer::toModFile(vector<pair<string, string> > &toMod, const OptionsGMS2Training &options) const {
-    
-    typedef pair<string, string> mpair;
+// Write models and parameters to a model file, in model file format
+void GMS2Trainer::toModFile(ModelWriter &writer, const OptionsGMS2Training &options) const {
     
     // name and genetic code
-    toMod.push_back(mpair("NAME", "gms2-training"));
-    toMod.push_back(mpair("GCODE", this->numGeneticCode->getName()));
-    toMod.push_back(mpair("NON_DURATION_DECAY", boost::lexical_cast<string>(options.nonDurationDecay)));
-    toMod.push_back(mpair("COD_DURATION_DECAY", boost::lexical_cast<string>(options.codDurationDecay)));
-    toMod.push_back(mpair("COD_P_N", boost::lexical_cast<string>(options.codProbN)));
-    toMod.push_back(mpair("NON_P_N", boost::lexical_cast<string>(options.nonProbN)));
-    toMod.push_back(mpair("GENE_MIN_LENGTH", boost::lexical_cast<string>(options.geneMinLengthPrediction)));
+    writer.write("NAME", "gms2-training");
+    writer.write("GCODE", this->numGeneticCode->getName());
+    writer.write("NON_DURATION_DECAY", boost::lexical_cast<string>(options.nonDurationDecay));
+    writer.write("COD_DURATION_DECAY", boost::lexical_cast<string>(options.codDurationDecay));
+    writer.write("COD_P_N", boost::lexical_cast<string>(options.codProbN));
+    writer.write("NON_P_N", boost::lexical_cast<string>(options.nonProbN));
+    writer.write("GENE_MIN_LENGTH", boost::lexical_cast<string>(options.geneMinLengthPrediction));
     
     
     // add start/stop codon probabilities
-    codonFrequencyToMod(startProbs, *this->alphabet->getCNC(), toMod);
-    codonFrequencyToMod(stopProbs,  *this->alphabet->getCNC(), toMod);
+    codonFrequencyToMod(startProbs, *this->alphabet->getCNC(), writer);
+    codonFrequencyToMod(stopProbs,  *this->alphabet->getCNC(), writer);
     
     // add description to mod file
     if (coding != NULL) {
-        toMod.push_back(mpair("COD_ORDER", boost::lexical_cast<string>(coding->getOrder())));
-        toMod.push_back(mpair("COD_MAT", coding->toString()));
+        writer.write("COD_ORDER", boost::lexical_cast<string>(coding->getOrder()));
+        writer.write("COD_MAT", *coding);
     }
     
     if (noncoding != NULL) {
-        toMod.push_back(mpair("NON_ORDER", boost::lexical_cast<string>(noncoding->getOrder())));
-        toMod.push_back(mpair("NON_MAT",  noncoding->toString()));
+        writer.write("NON_ORDER", boost::lexical_cast<string>(noncoding->getOrder()));
+        writer.write("NON_MAT", *noncoding);
     }
     
     if (startContext != NULL) {
-        toMod.push_back(mpair("SC", "1"));
-        toMod.push_back(mpair("SC_ORDER", boost::lexical_cast<string>(startContext->getOrder())));
-        toMod.push_back(mpair("SC_WIDTH", boost::lexical_cast<string>(startContext->getLength())));
-        toMod.push_back(mpair("SC_MARGIN", boost::lexical_cast<string>(params.marginStartContext)));
-        toMod.push_back(mpair("SC_MAT", startContext->toString()));
+        writer.write("SC", "1");
+        writer.write("SC_ORDER", boost::lexical_cast<string>(startContext->getOrder()));
+        writer.write("SC_WIDTH", boost::lexical_cast<string>(startContext->getLength()));
+        writer.write("SC_MARGIN", boost::lexical_cast<string>(params.marginStartContext));
+        writer.write("SC_MAT", *startContext);
     }
     
     if (rbs != NULL) {
-        toMod.push_back(mpair("RBS", "1"));
-        toMod.push_back(mpair("RBS_ORDER", boost::lexical_cast<string>(rbs->getOrder())));
-        toMod.push_back(mpair("RBS_WIDTH", boost::lexical_cast<string>(rbs->getLength())));
-        toMod.push_back(mpair("RBS_MARGIN", "0"));
-        toMod.push_back(mpair("RBS_MAT", rbs->toString()));
+        writer.write("RBS", "1");
+        writer.write("RBS_ORDER", boost::lexical_cast<string>(rbs->getOrder()));
+        writer.write("RBS_WIDTH", boost::lexical_cast<string>(rbs->getLength()));
+        writer.write("RBS_MARGIN", "0");
+        writer.write("RBS_MAT", *rbs);
         
         if (startContextRBS != NULL) {
-            toMod.push_back(mpair("SC_RBS", "1"));
-            toMod.push_back(mpair("SC_RBS_ORDER", boost::lexical_cast<string>(startContextRBS->getOrder())));
-            toMod.push_back(mpair("SC_RBS_WIDTH", boost::lexical_cast<string>(startContextRBS->getLength())));
-            toMod.push_back(mpair("SC_RBS_MARGIN", boost::lexical_cast<string>(params.marginStartContext)));
-            toMod.push_back(mpair("SC_RBS_MAT", startContextRBS->toString()));
+            writer.write("SC_RBS", "1");
+            writer.write("SC_RBS_ORDER", boost::lexical_cast<string>(startContextRBS->getOrder()));
+            writer.write("SC_RBS_WIDTH", boost::lexical_cast<string>(startContextRBS->getLength()));
+            writer.write("SC_RBS_MARGIN", boost::lexical_cast<string>(params.marginStartContext));
+            writer.write("SC_RBS_MAT", *startContextRBS);
         }
     }
     
     if (rbsSpacer != NULL && rbsSpacer->size() > 0) {
-        toMod.push_back(mpair("RBS_MAX_DUR", boost::lexical_cast<string>(rbsSpacer->size() - 1)));
-        toMod.push_back(mpair("RBS_POS_DISTR", rbsSpacer->toString()));
+        writer.write("RBS_MAX_DUR", boost::lexical_cast<string>(rbsSpacer->size() - 1));
+        writer.write("RBS_POS_DISTR", *rbsSpacer);
     }
     
-    toMod.push_back(mpair("PROMOTER_NUM_FGIO", boost::lexical_cast<string>(this->numFGIO)));
+    writer.write("PROMOTER_NUM_FGIO", boost::lexical_cast<string>(this->numFGIO));
     
     if (promoter != NULL) {
-        toMod.push_back(mpair("PROMOTER", "1"));
-        toMod.push_back(mpair("PROMOTER_ORDER", boost::lexical_cast<string>(promoter->getOrder())));
-        toMod.push_back(mpair("PROMOTER_WIDTH", boost::lexical_cast<string>(promoter->getLength())));
-        toMod.push_back(mpair("PROMOTER_MARGIN", "0"));
-        toMod.push_back(mpair("PROMOTER_MAT", promoter->toString()));
-        toMod.push_back(mpair("PROMOTER_NUM_LEADERLESS", boost::lexical_cast<string>(this->numLeaderless)));
+        writer.write("PROMOTER", "1");
+        writer.write("PROMOTER_ORDER", boost::lexical_cast<string>(promoter->getOrder()));
+        writer.write("PROMOTER_WIDTH", boost::lexical_cast<string>(promoter->getLength()));
+        writer.write("PROMOTER_MARGIN", "0");
+        writer.write("PROMOTER_MAT", *promoter);
+        writer.write("PROMOTER_NUM_LEADERLESS", boost::lexical_cast<string>(this->numLeaderless));
         
         
         if (startContextPromoter != NULL) {
-            toMod.push_back(mpair("SC_PROMOTER", "1"));
-            toMod.push_back(mpair("SC_PROMOTER_ORDER", boost::lexical_cast<string>(startContextPromoter->getOrder())));
-            toMod.push_back(mpair("SC_PROMOTER_WIDTH", boost::lexical_cast<string>(startContextPromoter->getLength())));
-            toMod.push_back(mpair("SC_PROMOTER_MARGIN", boost::lexical_cast<string>(params.marginStartContext)));
-            toMod.push_back(mpair("SC_PROMOTER_MAT", startContextPromoter->toString()));
+            writer.write("SC_PROMOTER", "1");
+            writer.write("SC_PROMOTER_ORDER", boost::lexical_cast<string>(startContextPromoter->getOrder()));
+            writer.write("SC_PROMOTER_WIDTH", boost::lexical_cast<string>(startContextPromoter->getLength()));
+            writer.write("SC_PROMOTER_MARGIN", boost::lexical_cast<string>(params.marginStartContext));
+            writer.write("SC_PROMOTER_MAT", *startContextPromoter);
         }
         else if (startContextRBS != NULL) {                 // copy promoter start context from RBS start context
-            toMod.push_back(mpair("SC_PROMOTER", "1"));
-            toMod.push_back(mpair("SC_PROMOTER_ORDER", boost::lexical_cast<string>(startContextRBS->getOrder())));
-            toMod.push_back(mpair("SC_PROMOTER_WIDTH", boost::lexical_cast<string>(startContextRBS->getLength())));
-            toMod.push_back(mpair("SC_PROMOTER_MARGIN", boost::lexical_cast<string>(params.marginStartContext)));
-            toMod.push_back(mpair("SC_PROMOTER_MAT", startContextRBS->toString()));
+            writer.write("SC_PROMOTER", "1");
+            writer.write("SC_PROMOTER_ORDER", boost::lexical_cast<string>(startContextRBS->getOrder()));
+            writer.write("SC_PROMOTER_WIDTH", boost::lexical_cast<string>(startContextRBS->getLength()));
+            writer.write("SC_PROMOTER_MARGIN", boost::lexical_cast<string>(params.marginStartContext));
+            writer.write("SC_PROMOTER_MAT", *startContextRBS);
         }
     }
     
     if (promoterSpacer != NULL && promoterSpacer->size() > 0) {
-        toMod.push_back(mpair("PROMOTER_MAX_DUR", boost::lexical_cast<string>(promoterSpacer->size() - 1)));
-        toMod.push_back(mpair("PROMOTER_POS_DISTR", promoterSpacer->toString()));
+        writer.write("PROMOTER_MAX_DUR", boost::lexical_cast<string>(promoterSpacer->size() - 1));
+        writer.write("PROMOTER_POS_DISTR", *promoterSpacer);
     }
 
-    toMod.push_back(mpair("GENOME_TYPE", this->genomeType));
+    writer.write("GENOME_TYPE", this->genomeType);
     
 //    if (upstreamSignature != NULL) {
 //        int upstrSigMargin = 0;
 //        if (startContext != NULL)
 //            upstrSigMargin= max(0, (int)startContext->getLength() - scMargin);
 //            
-//        toMod.push_back(mpair("UPSTR_SIG_ORDER", "1"));
-//        toMod.push_back(mpair("UPSTR_SIG_ORDER", boost::lexical_cast<string>(upstreamSignature->getOrder())));
-//        toMod.push_back(mpair("UPSTR_SIG_WIDTH", boost::lexical_cast<string>(upstreamSignature->getLength())));
-//        toMod.push_back(mpair("UPSTR_SIGN_MARGIN", boost::lexical_cast<string>(scMargin)));
-//        toMod.push_back(mpair("UPSTR_SIG_MAT", upstreamSignature->toString()));
+//        writer.write("UPSTR_SIG_ORDER", "1");
+//        writer.write("UPSTR_SIG_ORDER", boost::lexical_cast<string>(upstreamSignature->getOrder()));
+//        writer.write("UPSTR_SIG_WIDTH", boost::lexical_cast<string>(upstreamSignature->getLength()));
+//        writer.write("UPSTR_SIGN_MARGIN", boost::lexical_cast<string>(scMargin));
+//        writer.write("UPSTR_SIG_MAT", *upstreamSignature);
 //    }
 }
 
@@ -863,6 +1168,27 @@ void GMS2Trainer::selectLabelsForCodingParameters(const vector<Label*> &labels,
 }
 
 
+// Select labels to be used for estimation of coding model parameters, from a label set's columns
+void GMS2Trainer::selectLabelsForCodingParameters(const LabelSet &labels, vector<bool> &useCoding) const {
+    
+    if (useCoding.size() != labels.size())
+        throw invalid_argument("Labels and useCoding vectors should have the same size");
+    
+    // remove all atypical genes, and keep all native (including short)
+    if (params.onlyTrainOnNativeGenes) {
+        labels.markClassContaining("native", useCoding);
+        return;
+    }
+    
+    // "remove" short genes
+    size_t minimumLength = params.minimumGeneLengthTraining;
+    for (size_t n = 0; n < labels.size(); n++) {
+        if ((size_t) (labels.right(n) - labels.left(n)) + 1 <= minimumLength)
+            useCoding[n] = false;
+    }
+}
+
+
 
 
 
@@ -872,33 +1198,110 @@ void GMS2Trainer::selectLabelsForCodingParameters(const vector<Label*> &labels,
 \*************************/
 
 
+// Split the labels of each contig based on operon status; operons never span contigs
+void splitContigLabelsBasedOnOperonStatus(const GMS2Trainer::contig_labels_t &labels, size_t fgioThresh, size_t igioThresh,
+                                          GMS2Trainer::contig_labels_t &labelsFGIO, GMS2Trainer::contig_labels_t &labelsIGIO, GMS2Trainer::contig_labels_t &labelsAMBIG) {
+    
+    labelsFGIO.resize(labels.size());
+    labelsIGIO.resize(labels.size());
+    labelsAMBIG.resize(labels.size());
+    
+    for (size_t c = 0; c < labels.size(); c++) {
+        vector<LabelsParser::operon_status_t> operonStatuses;
+        LabelsParser::partitionBasedOnOperonStatus(labels[c], fgioThresh, igioThresh, operonStatuses);
+        LabelsParser::splitBasedOnPartition(labels[c], operonStatuses, labelsFGIO[c], labelsIGIO[c], labelsAMBIG[c]);
+    }
+}
+
+
+// Total number of labels over all contigs
+size_t numContigLabels(const GMS2Trainer::contig_labels_t &labels) {
+    size_t total = 0;
+    for (size_t c = 0; c < labels.size(); c++)
+        total += labels[c].size();
+    return total;
+}
+
+
+// Sort the labels of a contig by left-end (ties by right-end), so that results built from them in
+// order (e.g. motif searches over their upstreams) do not depend on the order of the label file
+void sortLabelsByLeft(const vector<Label*> &labels, vector<Label*> &sortedLabels) {
+    
+    LabelIndex index (labels);
+    
+    sortedLabels.resize(labels.size());
+    for (size_t k = 0; k < labels.size(); k++)
+        sortedLabels[k] = labels[index.sortedByLeft(k)];
+}
+
+
+// Extract upstream regions of labels from each contig, in contig order, and by left-end within a contig
+// (if contig indexes are given, upstreams containing ambiguous elements are skipped)
+void extractContigUpstreams(const GMS2Trainer::contig_set_t &contigs, const GMS2Trainer::contig_labels_t &labels, const CharNumConverter &cnc,
+                            NumSequence::size_type upstrLength, vector<NumSequenceView> &upstreams, bool allowOverlapWithCDS = false, size_t minimumGeneLength = 0,
+                            const vector<NumSequenceIndex> *contigIndexes = NULL) {
+    
+    upstreams.clear();
+    
+    vector<NumSequenceView> contigUpstreams;
+    vector<Label*> sortedLabels;
+    for (size_t c = 0; c < contigs.size(); c++) {
+        sortLabelsByLeft(labels[c], sortedLabels);
+        SequenceParser::extractUpstreamSequences(*contigs[c], sortedLabels, cnc, upstrLength, contigUpstreams, allowOverlapWithCDS, minimumGeneLength);
+        
+        if (contigIndexes == NULL) {
+            upstreams.insert(upstreams.end(), contigUpstreams.begin(), contigUpstreams.end());
+            continue;
+        }
+        
+        for (size_t n = 0; n < contigUpstreams.size(); n++) {
+            if (!(*contigIndexes)[c].containsInvalid(contigUpstreams[n]))
+                upstreams.push_back(contigUpstreams[n]);
+        }
+    }
+}
+
+
+// Extract start contexts of labels from each contig, in contig order (as numeric sequences or views)
+template <class T>
+void extractContigStartContexts(const GMS2Trainer::contig_set_t &contigs, const GMS2Trainer::contig_labels_t &labels, const CharNumConverter &cnc,
+                                long long posRelToStart, NumSequence::size_type length, vector<T> &contexts) {
+    
+    contexts.clear();
+    
+    vector<T> contigContexts;
+    for (size_t c = 0; c < contigs.size(); c++) {
+        SequenceParser::extractStartContextSequences(*contigs[c], labels[c], cnc, posRelToStart, length, contigContexts);
+        contexts.insert(contexts.end(), contigContexts.begin(), contigContexts.end());
+    }
+}
+
+
+
 
 
-void GMS2Trainer::estimateParametersMotifModel_groupA2(const NumSequence &sequence, const vector<Label *> &labels) {
+void GMS2Trainer::estimateParametersMotifModel_groupA2(const contig_set_t &contigs, const contig_labels_t &labels) {
     
     AlphabetDNA alph;
     CharNumConverter cnc(&alph);
     NumAlphabetDNA numAlph(alph, cnc);
     
     // split labels into sets based on operon status
-    vector<LabelsParser::operon_status_t> operonStatuses;
-    LabelsParser::partitionBasedOnOperonStatus(labels, params.fgioDistanceThresh, params.igioDistanceThresh, operonStatuses);
-    
-    vector<Label*> labelsFGIO, labelsIG, labelsUNK;
-    LabelsParser::splitBasedOnPartition(labels, operonStatuses, labelsFGIO, labelsIG, labelsUNK);
+    contig_labels_t labelsFGIO, labelsIG, labelsUNK;
+    splitContigLabelsBasedOnOperonStatus(labels, params.fgioDistanceThresh, params.igioDistanceThresh, labelsFGIO, labelsIG, labelsUNK);
     
-    vector<NumSequence> upstreamsRBS;
-    vector<NumSequence> upstreamsPromoter;
+    vector<NumSequenceView> upstreamsRBS;
+    vector<NumSequenceView> upstreamsPromoter;
     
     
     
     // match FGIO to 16S tail
-    vector<NumSequence> upstreamsFGIOForMatching, upstreamsFGIOForPromoter;
-    SequenceParser::extractUpstreamSequences(sequence, labelsFGIO, cnc, params.groupA_upstreamLengthPromoter, upstreamsFGIOForPromoter, true);
+    vector<NumSequenceView> upstreamsFGIOForMatching, upstreamsFGIOForPromoter;
+    extractContigUpstreams(contigs, labelsFGIO, cnc, params.groupA_upstreamLengthPromoter, upstreamsFGIOForPromoter, true);
     
     upstreamsFGIOForMatching.resize(upstreamsFGIOForPromoter.size());
     for (size_t n = 0; n < upstreamsFGIOForPromoter.size(); n++) {
-        upstreamsFGIOForMatching[n] = upstreamsFGIOForPromoter[n].subseq(params.groupA_upstreamLengthPromoter - params.groupA_upstreamLengthRBS, params.groupA_upstreamLengthRBS);
+        upstreamsFGIOForMatching[n] = upstreamsFGIOForPromoter[n].subview(params.groupA_upstreamLengthPromoter - params.groupA_upstreamLengthRBS, params.groupA_upstreamLengthRBS);
         assert(upstreamsFGIOForMatching[n].size() == params.groupA_upstreamLengthRBS);
     }
     
@@ -924,8 +1327,8 @@ void GMS2Trainer::estimateParametersMotifModel_groupA2(const NumSequence &sequen
     }
     
     
-    vector<NumSequence> upstreamsIG;
-    SequenceParser::extractUpstreamSequences(sequence, labelsIG, cnc, params.groupA_upstreamLengthRBS, upstreamsIG);
+    vector<NumSequenceView> upstreamsIG;
+    extractContigUpstreams(contigs, labelsIG, cnc, params.groupA_upstreamLengthRBS, upstreamsIG);
     for (size_t n = 0; n < upstreamsIG.size(); n++) {
         upstreamsRBS.push_back(upstreamsIG[n]);
     }
@@ -942,12 +1345,12 @@ void GMS2Trainer::estimateParametersMotifModel_groupA2(const NumSequence &sequen
     // take first
     if (cutPromTrainSeqs) {
         for (size_t n = 0; n < upstreamsPromoter.size(); n++) {
-            upstreamsPromoter[n] = upstreamsPromoter[n].subseq(0, params.groupA_upstreamLengthPromoter - 15);
+            upstreamsPromoter[n] = upstreamsPromoter[n].subview(0, params.groupA_upstreamLengthPromoter - 15);
         }
     }
     
-    runMotifFinder(upstreamsPromoter, optionMFinderPromoter, *this->alphabet, params.groupA_upstreamLengthPromoter, this->promoter, this->promoterSpacer);
-    runMotifFinder(upstreamsRBS, optionMFinderRBS, *this->alphabet, params.groupA_upstreamLengthRBS, this->rbs, this->rbsSpacer);
+    runMotifFinders(upstreamsPromoter, optionMFinderPromoter, params.groupA_upstreamLengthPromoter,
+                    upstreamsRBS, optionMFinderRBS, params.groupA_upstreamLengthRBS);
     
     //    // shift probabilities
     //    vector<double> extendedProbs (promoterSpacer->size()+skipFromStart, 0);
@@ -972,31 +1375,28 @@ void GMS2Trainer::estimateParametersMotifModel_groupA2(const NumSequence &sequen
 }
 
 
-void GMS2Trainer::estimateParametersMotifModel_GroupA(const NumSequence &sequence, const vector<Label *> &labels) {
+void GMS2Trainer::estimateParametersMotifModel_GroupA(const contig_set_t &contigs, const contig_labels_t &labels) {
     
     AlphabetDNA alph;
     CharNumConverter cnc(&alph);
     NumAlphabetDNA numAlph(alph, cnc);
     
     // split labels into sets based on operon status
-    vector<LabelsParser::operon_status_t> operonStatuses;
-    LabelsParser::partitionBasedOnOperonStatus(labels, params.fgioDistanceThresh, params.igioDistanceThresh, operonStatuses);
+    contig_labels_t labelsFGIO, labelsIG, labelsUNK;
+    splitContigLabelsBasedOnOperonStatus(labels, params.fgioDistanceThresh, params.igioDistanceThresh, labelsFGIO, labelsIG, labelsUNK);
     
-    vector<Label*> labelsFGIO, labelsIG, labelsUNK;
-    LabelsParser::splitBasedOnPartition(labels, operonStatuses, labelsFGIO, labelsIG, labelsUNK);
-    
-    vector<NumSequence> upstreamsFGIO;
-    SequenceParser::extractUpstreamSequences(sequence, labelsFGIO, cnc, this->params.groupA_upstreamLengthPromoter, upstreamsFGIO, true);
+    vector<NumSequenceView> upstreamsFGIO;
+    extractContigUpstreams(contigs, labelsFGIO, cnc, this->params.groupA_upstreamLengthPromoter, upstreamsFGIO, true);
     
     // take first
     if (cutPromTrainSeqs) {
         for (size_t n = 0; n < upstreamsFGIO.size(); n++) {
-            upstreamsFGIO[n] = upstreamsFGIO[n].subseq(0, this->params.groupA_upstreamLengthPromoter - 15);
+            upstreamsFGIO[n] = upstreamsFGIO[n].subview(0, this->params.groupA_upstreamLengthPromoter - 15);
         }
     }
     
-    vector<NumSequence> upstreamsIG;
-    SequenceParser::extractUpstreamSequences(sequence, labelsIG, cnc, this->params.groupA_upstreamLengthRBS, upstreamsIG);
+    vector<NumSequenceView> upstreamsIG;
+    extractContigUpstreams(contigs, labelsIG, cnc, this->params.groupA_upstreamLengthRBS, upstreamsIG);
     
     //    void runMotifFinder(const vector<NumSequence> &sequencesRaw, OptionsMFinder &optionsMFinder, size_t upstreamLength, NonUniformMarkov* motifMarkov, UnivariatePDF* motifSpacer) {
     //
@@ -1010,8 +1410,8 @@ void GMS2Trainer::estimateParametersMotifModel_GroupA(const NumSequence &sequenc
     OptionsMFinder optionsMFinderRBS (*this->params.optionsMFinder);
     optionsMFinderRBS.width =  params.groupA_widthRBS;
     
-    runMotifFinder(upstreamsFGIO, optionMFinderFGIO, *this->alphabet, this->params.groupA_upstreamLengthPromoter, this->promoter, this->promoterSpacer);
-    runMotifFinder(upstreamsIG, optionsMFinderRBS, *this->alphabet, this->params.groupA_upstreamLengthRBS, this->rbs, this->rbsSpacer);
+    runMotifFinders(upstreamsFGIO, optionMFinderFGIO, this->params.groupA_upstreamLengthPromoter,
+                    upstreamsIG, optionsMFinderRBS, this->params.groupA_upstreamLengthRBS);
     
     
     // shift probabilities
@@ -1028,25 +1428,22 @@ void GMS2Trainer::estimateParametersMotifModel_GroupA(const NumSequence &sequenc
 }
 
 
-void GMS2Trainer::estimateParametersMotifModel_GroupB(const NumSequence &sequence, const vector<Label *> &labels) {
+void GMS2Trainer::estimateParametersMotifModel_GroupB(const contig_set_t &contigs, const contig_labels_t &labels) {
     
     AlphabetDNA alph;
     CharNumConverter cnc(&alph);
     NumAlphabetDNA numAlph(alph, cnc);
     
     // split labels into sets based on operon status
-    vector<LabelsParser::operon_status_t> operonStatuses;
-    LabelsParser::partitionBasedOnOperonStatus(labels, params.fgioDistanceThresh, params.igioDistanceThresh, operonStatuses);
-    
-    vector<Label*> labelsFGIO, labelsIG, labelsUNK;
-    LabelsParser::splitBasedOnPartition(labels, operonStatuses, labelsFGIO, labelsIG, labelsUNK);
+    contig_labels_t labelsFGIO, labelsIG, labelsUNK;
+    splitContigLabelsBasedOnOperonStatus(labels, params.fgioDistanceThresh, params.igioDistanceThresh, labelsFGIO, labelsIG, labelsUNK);
     
-    vector<NumSequence> upstreamsRBS;
-    vector<NumSequence> upstreamsPromoter;
+    vector<NumSequenceView> upstreamsRBS;
+    vector<NumSequenceView> upstreamsPromoter;
     
     // match FGIO to 16S tail
-    vector<NumSequence> upstreamsFGIO;
-    SequenceParser::extractUpstreamSequences(sequence, labelsFGIO, cnc, params.groupB_upstreamLengthPromoter, upstreamsFGIO);
+    vector<NumSequenceView> upstreamsFGIO;
+    extractContigUpstreams(contigs, labelsFGIO, cnc, params.groupB_upstreamLengthPromoter, upstreamsFGIO);
     
     Sequence strMatchSeq (params.groupB_extendedSD);
     NumSequence matchSeq (strMatchSeq, cnc);
@@ -1062,14 +1459,14 @@ void GMS2Trainer::estimateParametersMotifModel_GroupB(const NumSequence &sequenc
         
         // keep track of nonmatches
         if (match.size() < params.groupB_minMatchToExtendedSD)
-            upstreamsPromoter.push_back(upstreamsFGIO[n].subseq(0, upstreamsFGIO[n].size() - skipFromStart));
+            upstreamsPromoter.push_back(upstreamsFGIO[n].subview(0, upstreamsFGIO[n].size() - skipFromStart));
         else
             upstreamsRBS.push_back(upstreamsFGIO[n]);
     }
     
     
-    vector<NumSequence> upstreamsIG;
-    SequenceParser::extractUpstreamSequences(sequence, labelsIG, cnc, params.groupB_upstreamLengthRBS, upstreamsIG);
+    vector<NumSequenceView> upstreamsIG;
+    extractContigUpstreams(contigs, labelsIG, cnc, params.groupB_upstreamLengthRBS, upstreamsIG);
     for (size_t n = 0; n < upstreamsIG.size(); n++) {
         upstreamsRBS.push_back(upstreamsIG[n]);
     }
@@ -1084,8 +1481,8 @@ void GMS2Trainer::estimateParametersMotifModel_GroupB(const NumSequence &sequenc
     OptionsMFinder optionsMFinderRBS (*this->params.optionsMFinder);
     optionsMFinderRBS.width =  params.groupB_widthRBS;
     
-    runMotifFinder(upstreamsPromoter, optionsMFinderPromoter, *this->alphabet, params.groupB_upstreamLengthPromoter-skipFromStart, this->promoter, this->promoterSpacer);
-    runMotifFinder(upstreamsRBS, optionsMFinderRBS, *this->alphabet, params.groupB_upstreamLengthRBS, this->rbs, this->rbsSpacer);
+    runMotifFinders(upstreamsPromoter, optionsMFinderPromoter, params.groupB_upstreamLengthPromoter-skipFromStart,
+                    upstreamsRBS, optionsMFinderRBS, params.groupB_upstreamLengthRBS);
     
     // shift probabilities
     vector<double> extendedProbs (promoterSpacer->size()+skipFromStart, 0);
@@ -1100,37 +1497,32 @@ void GMS2Trainer::estimateParametersMotifModel_GroupB(const NumSequence &sequenc
 }
 
 
-void GMS2Trainer::estimateParametersMotifModel_GroupC(const NumSequence &sequence, const vector<Label *> &labels) {
-    this->estimateParametersMotifModel_GroupD(sequence, labels);
+void GMS2Trainer::estimateParametersMotifModel_GroupC(const contig_set_t &contigs, const contig_labels_t &labels) {
+    this->estimateParametersMotifModel_GroupD(contigs, labels);
 }
 
 
-void GMS2Trainer::estimateParametersMotifModel_GroupC2(const NumSequence &sequence, const vector<Label *> &labels) {
+void GMS2Trainer::estimateParametersMotifModel_GroupC2(const contig_set_t &contigs, const contig_labels_t &labels) {
     
     // split labels into sets based on operon status
-    vector<LabelsParser::operon_status_t> operonStatuses;
-    LabelsParser::partitionBasedOnOperonStatus(labels, params.fgioDistanceThresh, params.igioDistanceThresh, operonStatuses);
-    
     // scope since variables won't (shouldn't) be used outside
     {
-    vector<Label*> labelsFGIO, labelsIGIO, labelsAMBIG;
-    LabelsParser::splitBasedOnPartition(labels, operonStatuses, labelsFGIO, labelsIGIO, labelsAMBIG);
+    contig_labels_t labelsFGIO, labelsIGIO, labelsAMBIG;
+    splitContigLabelsBasedOnOperonStatus(labels, params.fgioDistanceThresh, params.igioDistanceThresh, labelsFGIO, labelsIGIO, labelsAMBIG);
     
-    this->numFGIO = labelsFGIO.size();
+    this->numFGIO = numContigLabels(labelsFGIO);
     }
     
     // extract upstream of each label
-    vector<NumSequence> upstreamsRaw;
-    SequenceParser::extractUpstreamSequences(sequence, labels, *alphabet->getCNC(), params.groupC2_upstreamLengthSDRBS, upstreamsRaw, false, params.minimumGeneLengthTraining);
+    vector<NumSequenceView> upstreamsRaw;
+    extractContigUpstreams(contigs, labels, *alphabet->getCNC(), params.groupC2_upstreamLengthSDRBS, upstreamsRaw, false, params.minimumGeneLengthTraining, &indexContigs(contigs));
     
-    vector<NumSequence> upstreams;
-    for (size_t n = 0; n < upstreamsRaw.size(); n++) {
-        if (!upstreamsRaw[n].containsInvalid(*this->alphabet))
-            upstreams.push_back(upstreamsRaw[n].subseq(0, upstreamsRaw[n].size() - params.groupC2_upstreamRegion3Prime));
-    }
+    vector<NumSequenceView> upstreams;
+    for (size_t n = 0; n < upstreamsRaw.size(); n++)
+        upstreams.push_back(upstreamsRaw[n].subview(0, upstreamsRaw[n].size() - params.groupC2_upstreamRegion3Prime));
     
     
-    vector<NumSequence> upstreamsSD, upstreamsNonSD;
+    vector<NumSequenceView> upstreamsSD, upstreamsNonSD;
     
     // match against SD
     Sequence strMatchSeq (params.groupC2_extendedSD);
@@ -1147,14 +1539,14 @@ void GMS2Trainer::estimateParametersMotifModel_GroupC2(const NumSequence &sequen
         
         // keep track of nonmatches
         if (match.size() < params.groupC2_minMatchToExtendedSD)
-            upstreamsNonSD.push_back(upstreams[n].subseq(0, upstreams[n].size() - skipFromStart));
+            upstreamsNonSD.push_back(upstreams[n].subview(0, upstreams[n].size() - skipFromStart));
         else
             upstreamsSD.push_back(upstreams[n]);
     }
     
     
-    runMotifFinder(upstreamsSD, *this->params.optionsMFinder, *this->alphabet, params.groupC2_upstreamLengthSDRBS-skipFromStart, this->promoter, this->promoterSpacer);
-    runMotifFinder(upstreamsNonSD, *this->params.optionsMFinder, *this->alphabet, params.groupC2_upstreamLengthNonSDRBS, this->rbs, this->rbsSpacer);
+    runMotifFinders(upstreamsSD, *this->params.optionsMFinder, params.groupC2_upstreamLengthSDRBS-skipFromStart,
+                    upstreamsNonSD, *this->params.optionsMFinder, params.groupC2_upstreamLengthNonSDRBS);
     
     // shift probabilities
     vector<double> extendedProbs (promoterSpacer->size()+skipFromStart, 0);
@@ -1170,34 +1562,30 @@ void GMS2Trainer::estimateParametersMotifModel_GroupC2(const NumSequence &sequen
 }
 
 
-void GMS2Trainer::estimateParametersMotifModel_GroupD(const NumSequence &sequence, const vector<Label *> &labels) {
+void GMS2Trainer::estimateParametersMotifModel_GroupD(const contig_set_t &contigs, const contig_labels_t &labels) {
     
     MotifFinder::Builder b;
     OptionsMFinder optionsMFinderGroupD (*this->params.optionsMFinder);
     optionsMFinderGroupD.width =  params.groupD_widthRBS;
     if (params.genomeGroup == ProkGeneStartModel::C)
         optionsMFinderGroupD.width =  params.groupC_widthRBS;
+    optionsMFinderGroupD.numThreads = motifThreads;        // the only search, so it takes all motif threads
     MotifFinder mfinder = b.build(optionsMFinderGroupD);
     
     
     // split labels into sets based on operon status
-    vector<LabelsParser::operon_status_t> operonStatuses;
-    LabelsParser::partitionBasedOnOperonStatus(labels, params.fgioDistanceThresh, params.igioDistanceThresh, operonStatuses);
+    contig_labels_t labelsFGIO, labelsIGIO, labelsAMBIG;
+    splitContigLabelsBasedOnOperonStatus(labels, params.fgioDistanceThresh, params.igioDistanceThresh, labelsFGIO, labelsIGIO, labelsAMBIG);
     
-    vector<Label*> labelsFGIO, labelsIGIO, labelsAMBIG;
-    LabelsParser::splitBasedOnPartition(labels, operonStatuses, labelsFGIO, labelsIGIO, labelsAMBIG);
-    
-    this->numFGIO = labelsFGIO.size();
+    this->numFGIO = numContigLabels(labelsFGIO);
     
     // extract upstream of each label
-    vector<NumSequence> upstreamsRaw;
-    SequenceParser::extractUpstreamSequences(sequence, labels, *alphabet->getCNC(), params.groupD_upstreamLengthRBS, upstreamsRaw, false, params.minimumGeneLengthTraining);
+    vector<NumSequenceView> upstreamsRaw;
+    extractContigUpstreams(contigs, labels, *alphabet->getCNC(), params.groupD_upstreamLengthRBS, upstreamsRaw, false, params.minimumGeneLengthTraining, &indexContigs(contigs));
     
-    vector<NumSequence> upstreams;
-    for (size_t n = 0; n < upstreamsRaw.size(); n++) {
-        if (!upstreamsRaw[n].containsInvalid(*this->alphabet))
-            upstreams.push_back(upstreamsRaw[n].subseq(0, upstreamsRaw[n].size() - params.groupC_upstreamRegion3Prime));
-    }
+    vector<NumSequenceView> upstreams;
+    for (size_t n = 0; n < upstreamsRaw.size(); n++)
+        upstreams.push_back(upstreamsRaw[n].subview(0, upstreamsRaw[n].size() - params.groupC_upstreamRegion3Prime));
     
     vector<NumSequence::size_type> positions;
     mfinder.findMotifs(upstreams, positions);
@@ -1205,7 +1593,7 @@ void GMS2Trainer::estimateParametersMotifModel_GroupD(const NumSequence &sequenc
     // build RBS model
     NonUniformCounts rbsCounts(optionsMFinderGroupD.motifOrder, optionsMFinderGroupD.width, *this->alphabet);
     for (size_t n = 0; n < upstreams.size(); n++) {
-        rbsCounts.count(upstreams[n].begin()+positions[n], upstreams[n].begin()+positions[n]+optionsMFinderGroupD.width);
+        rbsCounts.count(upstreams[n].subview(positions[n], optionsMFinderGroupD.width));
     }
     
     rbs = new NonUniformMarkov(optionsMFinderGroupD.motifOrder, optionsMFinderGroupD.width, *this->alphabet);
@@ -1225,7 +1613,7 @@ void GMS2Trainer::estimateParametersMotifModel_GroupD(const NumSequence &sequenc
 }
 
 
-void GMS2Trainer::estimateParametersMotifModel_GroupE(const NumSequence &sequence, const vector<Label *> &labels) {
+void GMS2Trainer::estimateParametersMotifModel_GroupE(const contig_set_t &contigs, const contig_labels_t &labels) {
     
     AlphabetDNA alph;
     CharNumConverter cnc(&alph);
@@ -1241,22 +1629,29 @@ void GMS2Trainer::estimateParametersMotifModel_GroupE(const NumSequence &sequenc
         substitutions.push_back(pair<NumSequence::num_t, NumSequence::num_t> (cnc.convert('A'), cnc.convert('G')));
     
     
-    // extract upstream for every sequence and match it to 16S tail
-    vector<NumSequence> upstreams (labels.size());
-    SequenceParser::extractUpstreamSequences(sequence, labels, cnc, params.groupE_upstreamLengthRBS, upstreams);
+    // extract upstream for every sequence and match it to 16S tail (per contig, to pair upstreams with labels;
+    // labels are sorted by left-end, as upstreams are for motif searches)
     size_t skipFromStart = 0;
     
-    vector<Label*> labelsSig;
-    vector<Label*> labelsRBS;
+    contig_labels_t labelsSig (contigs.size());
+    contig_labels_t labelsRBS (contigs.size());
     
-    for (size_t n = 0; n < upstreams.size(); n++) {
-        NumSequence match = SequenceAlgorithms::longestMatchTo16S(matchSeq, upstreams[n], positionsOfMatches, substitutions);
+    vector<Label*> sortedLabels;
+    for (size_t c = 0; c < contigs.size(); c++) {
+        sortLabelsByLeft(labels[c], sortedLabels);
         
-        // keep track of nonmatches
-        if (match.size() < params.groupE_minMatchToExtendedSD)
-            labelsSig.push_back(labels[n]);
-        else
-            labelsRBS.push_back(labels[n]);
+        vector<NumSequenceView> upstreams (sortedLabels.size());
+        SequenceParser::extractUpstreamSequences(*contigs[c], sortedLabels, cnc, params.groupE_upstreamLengthRBS, upstreams);
+        
+        for (size_t n = 0; n < upstreams.size(); n++) {
+            NumSequence match = SequenceAlgorithms::longestMatchTo16S(matchSeq, upstreams[n], positionsOfMatches, substitutions);
+            
+            // keep track of nonmatches
+            if (match.size() < params.groupE_minMatchToExtendedSD)
+                labelsSig[c].push_back(sortedLabels[n]);
+            else
+                labelsRBS[c].push_back(sortedLabels[n]);
+        }
     }
     
     // for all non-Sig sequences, append "N" to mask Sig sequences
@@ -1275,7 +1670,7 @@ void GMS2Trainer::estimateParametersMotifModel_GroupE(const NumSequence &sequenc
     
     vector<NumSequence> contextsRBS;
     long long posRelToStart = - (params.lengthStartContext + params.marginStartContext + params.groupE_orderUpstreamSignature);
-    SequenceParser::extractStartContextSequences(sequence, labelsRBS, cnc, posRelToStart, params.lengthStartContext + this->params.groupE_orderUpstreamSignature, contextsRBS);
+    extractContigStartContexts(contigs, labelsRBS, cnc, posRelToStart, params.lengthStartContext + this->params.groupE_orderUpstreamSignature, contextsRBS);
     
     for (size_t n = 0; n < contextsRBS.size(); n++) {
         NumSequence withNs = numSeqNs + contextsRBS[n];     // append N's
@@ -1284,11 +1679,11 @@ void GMS2Trainer::estimateParametersMotifModel_GroupE(const NumSequence &sequenc
     }
     
     // add Sig sequences
-    vector<NumSequence> contextsSig;
-    SequenceParser::extractStartContextSequences(sequence, labelsSig, cnc, -( (int)params.groupE_lengthUpstreamSignature + params.marginStartContext), params.groupE_lengthUpstreamSignature, contextsSig);
+    vector<NumSequenceView> contextsSig;
+    extractContigStartContexts(contigs, labelsSig, cnc, -( (int)params.groupE_lengthUpstreamSignature + params.marginStartContext), params.groupE_lengthUpstreamSignature, contextsSig);
     
     for (size_t n = 0; n < contextsSig.size(); n++) {
-        counts.count(contextsSig[n].begin(), contextsSig[n].end());
+        counts.count(contextsSig[n]);
         //        cout << cnc.convert(contextsSig[n].begin(), contextsSig[n].end()) << endl;
     }
     
@@ -1297,12 +1692,13 @@ void GMS2Trainer::estimateParametersMotifModel_GroupE(const NumSequence &sequenc
     startContext->construct(&counts, params.pcounts);
     
     // run motif search for RBS
-    vector<NumSequence> upstreamsRBS;
-    SequenceParser::extractUpstreamSequences(sequence, labelsRBS, cnc, this->params.groupE_upstreamLengthRBS, upstreamsRBS);
+    vector<NumSequenceView> upstreamsRBS;
+    extractContigUpstreams(contigs, labelsRBS, cnc, this->params.groupE_upstreamLengthRBS, upstreamsRBS);
     
     MotifFinder::Builder b;
     OptionsMFinder optionsMFinderGroupE (*this->params.optionsMFinder);
     optionsMFinderGroupE.width =  params.groupE_widthRBS;
+    optionsMFinderGroupE.numThreads = motifThreads;        // the only search, so it takes all motif threads
     runMotifFinder(upstreamsRBS, optionsMFinderGroupE, *this->alphabet, this->params.groupE_upstreamLengthRBS, this->rbs, this->rbsSpacer);
     
     
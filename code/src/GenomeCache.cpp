@@ -0,0 +1,140 @@
+//
+//  GenomeCache.cpp
+//  GeneMark Suite
+//
+
+#include "GenomeCache.hpp"
+
+#include <stdexcept>
+#include <sys/stat.h>
+
+#include "SequenceFile.hpp"
+#include "LabelFile.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+GenomeCache::GenomeCache() : cnc(&alph), numAlph(alph, cnc) {
+    numGenomeReads = 0;
+}
+
+
+// Get the signature of a file
+GenomeCache::signature_t GenomeCache::fileSignature(const string &path) {
+    
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0)
+        throw invalid_argument("Could not access file: " + path);
+    
+    signature_t signature;
+    signature.inode = (long long) status.st_ino;
+    signature.size = (long long) status.st_size;
+    signature.modified = (long long) status.st_mtime;
+#if defined(__APPLE__)
+    signature.modifiedNanoseconds = (long long) status.st_mtimespec.tv_nsec;
+#else
+    signature.modifiedNanoseconds = (long long) status.st_mtim.tv_nsec;
+#endif
+    
+    return signature;
+}
+
+bool GenomeCache::sameSignature(const signature_t &a, const signature_t &b) {
+    return a.inode == b.inode && a.size == b.size && a.modified == b.modified && a.modifiedNanoseconds == b.modifiedNanoseconds;
+}
+
+
+// Get a genome, (re)reading it if it's not cached or its file changed
+GenomeCache::genome_t& GenomeCache::genome(const string &fnSequence) {
+    
+    signature_t signature = fileSignature(fnSequence);
+    
+    map<string, genome_t>::iterator found = genomes.find(fnSequence);
+    if (found != genomes.end() && sameSignature(found->second.signature, signature))
+        return found->second;
+    
+    if (found == genomes.end())
+        found = genomes.insert(make_pair(fnSequence, genome_t())).first;
+    
+    // indexes refer to the old contigs, so drop them first
+    genome_t &genome = found->second;
+    genome.indexes.clear();
+    
+    try {
+        SequenceFile seqFile (fnSequence, SequenceFile::READ);
+        seqFile.read(genome.contigs, genome.contigIDs, cnc);
+    }
+    catch (...) {
+        genomes.erase(found);
+        throw;
+    }
+    
+    genome.signature = signature;
+    genome.version = ++numGenomeReads;
+    return genome;
+}
+
+
+const vector<NumSequence>& GenomeCache::contigs(const string &fnSequence, vector<string> *contigIDs) {
+    
+    genome_t &genome = this->genome(fnSequence);
+    if (contigIDs != NULL)
+        *contigIDs = genome.contigIDs;
+    
+    return genome.contigs;
+}
+
+
+const vector<NumSequenceIndex>& GenomeCache::contigIndexes(const string &fnSequence) {
+    
+    genome_t &genome = this->genome(fnSequence);
+    if (genome.indexes.size() != genome.contigs.size()) {
+        genome.indexes.clear();
+        genome.indexes.reserve(genome.contigs.size());
+        for (size_t c = 0; c < genome.contigs.size(); c++)
+            genome.indexes.push_back(NumSequenceIndex(genome.contigs[c], numAlph));
+    }
+    
+    return genome.indexes;
+}
+
+
+const vector<LabelSet>& GenomeCache::labels(const string &fnLabels, const string &fnSequence) {
+    
+    genome_t &genome = this->genome(fnSequence);
+    signature_t signature = fileSignature(fnLabels);
+    
+    pair<string, string> key (fnLabels, fnSequence);
+    map<pair<string, string>, labels_t>::iterator found = labelSets.find(key);
+    
+    // labels are matched to contig IDs, so they're reread when either file changes
+    if (found != labelSets.end() && sameSignature(found->second.signature, signature) && found->second.genomeVersion == genome.version)
+        return found->second.labels;
+    
+    if (found == labelSets.end())
+        found = labelSets.insert(make_pair(key, labels_t())).first;
+    
+    try {
+        LabelFile labelFile (fnLabels, LabelFile::READ);
+        labelFile.read(genome.contigIDs, found->second.labels);
+    }
+    catch (...) {
+        labelSets.erase(found);
+        throw;
+    }
+    
+    found->second.signature = signature;
+    found->second.genomeVersion = genome.version;
+    return found->second.labels;
+}
+
+
+const NumAlphabetDNA& GenomeCache::getAlphabet() const {
+    return numAlph;
+}
+
+
+void GenomeCache::clear() {
+    labelSets.clear();
+    genomes.clear();
+}
@@ -9,15 +9,17 @@
 #include "LabelFile.hpp"
 
 #include <fstream>
-#include <boost/xpressive/xpressive.hpp>
+#include <string.h>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/lexical_cast.hpp>
 
-using namespace boost::xpressive;
 using namespace gmsuite;
 using namespace std;
 
 
-Label* readNextLabelLST(const char*& current, const char* const end);
-void gotoKey(const char*& current, const char* const end, string key);
+bool readNextLabelLST(const char*& current, const char* const end, LabelSet &output);
+bool readSequenceID(const char*& current, const char* const end, string &sequenceID);
 
 
 // constructor
@@ -53,9 +55,130 @@ LabelFile::~LabelFile() {
 // Read labels from file. This behaves differently for separate file formats.
 void LabelFile::read(vector<Label*> &output) const {
     
+    LabelSet labels;
+    read(labels);
+    
+    output.resize(labels.size());
+    for (size_t n = 0; n < labels.size(); n++)
+        output[n] = new Label(labels.label(n));
+}
+
+
+// Read labels from file into a contiguous vector
+void LabelFile::read(vector<Label> &output) const {
+    
+    LabelSet labels;
+    read(labels);
+    labels.toLabels(output);
+}
+
+
+// Read labels from file into a compact label set
+void LabelFile::read(LabelSet &output) const {
+    
+    vector<string> sequenceIDs;
+    vector<size_t> sequenceOfLabel;
+    
+    output.clear();
+    
+    // read based on format set
+    if (this->format == LST)
+        read_lst(output, sequenceIDs, sequenceOfLabel);
+}
+
+
+// Read labels from file, grouped by sequence ID
+void LabelFile::read(map<string, vector<Label*> > &output) const {
+    
+    output.clear();
+    
+    LabelSet labels;
+    vector<string> sequenceIDs;
+    vector<size_t> sequenceOfLabel;
+    
+    // read based on format set
+    if (this->format == LST)
+        read_lst(labels, sequenceIDs, sequenceOfLabel);
+    
+    for (size_t n = 0; n < labels.size(); n++)
+        output[sequenceIDs[sequenceOfLabel[n]]].push_back(new Label(labels.label(n)));
+}
+
+
+// Read labels of given sequences, matched by sequence ID
+void LabelFile::read(const vector<string> &sequenceIDs, vector<vector<Label*> > &output) const {
+    
+    vector<LabelSet> labelSets;
+    read(sequenceIDs, labelSets);
+    
+    output.resize(labelSets.size());
+    for (size_t s = 0; s < labelSets.size(); s++) {
+        output[s].resize(labelSets[s].size());
+        for (size_t n = 0; n < labelSets[s].size(); n++)
+            output[s][n] = new Label(labelSets[s].label(n));
+    }
+}
+
+
+// Read labels of given sequences into label sets, matched by sequence ID
+void LabelFile::read(const vector<string> &sequenceIDs, vector<LabelSet> &output) const {
+    
+    output.clear();
+    output.resize(sequenceIDs.size());
+    
+    LabelSet labels;
+    vector<string> fileIDs;
+    vector<size_t> sequenceOfLabel;
+    
     // read based on format set
     if (this->format == LST)
-        read_lst(output);
+        read_lst(labels, fileIDs, sequenceOfLabel);
+    
+    // a single sequence takes all labels of a file with a single sequence ID, whatever that ID is
+    if (sequenceIDs.size() == 1 && fileIDs.size() == 1) {
+        output[0] = labels;
+        return;
+    }
+    
+    // find the output index of each sequence ID in the file (or NO_SEQUENCE if it isn't requested)
+    const size_t NO_SEQUENCE = sequenceIDs.size();
+    map<string, size_t> requested;
+    for (size_t s = 0; s < sequenceIDs.size(); s++)
+        requested.insert(pair<string, size_t>(sequenceIDs[s], s));
+    
+    bool anyMatched = false;
+    vector<size_t> outputOfID (fileIDs.size(), NO_SEQUENCE);
+    for (size_t i = 0; i < fileIDs.size(); i++) {
+        map<string, size_t>::const_iterator found = requested.find(fileIDs[i]);
+        if (found != requested.end()) {
+            outputOfID[i] = found->second;
+            anyMatched = true;
+        }
+    }
+    
+    // if no ID matches, IDs are ordinals of the sequences (e.g. "SequenceID: 1", as written by GeneMark.hmm)
+    if (!anyMatched) {
+        for (size_t i = 0; i < fileIDs.size(); i++) {
+            const string &id = fileIDs[i];
+            if (id.empty() || id.find_first_not_of("0123456789") != string::npos || id.size() > 18)
+                continue;
+            
+            size_t ordinal = boost::lexical_cast<size_t>(id);
+            if (ordinal >= 1 && ordinal <= sequenceIDs.size())
+                outputOfID[i] = ordinal - 1;
+        }
+    }
+    
+    // labels that belong to no sequence would be silently lost, so the file must match the sequences
+    if (labels.size() > 0) {
+        for (size_t i = 0; i < fileIDs.size(); i++) {
+            if (outputOfID[i] == NO_SEQUENCE)
+                throw invalid_argument("Sequence ID in label file matches no sequence (by ID or by ordinal): " + fileIDs[i]);
+        }
+    }
+    
+    for (size_t n = 0; n < labels.size(); n++)
+        output[outputOfID[sequenceOfLabel[n]]].add(labels.label(n));
 }
 
 
@@ -71,25 +194,22 @@ void LabelFile::write(const vector<Label*> &labels) const {
 
 
 /**
- * Read labels from LST file.
+ * Read labels from LST file, in a single pass over the mapped file.
  *
- * @param output a vector label pointers that have been read from the file.
+ * @param output the labels that have been read from the file.
  */
-void LabelFile::read_lst(vector<Label*> &output) const {
+void LabelFile::read_lst(LabelSet &output, vector<string> &sequenceIDs, vector<size_t> &sequenceOfLabel) const {
     
     
     output.clear();         // clear output vector (sanity check)
-    Label* currlabel;       // stores single label information
+    sequenceIDs.clear();
+    sequenceOfLabel.clear();
+    
+    string sequenceID;
     
     // point to start of data
     const char* current = begin_read;
     
-    // ignore all lines until we reach "Predicted Genes"
-    gotoKey(current, end_read, "SequenceID");
-
-    
-    bool foundFirstLabel = false;
-    
     // loop over all the file
     while (current != end_read) {
         
@@ -111,109 +231,153 @@ void LabelFile::read_lst(vector<Label*> &output) const {
         if (current == end_read)
             break;
         
-        // read next label
-        currlabel = readNextLabelLST(current, end_read);
+        // a "SequenceID" line starts the labels of a new sequence
+        if (readSequenceID(current, end_read, sequenceID)) {
+            sequenceIDs.push_back(sequenceID);
+            continue;
+        }
         
-        if (currlabel != NULL) {
-            output.push_back(currlabel);
-            foundFirstLabel = true;
+        // all lines until the first "SequenceID" are ignored
+        if (sequenceIDs.empty()) {
+            while (current != end_read && *current != '\n' && *current != '\r')
+                current++;
+            continue;
         }
-//        else if (foundFirstLabel)
-//            throw runtime_error("Could not read label from file.");
+        
+        // read next label
+        if (readNextLabelLST(current, end_read, output))
+            sequenceOfLabel.push_back(sequenceIDs.size() - 1);
     }    
 }
 
 
 
-
-
-
-
-Label* readNextLabelLST(const char*& current, const char* const end) {
-    string output = "";
-    
-    // start of line
-    const char* startOfLine = current;
-    
-    // read the remainder of the line
-    while (current != end && *current != '\n' && *current != '\r')
+// skip spaces and tabs within a line; return true if at least one was skipped
+static bool skipSpacesInLine(const char*& current, const char* const end) {
+    const char* start = current;
+    while (current != end && (*current == ' ' || *current == '\t'))
         current++;
     
-    const char* endOfLine = current;
+    return current != start;
+}
+
+// read an unsigned decimal number; return false if there are no digits
+static bool readNumber(const char*& current, const char* const end, size_t &value) {
+    if (current == end || !isdigit(*current))
+        return false;
     
-    cmatch match;
-    //                                  gene #     strand      left     right    length     class           meta
-    cregex expr = cregex::compile("^\\s*(\\d+)\\s+([+,-])\\s+(<?\\d+)\\s+(>?\\d+)\\s+(\\d+)\\s+(\\S+)(?:\\s+([ACGT]+))?");
+    value = 0;
+    while (current != end && isdigit(*current))
+        value = 10 * value + (*current++ - '0');
     
-    Label* label = NULL;
+    return true;
+}
+
+// read a label from an LST line of the form:
+//      gene#   strand   [<]left   [>]right   length   class   [meta]
+// and add it to the output. On return, current points to the end of the line. Returns false
+// if the line is not a label, or if the gene is incomplete.
+bool readNextLabelLST(const char*& current, const char* const end, LabelSet &output) {
     
-    string t (startOfLine, endOfLine);
+    size_t geneNumber, left, right, length;
+    char strandChar;
+    bool incomplete = false;
+    bool valid = false;
     
-    // parse 'line' for label information
-    if (regex_search(startOfLine, endOfLine, match, expr) && match.size() > 1) {
-        size_t left;
-        size_t right;
-        char strandChar;
-        string geneClass;
-        string meta;
+    // parse each field in order, requiring spaces between them
+    do {
+        if (!readNumber(current, end, geneNumber) || !skipSpacesInLine(current, end))
+            break;
         
-        // skip incomplete genes
-        if (match.str(3).find("<") != string::npos || match.str(4).find(">") != string::npos)
-            return NULL;
+        if (current == end || (*current != '+' && *current != '-' && *current != ','))
+            break;
+        strandChar = *current++;
+        if (!skipSpacesInLine(current, end))
+            break;
         
-        left = (size_t) strtol(match.str(3).c_str(), NULL, 10)-1;
-        right = (size_t) strtol(match.str(4).c_str(), NULL, 10)-1;
-        strandChar = match.str(2)[0];
-        geneClass = match.str(6);
+        if (current != end && *current == '<') {
+            incomplete = true;
+            current++;
+        }
+        if (!readNumber(current, end, left) || !skipSpacesInLine(current, end))
+            break;
         
-        // check if meta exists
-        if (match[7].matched)
-            meta = match.str(7);
+        if (current != end && *current == '>') {
+            incomplete = true;
+            current++;
+        }
+        if (!readNumber(current, end, right) || !skipSpacesInLine(current, end))
+            break;
         
-        Label::strand_t strand;
+        if (!readNumber(current, end, length) || !skipSpacesInLine(current, end))
+            break;
         
-        if (strandChar == '+')
-            strand = Label::POS;
-        else if (strandChar == '-')
-            strand = Label::NEG;
-        else
-            throw invalid_argument("Invalid gene strand: " + match.str(2));
-
-        label = new Label(left, right, strand, geneClass, meta);
-    }
+        // gene class: a word
+        const char* startOfClass = current;
+        while (current != end && !isspace(*current))
+            current++;
+        if (current == startOfClass)
+            break;
+        const char* endOfClass = current;
+        
+        // meta (optional): the nucleotides that start the next word
+        const char* startOfMeta = current;
+        const char* endOfMeta = current;
+        if (skipSpacesInLine(current, end)) {
+            startOfMeta = current;
+            endOfMeta = current;
+            while (endOfMeta != end && (*endOfMeta == 'A' || *endOfMeta == 'C' || *endOfMeta == 'G' || *endOfMeta == 'T'))
+                endOfMeta++;
+        }
+        
+        // skip incomplete genes
+        if (incomplete)
+            break;
+        
+        if (strandChar == ',')
+            throw invalid_argument("Invalid gene strand: ,");
+        
+        output.add(left - 1, right - 1, (strandChar == '+' ? Label::POS : Label::NEG), startOfClass, endOfClass, startOfMeta, endOfMeta);
+        
+        valid = true;
+    } while (false);
     
+    // skip the remainder of the line
+    while (current != end && *current != '\n' && *current != '\r')
+        current++;
     
-    return label;
+    return valid;
 }
 
 
 
-void gotoKey(const char*& current, const char* const end, string key) {
+// read a "SequenceID" line, if current is at the start of one; the ID is the first word after the key
+bool readSequenceID(const char*& current, const char* const end, string &sequenceID) {
     
-    cmatch match;
-    cregex expr = cregex::compile(key);
+    static const char key[] = "SequenceID";
+    const size_t keyLength = sizeof(key) - 1;
     
-    while (current != end) {
-        
-        // skip all new-lines
-        while (current != end && (*current == '\n' || *current == '\r'))
-            current++;
-            
-            
-        // start of line
-        const char* startOfLine = current;
-        
-        // read the remainder of the line
-        while (current != end && *current != '\n' && *current != '\r')
-            current++;
-        
-        const char* endOfLine = current;
-        
-        // check if line matches key
-        if (regex_search(startOfLine, endOfLine, match, expr)) {
-            return;
-        }
-    }
+    if ((size_t) (end - current) < keyLength || strncmp(current, key, keyLength) != 0)
+        return false;
+    
+    current += keyLength;
+    
+    // skip separator (e.g. ':') and spaces on the same line
+    while (current != end && (*current == ':' || *current == ' ' || *current == '\t'))
+        current++;
+    
+    // read ID
+    const char* startOfID = current;
+    while (current != end && !isspace(*current))
+        current++;
+    
+    sequenceID = string(startOfID, current);
+    
+    // skip the remainder of the line
+    while (current != end && *current != '\n' && *current != '\r')
+        current++;
+    
+    return true;
 }
 
 
@@ -231,36 +395,12 @@ LabelFile::format_t LabelFile::detectFormat() const {
 }
 
 
+// the file is in LST format if it contains a "SequenceID" key
 bool LabelFile::detectLST(const char* const begin, const char* const end) const {
     
-    const char* current = begin;
+    static const char key[] = "SequenceID";
     
-    while (current != end) {
-        
-        // skip whitespaces
-        while (current != end && isspace(*current))
-            current++;
-        
-        // start of line
-        const char* startOfLine = current;
-        
-        // read the remainder of the line
-        while (current != end && *current != '\n' && *current != '\r')
-            current++;
-        
-        const char* endOfLine = current;
-        
-        cmatch match;
-        cregex expr = cregex::compile("SequenceID");
-        
-        // check if key found
-        if (regex_search(startOfLine, endOfLine, match, expr)) {
-            return true;
-        }
-    }
-    
-    return false;
-
+    return search(begin, end, key, key + sizeof(key) - 1) != end;
 }
 
 
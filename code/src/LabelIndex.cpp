@@ -0,0 +1,213 @@
+//
+//  LabelIndex.cpp
+//  GeneMark Suite
+//
+
+#include "LabelIndex.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+using namespace std;
+using namespace gmsuite;
+
+const size_t LabelIndex::NO_LABEL;
+
+// table of a strand: Label::POS and Label::NEG have their own, and Label::NONE means any strand
+static size_t strandTable(Label::strand_t strand) {
+    return (strand == Label::POS || strand == Label::NEG ? (size_t) strand : 2);
+}
+
+// orders label indices by left-end (ties by right-end, then by index)
+struct LeftOrder {
+    const vector<size_t> &lefts, &rights;
+    LeftOrder(const vector<size_t> &l, const vector<size_t> &r) : lefts(l), rights(r) {}
+    bool operator() (size_t a, size_t b) const {
+        if (lefts[a] != lefts[b])   return lefts[a] < lefts[b];
+        if (rights[a] != rights[b]) return rights[a] < rights[b];
+        return a < b;
+    }
+};
+
+// orders label indices by right-end (ties by left-end, then by index)
+struct RightOrder {
+    const vector<size_t> &lefts, &rights;
+    RightOrder(const vector<size_t> &l, const vector<size_t> &r) : lefts(l), rights(r) {}
+    bool operator() (size_t a, size_t b) const {
+        if (rights[a] != rights[b]) return rights[a] < rights[b];
+        if (lefts[a] != lefts[b])   return lefts[a] < lefts[b];
+        return a < b;
+    }
+};
+
+
+// Build the index over a list of labels
+LabelIndex::LabelIndex(const vector<Label*> &labels) {
+    
+    lefts.resize(labels.size());
+    rights.resize(labels.size());
+    strands.resize(labels.size());
+    
+    for (size_t n = 0; n < labels.size(); n++) {
+        if (labels[n] == NULL)
+            throw invalid_argument("Label cannot be null");
+        
+        lefts[n] = labels[n]->left;
+        rights[n] = labels[n]->right;
+        strands[n] = labels[n]->strand;
+    }
+    
+    build();
+}
+
+// Build the index over a label set
+LabelIndex::LabelIndex(const LabelSet &labels) {
+    
+    lefts.resize(labels.size());
+    rights.resize(labels.size());
+    strands.resize(labels.size());
+    
+    for (size_t n = 0; n < labels.size(); n++) {
+        lefts[n] = labels.left(n);
+        rights[n] = labels.right(n);
+        strands[n] = labels.strand(n);
+    }
+    
+    build();
+}
+
+
+// Sort the labels and build the prefix/suffix tables
+void LabelIndex::build() {
+    
+    size_t numLabels = lefts.size();
+    
+    // sort by left-end, and keep the label reaching furthest right in each prefix
+    byLeft.resize(numLabels);
+    for (size_t n = 0; n < numLabels; n++)
+        byLeft[n] = n;
+    sort(byLeft.begin(), byLeft.end(), LeftOrder(lefts, rights));
+    
+    sortedLefts.resize(numLabels);
+    for (size_t s = 0; s < 3; s++)
+        rightmostEnd[s].assign(numLabels, NO_LABEL);
+    
+    size_t best[3] = {NO_LABEL, NO_LABEL, NO_LABEL};
+    for (size_t k = 0; k < numLabels; k++) {
+        size_t n = byLeft[k];
+        sortedLefts[k] = lefts[n];
+        
+        // on ties, the later label (i.e. the closer one) wins
+        size_t tables[2] = {strandTable(strands[n]), 2};
+        for (size_t t = 0; t < 2; t++) {
+            size_t &b = best[tables[t]];
+            if (b == NO_LABEL || rights[n] >= rights[b])
+                b = n;
+        }
+        
+        for (size_t s = 0; s < 3; s++)
+            rightmostEnd[s][k] = best[s];
+    }
+    
+    // sort by right-end, and keep the label starting furthest left in each suffix
+    byRight.resize(numLabels);
+    for (size_t n = 0; n < numLabels; n++)
+        byRight[n] = n;
+    sort(byRight.begin(), byRight.end(), RightOrder(lefts, rights));
+    
+    sortedRights.resize(numLabels);
+    for (size_t s = 0; s < 3; s++)
+        leftmostStart[s].assign(numLabels, NO_LABEL);
+    
+    best[0] = best[1] = best[2] = NO_LABEL;
+    for (size_t k = numLabels; k-- > 0; ) {
+        size_t n = byRight[k];
+        sortedRights[k] = rights[n];
+        
+        // on ties, the earlier label (i.e. the closer one) wins
+        size_t tables[2] = {strandTable(strands[n]), 2};
+        for (size_t t = 0; t < 2; t++) {
+            size_t &b = best[tables[t]];
+            if (b == NO_LABEL || lefts[n] <= lefts[b])
+                b = n;
+        }
+        
+        for (size_t s = 0; s < 3; s++)
+            leftmostStart[s][k] = best[s];
+    }
+}
+
+
+size_t LabelIndex::size() const {
+    return lefts.size();
+}
+
+size_t LabelIndex::left(size_t n) const {
+    return lefts[n];
+}
+
+size_t LabelIndex::right(size_t n) const {
+    return rights[n];
+}
+
+Label::strand_t LabelIndex::strand(size_t n) const {
+    return strands[n];
+}
+
+size_t LabelIndex::sortedByLeft(size_t k) const {
+    return byLeft[k];
+}
+
+
+// Label with the largest right-end, among labels with left-end less than position
+size_t LabelIndex::closestEndBefore(size_t position, Label::strand_t strand) const {
+    
+    size_t numBefore = lower_bound(sortedLefts.begin(), sortedLefts.end(), position) - sortedLefts.begin();
+    if (numBefore == 0)
+        return NO_LABEL;
+    
+    return rightmostEnd[strandTable(strand)][numBefore - 1];
+}
+
+// Label with the smallest left-end, among labels with right-end greater than position
+size_t LabelIndex::closestStartAfter(size_t position, Label::strand_t strand) const {
+    
+    size_t firstAfter = upper_bound(sortedRights.begin(), sortedRights.end(), position) - sortedRights.begin();
+    if (firstAfter == sortedRights.size())
+        return NO_LABEL;
+    
+    return leftmostStart[strandTable(strand)][firstAfter];
+}
+
+// Nearest label upstream of label n
+size_t LabelIndex::upstreamNeighbor(size_t n, Label::strand_t strand) const {
+    
+    if (strands[n] == Label::NEG)
+        return closestStartAfter(rights[n], strand);
+    else
+        return closestEndBefore(lefts[n], strand);
+}
+
+// Length of the region upstream of label n that is free of other labels
+size_t LabelIndex::freeUpstreamLength(size_t n, size_t sequenceLength) const {
+    
+    size_t neighbor = upstreamNeighbor(n);
+    
+    // negative strand: free region lies between the label's right-end and the next label's start
+    if (strands[n] == Label::NEG) {
+        size_t boundary = (neighbor == NO_LABEL ? sequenceLength : lefts[neighbor]);
+        return (boundary > rights[n] + 1 ? boundary - rights[n] - 1 : 0);
+    }
+    // positive strand: free region lies between the previous label's end and the label's left-end
+    else {
+        size_t boundary = (neighbor == NO_LABEL ? 0 : rights[neighbor] + 1);
+        return (lefts[n] > boundary ? lefts[n] - boundary : 0);
+    }
+}
+
+// Check whether any label overlaps a region
+bool LabelIndex::overlapsLabel(size_t left, size_t right) const {
+    
+    size_t neighbor = closestEndBefore(right + 1);
+    return (neighbor != NO_LABEL && rights[neighbor] >= left);
+}
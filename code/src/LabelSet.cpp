@@ -0,0 +1,187 @@
+//
+//  LabelSet.cpp
+//  GeneMark Suite
+//
+
+#include "LabelSet.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <string.h>
+
+using namespace std;
+using namespace gmsuite;
+
+// Create an empty label set
+LabelSet::LabelSet() {
+    
+}
+
+// Add a label to the end of the set
+void LabelSet::add(size_t left, size_t right, Label::strand_t strand, const char* classBegin, const char* classEnd,
+                   const char* metaBegin, const char* metaEnd) {
+    
+    // check everything before adding anything, so that a rejected label leaves the set unchanged
+    if (left > numeric_limits<coord_t>::max() || right > numeric_limits<coord_t>::max())
+        throw invalid_argument("Label coordinate is too large");
+    
+    if (metaArena.size() + (metaEnd - metaBegin) > numeric_limits<coord_t>::max())
+        throw invalid_argument("Label meta information is too large");
+    
+    class_t geneClass = internClass(classBegin, classEnd);
+    
+    lefts.push_back((coord_t) left);
+    rights.push_back((coord_t) right);
+    strands.push_back((unsigned char) strand);
+    classes.push_back(geneClass);
+    
+    metaArena.append(metaBegin, metaEnd);
+    metaEnds.push_back((coord_t) metaArena.size());
+}
+
+// Add a label to the end of the set
+void LabelSet::add(const Label &label) {
+    const char* geneClass = label.geneClass.c_str();
+    const char* meta = label.meta.c_str();
+    add(label.left, label.right, label.strand, geneClass, geneClass + label.geneClass.size(), meta, meta + label.meta.size());
+}
+
+// Get the ID of a gene class, interning its name if it's new
+LabelSet::class_t LabelSet::internClass(const char* begin, const char* end) {
+    
+    size_t length = end - begin;
+    
+    // few classes exist (e.g. native, atypical), so search them linearly
+    for (size_t c = 0; c < classNames.size(); c++) {
+        if (classNames[c].size() == length && memcmp(classNames[c].data(), begin, length) == 0)
+            return (class_t) c;
+    }
+    
+    if (classNames.size() > numeric_limits<class_t>::max())
+        throw invalid_argument("Too many gene classes");
+    
+    classNames.push_back(string(begin, end));
+    return (class_t) (classNames.size() - 1);
+}
+
+
+size_t LabelSet::size() const {
+    return lefts.size();
+}
+
+bool LabelSet::empty() const {
+    return lefts.empty();
+}
+
+void LabelSet::reserve(size_t numLabels) {
+    lefts.reserve(numLabels);
+    rights.reserve(numLabels);
+    strands.reserve(numLabels);
+    classes.reserve(numLabels);
+    metaEnds.reserve(numLabels);
+}
+
+void LabelSet::clear() {
+    lefts.clear();
+    rights.clear();
+    strands.clear();
+    classes.clear();
+    metaEnds.clear();
+    metaArena.clear();
+    classNames.clear();
+}
+
+
+LabelSet::coord_t LabelSet::left(size_t n) const {
+    return lefts[n];
+}
+
+LabelSet::coord_t LabelSet::right(size_t n) const {
+    return rights[n];
+}
+
+Label::strand_t LabelSet::strand(size_t n) const {
+    return (Label::strand_t) strands[n];
+}
+
+LabelSet::class_t LabelSet::geneClass(size_t n) const {
+    return classes[n];
+}
+
+string LabelSet::meta(size_t n) const {
+    size_t begin = (n == 0 ? 0 : metaEnds[n-1]);
+    return metaArena.substr(begin, metaEnds[n] - begin);
+}
+
+size_t LabelSet::numClasses() const {
+    return classNames.size();
+}
+
+const string& LabelSet::className(class_t geneClass) const {
+    return classNames[geneClass];
+}
+
+
+// Create a Label object for a label in the set
+Label LabelSet::label(size_t n) const {
+    return Label(lefts[n], rights[n], strand(n), classNames[classes[n]], meta(n));
+}
+
+// Create Label objects for all labels in the set
+void LabelSet::toLabels(vector<Label> &output) const {
+    output.clear();
+    output.reserve(size());
+    for (size_t n = 0; n < size(); n++)
+        output.push_back(label(n));
+}
+
+
+// Mark the labels whose gene class name contains a given text
+void LabelSet::markClassContaining(const string &text, vector<bool> &marked) const {
+    
+    // decide once per class, then look up each label's class
+    vector<unsigned char> classContains (classNames.size());
+    for (size_t c = 0; c < classNames.size(); c++)
+        classContains[c] = (classNames[c].find(text) != string::npos);
+    
+    marked.resize(size());
+    for (size_t n = 0; n < classes.size(); n++)
+        marked[n] = classContains[classes[n]];
+}
+
+
+// Remove labels that are shorter than a minimum length
+void LabelSet::removeShorterThan(size_t minimumLength) {
+    
+    size_t kept = 0;
+    size_t metaKept = 0;
+    size_t metaBegin = 0;
+    
+    for (size_t n = 0; n < lefts.size(); n++) {
+        size_t metaEnd = metaEnds[n];
+        
+        if ((size_t) (rights[n] - lefts[n]) + 1 >= minimumLength) {
+            lefts[kept] = lefts[n];
+            rights[kept] = rights[n];
+            strands[kept] = strands[n];
+            classes[kept] = classes[n];
+            
+            // move meta down the arena (kept meta never lies after the current one)
+            copy(metaArena.begin() + metaBegin, metaArena.begin() + metaEnd, metaArena.begin() + metaKept);
+            metaKept += metaEnd - metaBegin;
+            metaEnds[kept] = (coord_t) metaKept;
+            
+            kept++;
+        }
+        
+        metaBegin = metaEnd;
+    }
+    
+    lefts.resize(kept);
+    rights.resize(kept);
+    strands.resize(kept);
+    classes.resize(kept);
+    metaEnds.resize(kept);
+    metaArena.resize(metaKept);
+}
@@ -13,74 +13,54 @@ using namespace gmsuite;
 void LabelsParser::partitionBasedOnOperonStatus(const vector<Label*> &labels, size_t fgioThresh, size_t nfgioThresh,
                                                 vector<operon_status_t> &status) {
     
+    partitionBasedOnOperonStatus(LabelIndex(labels), fgioThresh, nfgioThresh, status);
+}
+
+
+void LabelsParser::partitionBasedOnOperonStatus(const LabelSet &labels, size_t fgioThresh, size_t nfgioThresh,
+                                                vector<operon_status_t> &status) {
     
-    status.resize(labels.size(), AMBIG);            // allocate space, and set all as initially ambiguous
+    partitionBasedOnOperonStatus(LabelIndex(labels), fgioThresh, nfgioThresh, status);
+}
+
+
+// Partition labels by comparing each to its nearest upstream gene
+void LabelsParser::partitionBasedOnOperonStatus(const LabelIndex &index, size_t fgioThresh, size_t nfgioThresh,
+                                                vector<operon_status_t> &status) {
     
+    status.assign(index.size(), AMBIG);             // allocate space, and set all as initially ambiguous
     
     // loop over all labels
-    for (size_t n = 0; n < labels.size(); n++) {
+    for (size_t n = 0; n < index.size(); n++) {
+        
+        size_t prev = index.upstreamNeighbor(n);    // nearest upstream gene
         
-        Label* currLab = labels[n];         // current label
+        // if first gene in genome (from its strand's direction), or previous gene on opposite strand, set as fgio
+        if (prev == LabelIndex::NO_LABEL || index.strand(prev) != index.strand(n)) {
+            status[n] = FGIO;
+            continue;
+        }
         
-        // If current gene on positive strand
-        if (currLab->strand == Label::POS) {
-            
-            // if first gene, set as fgio
-            if (n == 0)
-                status[n] = FGIO;
-            
-            // if not first gene in genome
-            else {
-                Label* prevLab = labels[n-1];
-                
-                // if previous gene is on negative strand, then this is a fgio
-                if (prevLab->strand == Label::NEG)
-                    status[n] = FGIO;
-                
-                // otherwise previous gene is on positive strand: check distance
-                else {
-                    // if genes overlapping, then set as nfgio
-                    if (prevLab->right > currLab->left)
-                        status[n] = NFGIO;
-                    // if genes not overlapping but too close, set as nfgio
-                    else if (currLab->left - prevLab->right < nfgioThresh)
-                        status[n] = NFGIO;
-                    // if distance is "too far" then fgio
-                    else if (currLab->left - prevLab->right > fgioThresh)
-                        status[n] = FGIO;
-                }
-            }
-            
+        // distance between the end of the previous gene and the start of the current one
+        size_t currStart, prevEnd;
+        if (index.strand(n) == Label::NEG) {
+            currStart = index.right(n);
+            prevEnd = index.left(prev);
         }
-        // If current gene on negative strand
         else {
-            
-            // if "first gene in genome" from right, then set as fgio
-            if (n == labels.size() - 1)
-                status[n] = FGIO;
-            
-            // if not first gene in genome
-            else {
-                Label* prevLab = labels[n+1];
-                
-                // if previous gene is on positive strand, then this is a fgio
-                if (prevLab->strand == Label::POS)
-                    status[n] = FGIO;
-                
-                // otherwise, previous gene is on negative strand; check distance
-                else {
-                    // if genes overlapping, then set as nfgio
-                    if (prevLab->left < currLab->right)
-                        status[n] = NFGIO;
-                    // if genes not overlapping but too close, set as nfgio
-                    else if (prevLab->left - currLab->right < nfgioThresh)
-                        status[n] = NFGIO;
-                    // if distance is too far, then fgio
-                    else if (prevLab->left - currLab->right > fgioThresh)
-                        status[n] = FGIO;
-                }
-            }
+            currStart = index.left(n);
+            prevEnd = index.right(prev);
         }
+        
+        bool overlapping = (index.strand(n) == Label::NEG ? prevEnd < currStart : prevEnd > currStart);
+        size_t distance = (index.strand(n) == Label::NEG ? prevEnd - currStart : currStart - prevEnd);
+        
+        // if genes overlapping, or not overlapping but too close, then set as nfgio
+        if (overlapping || distance < nfgioThresh)
+            status[n] = NFGIO;
+        // if distance is "too far" then fgio
+        else if (distance > fgioThresh)
+            status[n] = FGIO;
     }
 }
 
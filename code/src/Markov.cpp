@@ -134,7 +134,7 @@ void Markov::getLowerOrderJoint(unsigned currentOrder, const vector<double> &cur
         throw std::logic_error("Current.size() should be divisible by blockSize.");
 
     // Compute the marginal probabilities (i.e. P(X1,...,Xn-1) = sum_{x} P(X1,...,Xn-1,xn))
-    result.resize(numOfBlocks,0);
+    result.assign(numOfBlocks,0);
     
     // compute one marginal for every block
     for (size_t b = 0; b < numOfBlocks; b++) {
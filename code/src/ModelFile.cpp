@@ -10,22 +10,145 @@
 #include "ModelFile.hpp"
 
 #include <stdexcept>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <string.h>
+#include <stdlib.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <boost/cstdint.hpp>
 
 using namespace std;
 using namespace gmsuite;
 
 
-string readNextKey(const char*& current, const char* const end);
-string readNextValue(const char*& current, const char* const end);
+// Binary model image (all offsets are from the start of the image, and values are in native byte order):
+//   header:     image_header_t
+//   directory:  one image_entry_t per key-value pair, in file order
+//   strings:    section header, then the key and text value of each pair
+//   numbers:    numeric values as doubles, starting at an 8-byte boundary
+// The checksum covers everything after the header.
+
+#define IMAGE_MAGIC "GMS2MODB"
+#define IMAGE_MAGIC_LENGTH 8
+#define IMAGE_VERSION 1
+#define IMAGE_BYTE_ORDER 0x01020304
+
+typedef struct {
+    char magic[IMAGE_MAGIC_LENGTH];
+    boost::uint32_t version;
+    boost::uint32_t byteOrder;              // IMAGE_BYTE_ORDER, as written by the producing machine
+    boost::uint64_t size;                   // size of the whole image
+    boost::uint64_t checksum;
+    boost::uint64_t numEntries;
+    boost::uint64_t headerOffset;           // section header
+    boost::uint64_t headerLength;
+} image_header_t;
+
+typedef struct {
+    boost::uint64_t keyOffset;
+    boost::uint64_t valueOffset;
+    boost::uint64_t numbersOffset;          // 0 if the value is not numeric
+    boost::uint32_t keyLength;
+    boost::uint32_t valueLength;
+    boost::uint32_t rows;
+    boost::uint32_t cols;
+} image_entry_t;
+
+
+// 64-bit FNV-1a hash of the image's contents
+static boost::uint64_t imageChecksum(const char* begin, const char* end) {
+    boost::uint64_t hash = 14695981039346656037ULL;
+    for (const char* current = begin; current != end; current++) {
+        hash ^= (unsigned char) *current;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Parse a value as numbers: a single number, or lines that each hold a label followed by the same number of numbers
+// (a single line that starts with a number is ambiguous, and is not parsed: see numbersForKey)
+static bool parseNumbers(const string &value, vector<double> &numbers, size_t &rows, size_t &cols) {
+    
+    numbers.clear();
+    rows = cols = 0;
+    
+    const char* current = value.c_str();
+    const char* end = current + value.size();
+    char* numberEnd;
+    
+    // a single number
+    double number = strtod(current, &numberEnd);
+    if (numberEnd != current && numberEnd == end) {
+        numbers.push_back(number);
+        rows = cols = 1;
+        return true;
+    }
+    
+    // a single line that starts with a number (e.g. "1 2 3") could be a list of numbers, or a row
+    // labelled by a number (e.g. a one-entry distribution written on its key's line)
+    if (find(current, end, '\n') == end) {
+        strtod(current, &numberEnd);
+        if (numberEnd != current && (numberEnd == end || isspace(*numberEnd)))
+            return false;
+    }
+    
+    // a table, line by line
+    while (current != end) {
+        const char* lineEnd = find(current, end, '\n');
+        
+        // skip blank lines, then the label
+        const char* element = current;
+        while (element != lineEnd && isspace(*element))
+            element++;
+        if (element == lineEnd) {
+            current = (lineEnd == end ? end : lineEnd + 1);
+            continue;
+        }
+        while (element != lineEnd && !isspace(*element))
+            element++;
+        
+        size_t lineCols = 0;
+        while (true) {
+            while (element != lineEnd && isspace(*element))
+                element++;
+            if (element == lineEnd)
+                break;
+            
+            number = strtod(element, &numberEnd);
+            if (numberEnd == element || (numberEnd != lineEnd && !isspace(*numberEnd))) {
+                numbers.clear();
+                rows = cols = 0;
+                return false;
+            }
+            
+            numbers.push_back(number);
+            lineCols++;
+            element = numberEnd;
+        }
+        
+        // every row needs the same (non-zero) number of columns
+        if (lineCols == 0 || (rows > 0 && lineCols != cols)) {
+            numbers.clear();
+            rows = cols = 0;
+            return false;
+        }
+        
+        cols = lineCols;
+        rows++;
+        current = (lineEnd == end ? end : lineEnd + 1);
+    }
+    
+    return rows > 0;
+}
+
 
 // constructor
 ModelFile::ModelFile(string path, access_t access) {
     this->path = path;
     this->access = access;
+    this->binary = false;
     
     // setup file parameters
     params.path = path;
@@ -47,123 +170,165 @@ ModelFile::~ModelFile() {
 void ModelFile::read(map<string, string> &output) const {
     output.clear();           // clear output map (sanity check)
     
-    // point to start of data
-    const char* current = begin_read;
+    // add key-value pairs in file order (note, value can be empty, but key should not be)
+    for (size_t n = 0; n < entries.size(); n++) {
+        const entry_t &entry = entries[n];
+        output[string(entry.keyBegin, entry.keyEnd)] = string(entry.valueBegin, entry.valueEnd);
+    }
+}
+
+
+void ModelFile::read(vector<pair<string, string> > &output) const {
+    output.clear();
+    output.reserve(entries.size());
     
-    string key = "";
-    string value = "";
+    for (size_t n = 0; n < entries.size(); n++) {
+        const entry_t &entry = entries[n];
+        output.push_back(pair<string, string>(string(entry.keyBegin, entry.keyEnd), string(entry.valueBegin, entry.valueEnd)));
+    }
+}
+
+
+void ModelFile::read(map<string, string> &output, const vector<string> &keys) const {
     
-    // loop over file
-    while (current != end_read) {
-        
-        // read next key
-        key = readNextKey(current, end_read);
-        boost::trim(key);
-        
-        // no key found (i.e. should have read the end
-        if (key.empty())
-            continue;
-        
-        // read next value, which consists of all characters up
-        // until the next key
-        value = readNextValue(current, end_read);
-        boost::trim(value);
+    // add key-value pairs in file order, for keys in the query
+    for (size_t n = 0; n < entries.size(); n++) {
+        const entry_t &entry = entries[n];
+        string key (entry.keyBegin, entry.keyEnd);
         
-        // add key-value pair to map (note, value can be empty, but key should not be)
-        output[key] = value;
+        if (find(keys.begin(), keys.end(), key) != keys.end())
+            output[key] = string(entry.valueBegin, entry.valueEnd);
     }
 }
 
 
-void ModelFile::read(map<string, string> &output, const vector<string> &keys) const {
+// Scan the mapped file once, and index all of its key-value pairs
+void ModelFile::buildIndex() {
+    
+    entries.clear();
+    keyIndex.clear();
+    sectionHeader.clear();
     
     const char* current = begin_read;
     
-    string key = "";
-    string value = "";
+    // section header (e.g. __NATIVE) precedes the first key
+    while (current != end_read && isspace(*current))
+        current++;
+    if (end_read - current >= 2 && current[0] == '_' && current[1] == '_') {
+        const char* headerBegin = current + 2;
+        current = headerBegin;
+        while (current != end_read && !isspace(*current) && *current != '$')
+            current++;
+        sectionHeader.assign(headerBegin, current);
+    }
     
     // loop over file
     while (current != end_read) {
         
-        // read next key
-        key = readNextKey(current, end_read);
-        boost::trim(key);
+        // read until next $ sign
+        while (current != end_read && *current != '$')
+            current++;
         
-        // no key found (i.e. should have read the end
-        if (key.empty())
-            continue;
+        // if reached end of file, there are no more keys
+        if (current == end_read)
+            break;
+        
+        current++;      // skip $
         
-        // check if key is NOT in the query
-        if (find(keys.begin(), keys.end(), key) == keys.end())
+        // key runs up to the next whitespace character
+        entry_t entry;
+        entry.numbers = NULL;
+        entry.rows = entry.cols = 0;
+        entry.keyBegin = current;
+        while (current != end_read && !isspace(*current))
+            current++;
+        entry.keyEnd = current;
+        
+        // no key found (e.g. a lone $)
+        if (entry.keyBegin == entry.keyEnd)
             continue;
         
-        // read next value, which consists of all characters up
-        // until the next key
-        value = readNextValue(current, end_read);
-        boost::trim(value);
+        // value consists of all characters up until the next key, without surrounding whitespace
+        while (current != end_read && isspace(*current))
+            current++;
+        entry.valueBegin = current;
+        while (current != end_read && *current != '$')
+            current++;
+        entry.valueEnd = current;
+        while (entry.valueEnd != entry.valueBegin && isspace(*(entry.valueEnd-1)))
+            entry.valueEnd--;
         
-        // add key-value pair to map (note, value can be empty, but key should not be)
-        output[key] = value;
+        entries.push_back(entry);
+        keyIndex.insert(make_pair(string(entry.keyBegin, entry.keyEnd), entries.size()-1));     // keeps the first occurrence
     }
 }
 
 
-
-string readNextKey(const char*& current, const char* const end) {
+// Check the mapped binary image, and index its key-value pairs from its directory
+void ModelFile::buildIndexFromImage() {
     
-    string key = "";
+    entries.clear();
+    keyIndex.clear();
+    sectionHeader.clear();
     
-    // read until next $ sign
-    while (current != end && *current != '$')
-        current++;
+    size_t size = end_read - begin_read;
+    if (size < sizeof(image_header_t))
+        throw invalid_argument("Model image is truncated: " + params.path);
     
-    // if reached end of file, return empty key
-    if (current == end)
-        return key;
+    image_header_t header;
+    memcpy(&header, begin_read, sizeof(header));
     
-    // otherwise, current is now at $, so read next keyword
+    if (header.version != IMAGE_VERSION)
+        throw invalid_argument("Unsupported model image version: " + params.path);
+    if (header.byteOrder != IMAGE_BYTE_ORDER)
+        throw invalid_argument("Model image was written with a different byte order: " + params.path);
+    if (header.size != size)
+        throw invalid_argument("Model image is truncated: " + params.path);
+    if (header.checksum != imageChecksum(begin_read + sizeof(header), end_read))
+        throw invalid_argument("Model image is corrupted: " + params.path);
     
-    current++;      // skip $
+    // directory and strings must lie within the image
+    if (header.numEntries > (size - sizeof(header)) / sizeof(image_entry_t))
+        throw invalid_argument("Model image is corrupted: " + params.path);
+    if (header.headerOffset > size || header.headerLength > size - header.headerOffset)
+        throw invalid_argument("Model image is corrupted: " + params.path);
     
-    const char* startOfKey = current;
-    while (current != end && !isspace(*current))        // loop until next whitespace character
-        current++;
+    sectionHeader.assign(begin_read + header.headerOffset, header.headerLength);
     
-    const char *endOfKey = current;
+    const char* directory = begin_read + sizeof(header);
+    entries.reserve(header.numEntries);
     
-    key = string(startOfKey, endOfKey);
-    return key;
-}
-
-
-string readNextValue(const char*& current, const char* const end) {
-    string value = "";
-    
-    // skip all whitespace characters
-    while (current != end && isspace(*current))
-        current++;
-    
-    // if reached end of file, or reached next key, return empty value
-    if (current == end || *current == '$')
-        return value;
-    
-    // otherwise, current is now at start of value, so read up until next key
-    
-    const char* startOfValue = current;
-    while (current != end && *current != '$')        // loop until next key
-        current++;
-    
-    const char *endOfValue = current;
-    
-    value = string(startOfValue, endOfValue);
-    return value;
-
+    for (size_t n = 0; n < header.numEntries; n++) {
+        image_entry_t imageEntry;
+        memcpy(&imageEntry, directory + n * sizeof(imageEntry), sizeof(imageEntry));
+        
+        size_t numbersLength = (size_t) imageEntry.rows * imageEntry.cols * sizeof(double);
+        if (imageEntry.keyOffset > size || imageEntry.keyLength > size - imageEntry.keyOffset
+            || imageEntry.valueOffset > size || imageEntry.valueLength > size - imageEntry.valueOffset
+            || imageEntry.numbersOffset > size || numbersLength > size - imageEntry.numbersOffset
+            || imageEntry.numbersOffset % sizeof(double) != 0)
+            throw invalid_argument("Model image is corrupted: " + params.path);
+        
+        entry_t entry;
+        entry.keyBegin = begin_read + imageEntry.keyOffset;
+        entry.keyEnd = entry.keyBegin + imageEntry.keyLength;
+        entry.valueBegin = begin_read + imageEntry.valueOffset;
+        entry.valueEnd = entry.valueBegin + imageEntry.valueLength;
+        entry.rows = imageEntry.rows;
+        entry.cols = imageEntry.cols;
+        
+        // mapped images start on a page boundary, so aligned offsets give aligned doubles
+        if (imageEntry.numbersOffset == 0)
+            entry.numbers = NULL;
+        else
+            entry.numbers = reinterpret_cast<const double*>(begin_read + imageEntry.numbersOffset);
+        
+        entries.push_back(entry);
+        keyIndex.insert(make_pair(string(entry.keyBegin, entry.keyEnd), entries.size()-1));     // keeps the first occurrence
+    }
 }
 
 
-
-
-
 /**
  * Read single value from file, for a given key
  *
@@ -172,36 +337,20 @@ string readNextValue(const char*& current, const char* const end) {
  */
 string ModelFile::readValueForKey(string key) const {
     
+    boost::string_ref value = valueViewForKey(key);
+    return string(value.begin(), value.end());
+}
+
+
+// Get a view of the value of a given key, directly in the mapped file
+boost::string_ref ModelFile::valueViewForKey(const string &key) const {
     
-    // point to start of data
-    const char* current = begin_read;
-    
-    string currKey = "";
-    string value = "";
+    boost::unordered_map<string, size_t>::const_iterator found = keyIndex.find(key);
+    if (found == keyIndex.end())
+        throw invalid_argument("Key not found: " + key);
     
-    // loop over file
-    while (current != end_read) {
-        
-        // read next key
-        currKey = readNextKey(current, end_read);
-        boost::trim(currKey);
-        
-        // no key found (i.e. should have read the end
-        if (currKey.empty())
-            continue;
-        
-        // if key found, read value
-        if (currKey == key) {
-        
-            // read next value, which consists of all characters up
-            // until the next key
-            value = readNextValue(current, end_read);
-            boost::trim(value);
-            return value;
-        }
-    }
-    
-    throw invalid_argument("Key not found: " + key);
+    const entry_t &entry = entries[found->second];
+    return boost::string_ref(entry.valueBegin, entry.valueEnd - entry.valueBegin);
 }
 
 
@@ -211,24 +360,30 @@ string ModelFile::readValueForKey(string key) const {
 bool ModelFile::keyExists(string key) const {
     
     boost::trim(key);
+    return keyIndex.find(key) != keyIndex.end();
+}
+
+
+// Get the numeric form of the value of a given key, directly in the mapped image
+const double* ModelFile::numbersForKey(const string &key, size_t &rows, size_t &cols) const {
     
-    // point to start of data
-    const char* current = begin_read;
-    
-    string currKey = "";
-    
-    // loop over file
-    while (current != end_read) {
-        
-        // read next key
-        currKey = readNextKey(current, end_read);
-        boost::trim(currKey);
-        
-        if (key == currKey)
-            return true;
-    }
+    boost::unordered_map<string, size_t>::const_iterator found = keyIndex.find(key);
+    if (found == keyIndex.end())
+        throw invalid_argument("Key not found: " + key);
     
-    return false;
+    const entry_t &entry = entries[found->second];
+    rows = entry.rows;
+    cols = entry.cols;
+    return entry.numbers;
+}
+
+
+bool ModelFile::isBinary() const {
+    return binary;
+}
+
+string ModelFile::getSectionHeader() const {
+    return sectionHeader;
 }
 
 
@@ -265,6 +420,90 @@ void ModelFile::write(const vector<pair<string, string> > &keyValue, string sect
 }
 
 
+/**
+ * Write model parameters to file as a binary model image.
+ */
+void ModelFile::writeBinary(const vector<pair<string, string> > &keyValue, string sectionHeader) {
+    
+    size_t numEntries = keyValue.size();
+    
+    // trim values as in write(), and parse the numeric ones
+    vector<string> values (numEntries);
+    vector<vector<double> > numbers (numEntries);
+    vector<size_t> rows (numEntries), cols (numEntries);
+    
+    for (size_t n = 0; n < numEntries; n++) {
+        values[n] = keyValue[n].second;
+        boost::trim(values[n]);
+        parseNumbers(values[n], numbers[n], rows[n], cols[n]);
+        
+        if (keyValue[n].first.size() > 0xFFFFFFFF || values[n].size() > 0xFFFFFFFF || rows[n] > 0xFFFFFFFF || cols[n] > 0xFFFFFFFF)
+            throw invalid_argument("Value is too large for a model image: " + keyValue[n].first);
+    }
+    
+    // lay out the image: header, directory, strings, then numbers
+    size_t size = sizeof(image_header_t) + numEntries * sizeof(image_entry_t) + sectionHeader.size();
+    for (size_t n = 0; n < numEntries; n++)
+        size += keyValue[n].first.size() + values[n].size();
+    
+    size_t numbersOffset = (size + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+    size = numbersOffset;
+    for (size_t n = 0; n < numEntries; n++)
+        size += numbers[n].size() * sizeof(double);
+    
+    vector<char> image (size, 0);
+    
+    image_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IMAGE_MAGIC, IMAGE_MAGIC_LENGTH);
+    header.version = IMAGE_VERSION;
+    header.byteOrder = IMAGE_BYTE_ORDER;
+    header.size = size;
+    header.numEntries = numEntries;
+    
+    size_t stringsOffset = sizeof(image_header_t) + numEntries * sizeof(image_entry_t);
+    header.headerOffset = stringsOffset;
+    header.headerLength = sectionHeader.size();
+    memcpy(&image[0] + stringsOffset, sectionHeader.data(), sectionHeader.size());
+    stringsOffset += sectionHeader.size();
+    
+    for (size_t n = 0; n < numEntries; n++) {
+        const string &key = keyValue[n].first;
+        
+        image_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        
+        entry.keyOffset = stringsOffset;
+        entry.keyLength = (boost::uint32_t) key.size();
+        memcpy(&image[0] + stringsOffset, key.data(), key.size());
+        stringsOffset += key.size();
+        
+        entry.valueOffset = stringsOffset;
+        entry.valueLength = (boost::uint32_t) values[n].size();
+        memcpy(&image[0] + stringsOffset, values[n].data(), values[n].size());
+        stringsOffset += values[n].size();
+        
+        if (!numbers[n].empty()) {
+            entry.numbersOffset = numbersOffset;
+            entry.rows = (boost::uint32_t) rows[n];
+            entry.cols = (boost::uint32_t) cols[n];
+            memcpy(&image[0] + numbersOffset, &numbers[n][0], numbers[n].size() * sizeof(double));
+            numbersOffset += numbers[n].size() * sizeof(double);
+        }
+        
+        memcpy(&image[0] + sizeof(image_header_t) + n * sizeof(image_entry_t), &entry, sizeof(entry));
+    }
+    
+    header.checksum = imageChecksum(&image[0] + sizeof(image_header_t), &image[0] + size);
+    memcpy(&image[0], &header, sizeof(header));
+    
+    ofstream out;
+    out.open(params.path.c_str(), ios::out | ios::binary);
+    out.write(&image[0], size);
+    out.close();
+}
+
+
 
 
 /**
@@ -281,6 +520,13 @@ void ModelFile::openFile() {
         mfile.open(params);
         begin_read = mfile.const_data();
         end_read = begin_read + mfile.size();
+        
+        // binary images start with their magic string; anything else is a text file
+        binary = (mfile.size() >= IMAGE_MAGIC_LENGTH && memcmp(begin_read, IMAGE_MAGIC, IMAGE_MAGIC_LENGTH) == 0);
+        if (binary)
+            buildIndexFromImage();
+        else
+            buildIndex();
     }
     else if (access == WRITE) {
         begin_write = mfile.data();
@@ -294,6 +540,12 @@ void ModelFile::openFile() {
 void ModelFile::closeFile() {
     if (mfile.is_open())
         mfile.close();
+    
+    // the index points into the mapped file
+    entries.clear();
+    keyIndex.clear();
+    binary = false;
+    sectionHeader.clear();
 }
 
 
@@ -0,0 +1,286 @@
+//
+//  ModelWriter.cpp
+//  GeneMark Suite
+//
+
+#include "ModelWriter.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <math.h>
+#include <boost/algorithm/string.hpp>
+
+using namespace std;
+using namespace gmsuite;
+
+#define MODEL_WRITER_BUFFER_SIZE (1 << 16)
+
+// Open a model file for writing
+ModelWriter::ModelWriter(string path, string sectionHeader) {
+    
+    out.open(path.c_str(), ios::out | ios::binary);
+    if (!out.is_open())
+        throw invalid_argument("Could not open model file for writing: " + path);
+    
+    buffer.reserve(2 * MODEL_WRITER_BUFFER_SIZE);
+    inTable = false;
+    skipTable = false;
+    tablePrecision = 6;
+    numRows = 0;
+    
+    if (!sectionHeader.empty())
+        buffer += "__" + sectionHeader + "\n";
+}
+
+// Destructor
+ModelWriter::~ModelWriter() {
+    if (out.is_open())
+        close();
+}
+
+
+void ModelWriter::setOverrides(const boost::unordered_map<string, string> &overrides) {
+    this->overrides = overrides;
+    overridden.clear();
+}
+
+
+// Write a key's override if it has one
+bool ModelWriter::writeOverride(const string &key) {
+    
+    boost::unordered_map<string, string>::const_iterator found = overrides.find(key);
+    if (found == overrides.end())
+        return false;
+    
+    writeKeyValue(key, found->second);
+    overridden[key] = true;
+    return true;
+}
+
+
+// Write a key-value pair as is, in the same layout as ModelFile::write
+void ModelWriter::writeKeyValue(const string &key, const string &value) {
+    
+    string trimmed = boost::trim_copy(value);
+    
+    buffer += "$";
+    buffer += key;
+    
+    // if value doesn't contain new line, print it in the same line as the key
+    if (trimmed.find('\n') == string::npos) {
+        buffer += " ";
+        buffer += trimmed;
+        buffer += "\n";
+    }
+    // otherwise, start the value on a new line
+    else {
+        buffer += "\n";
+        buffer += trimmed;
+        buffer += "\n\n";
+    }
+    
+    flush();
+}
+
+
+void ModelWriter::write(const string &key, const string &value) {
+    if (!writeOverride(key))
+        writeKeyValue(key, value);
+}
+
+
+void ModelWriter::writeFixed(const string &key, double value, int precision) {
+    if (writeOverride(key))
+        return;
+    
+    buffer += "$";
+    buffer += key;
+    buffer += " ";
+    appendFixed(buffer, value, precision);
+    buffer += "\n";
+    
+    flush();
+}
+
+
+void ModelWriter::write(const string &key, const Markov &model) {
+    model.writeTable(*this, key);
+}
+
+
+void ModelWriter::write(const string &key, const UnivariatePDF &pdf) {
+    beginTable(key);
+    
+    char label[32];
+    for (size_t n = 0; n < pdf.size(); n++) {
+        snprintf(label, sizeof(label), "%lu", (unsigned long) n);
+        writeRow(label, &pdf[n], 1);
+    }
+    
+    endTable();
+}
+
+
+// Start writing a key whose value is a table
+void ModelWriter::beginTable(const string &key, int precision) {
+    
+    if (inTable)
+        throw logic_error("Cannot begin a table before the previous one ends");
+    
+    inTable = true;
+    tablePrecision = precision;
+    numRows = 0;
+    firstRow.clear();
+    
+    // an overridden table is replaced as a whole, and its rows are dropped
+    skipTable = writeOverride(key);
+    if (!skipTable) {
+        buffer += "$";
+        buffer += key;
+    }
+}
+
+
+// Add a row to the current table
+void ModelWriter::writeRow(const string &label, const double *values, size_t numValues) {
+    
+    if (!inTable)
+        throw logic_error("Cannot write a row outside of a table");
+    
+    if (skipTable)
+        return;
+    
+    // a single-row table is written on the key's line (as ModelFile::write would), so hold
+    // the first row back until a second one arrives
+    string &row = (numRows == 0 ? firstRow : buffer);
+    if (numRows == 1) {
+        buffer += "\n";
+        buffer += firstRow;
+    }
+    if (numRows >= 1)
+        buffer += "\n";
+    
+    row += label;
+    for (size_t n = 0; n < numValues; n++) {
+        row += "\t";
+        appendFixed(row, values[n], tablePrecision);
+    }
+    
+    numRows++;
+    flush();
+}
+
+
+// End the current table
+void ModelWriter::endTable() {
+    
+    if (!inTable)
+        throw logic_error("Cannot end a table that was not begun");
+    
+    inTable = false;
+    if (skipTable)
+        return;
+    
+    // multi-line values are followed by an empty line; others end on the key's line
+    if (numRows > 1)
+        buffer += "\n\n";
+    else {
+        buffer += " ";
+        buffer += boost::trim_copy(firstRow);
+        buffer += "\n";
+    }
+    
+    flush();
+}
+
+
+// Write the unused overrides, flush the buffer, and close the file
+void ModelWriter::close() {
+    
+    if (!out.is_open())
+        return;
+    
+    // overrides of keys that were never written (in key order, so that the output is reproducible)
+    vector<string> remaining;
+    for (boost::unordered_map<string, string>::const_iterator iter = overrides.begin(); iter != overrides.end(); iter++) {
+        if (overridden.find(iter->first) == overridden.end())
+            remaining.push_back(iter->first);
+    }
+    
+    sort(remaining.begin(), remaining.end());
+    for (size_t n = 0; n < remaining.size(); n++)
+        writeKeyValue(remaining[n], overrides[remaining[n]]);
+    
+    flush(true);
+    out.close();
+}
+
+
+// Write the buffer to the file, once it's large enough (or always if forced)
+void ModelWriter::flush(bool force) {
+    
+    if (buffer.empty() || (!force && buffer.size() < MODEL_WRITER_BUFFER_SIZE))
+        return;
+    
+    out.write(buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+
+// Append a number in fixed notation to a string, as a stream set to fixed would print it
+void ModelWriter::appendFixed(string &output, double value, int precision) {
+    
+    static const double scales[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    static const unsigned long long powers[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+                                                1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL};
+    
+    bool negative = (value < 0 || (value == 0 && 1.0 / value < 0));
+    double magnitude = fabs(value);
+    
+    // Fast path: scale to an integer and print its digits. The scaled value is off by at most
+    // ~1e-7 below 1e9, so it rounds as the exact value would, unless it's that close to a tie.
+    if (precision >= 0 && precision <= 9 && magnitude == magnitude) {
+        double scaled = magnitude * scales[precision];
+        if (scaled < 1e9 && fabs(scaled - floor(scaled) - 0.5) > 1e-6) {
+            unsigned long long rounded = (unsigned long long) floor(scaled + 0.5);
+            unsigned long long integer = rounded / powers[precision];
+            unsigned long long fraction = rounded % powers[precision];
+            
+            char digits[32];
+            char *end = digits + sizeof(digits);
+            char *current = end;
+            
+            // fraction digits, zero-padded, then the integer part (built backwards)
+            for (int p = 0; p < precision; p++) {
+                *--current = (char) ('0' + fraction % 10);
+                fraction /= 10;
+            }
+            if (precision > 0)
+                *--current = '.';
+            do {
+                *--current = (char) ('0' + integer % 10);
+                integer /= 10;
+            } while (integer > 0);
+            if (negative)
+                *--current = '-';
+            
+            output.append(current, end);
+            return;
+        }
+    }
+    
+    // otherwise, let printf do the rounding (into a stack buffer, grown only for huge values)
+    char formatted[512];
+    int length = snprintf(formatted, sizeof(formatted), "%.*f", precision, value);
+    if (length < 0)
+        throw runtime_error("Could not format value");
+    
+    if ((size_t) length < sizeof(formatted)) {
+        output.append(formatted, length);
+        return;
+    }
+    
+    vector<char> larger (length + 1);
+    snprintf(&larger[0], larger.size(), "%.*f", precision, value);
+    output.append(&larger[0], length);
+}
@@ -10,6 +10,7 @@
 
 #include "AlphabetDNA.hpp"
 #include "NumSequence.hpp"
+#include "NumSequenceIndex.hpp"
 #include "CharNumConverter.hpp"
 #include "SequenceFile.hpp"
 #include "LabelFile.hpp"
@@ -28,6 +29,8 @@
 #include <algorithm>
 #include <iostream>
 #include <boost/shared_ptr.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 #include <map>
 
 using namespace std;
@@ -35,7 +38,7 @@ using namespace gmsuite;
 using boost::shared_ptr;
 
 
-ModuleExperiment::ModuleExperiment(const OptionsExperiment& opt) : options(opt) {
+ModuleExperiment::ModuleExperiment(const OptionsExperiment& opt, GenomeCache *cache) : options(opt), cache(cache) {
     
 }
 
@@ -69,6 +72,8 @@ void ModuleExperiment::run() {
         runRbsConsensus16SMatch();
     else if (options.experiment == OptionsExperiment::RBS_IS_LOCALIZED)
         runRbsIsLocalized();
+    else if (options.experiment == OptionsExperiment::VALIDATE_GROUPS)
+        runValidateGroups();
     
 }
 
@@ -165,9 +170,10 @@ void ModuleExperiment::runMatchSeqToNoncoding() {
     
     // Generate non-coding sequences
     vector<NumSequence> simNonCoding (expOptions.numNoncoding);
+    RandomGenerator rng (optionsMFinder.seed);
     
     for (size_t n = 0; n < simNonCoding.size(); n++)
-        simNonCoding[n] = trainer.noncoding->emit(expOptions.length);
+        simNonCoding[n] = trainer.noncoding->emit(expOptions.length, rng);
     
     // get sequence to match with
     Sequence strMatchSeq (expOptions.matchTo);
@@ -899,8 +905,14 @@ void ModuleExperiment::runScoreStarts() {
 
 
 void ModuleExperiment::runMatchRBSTo16S() {
+    cout << checkMatchRBSTo16S(options.matchRBSTo16S, options.genericOptions.verbose) << endl;
+}
+
+// count RBS sites in labels, and those that match the 16S tail
+string ModuleExperiment::checkMatchRBSTo16S(const OptionsExperiment::MatchRBSTo16S &expOptions, bool verbose) const {
     
-    OptionsExperiment::MatchRBSTo16S expOptions = options.matchRBSTo16S;
+    if (expOptions.fnlabels.empty())
+        throw invalid_argument("Labels file with predicted RBS required");
     
     // read label file
     LabelFile labelFile (expOptions.fnlabels, LabelFile::READ);
@@ -939,7 +951,7 @@ void ModuleExperiment::runMatchRBSTo16S() {
     for (size_t n = 0; n < rbsSeqs.size(); n++) {
         NumSequence match = SequenceAlgorithms::longestMatchTo16S(matchSeq, rbsSeqs[n], positionOfMatch, substitutions);
         
-        if (options.genericOptions.verbose) {
+        if (verbose) {
             if (match.size() > 0)
                 cout << cnc.convert(rbsSeqs[n].begin(), rbsSeqs[n].end()) << "\t" << cnc.convert(match.begin(), match.end()) << "\t" << match.size() << "\t" << positionOfMatch.first << "\t" << positionOfMatch.second << endl;
         }
@@ -948,12 +960,13 @@ void ModuleExperiment::runMatchRBSTo16S() {
             numMatches++;
     }
     
-    // pritn number of labels and number of matched sequences
-    cout << numOfRBS << "\t" << numMatches << endl;
-    
     for (size_t n = 0; n < labels.size(); n++)
         delete labels[n];
     
+    // number of labels and number of matched sequences
+    stringstream ssm;
+    ssm << numOfRBS << "\t" << numMatches;
+    return ssm.str();
 }
 
 
@@ -963,14 +976,16 @@ void ModuleExperiment::runMatchRBSTo16S() {
 
 void ModuleExperiment::runPromoterIsValidForAchaea() {
     
-    OptionsExperiment::PromoterIsValidForArchaea expOptions = options.promoterIsValidForArchaea;
-    
     // open mod file
-    ModelFile mfile (expOptions.fnmod, ModelFile::READ);
+    ModelFile mfile (options.promoterIsValidForArchaea.fnmod, ModelFile::READ);
+    
+    cout << checkPromoterIsValidForArchaea(options.promoterIsValidForArchaea, mfile) << endl;
+}
+
+string ModuleExperiment::checkPromoterIsValidForArchaea(const OptionsExperiment::PromoterIsValidForArchaea &expOptions, const ModelFile &mfile) const {
     
     string rbsSpacerStr = mfile.readValueForKey("PROMOTER_POS_DISTR");       // get spacer distribution
-    string rbsMaxDurStr = mfile.readValueForKey("PROMOTER_MAX_DUR");         // get maximum duration
-    size_t rbsMaxDur = boost::lexical_cast<size_t>(rbsMaxDurStr);
+    size_t rbsMaxDur = boost::lexical_cast<size_t>(mfile.valueViewForKey("PROMOTER_MAX_DUR"));        // get maximum duration
     
     vector<double> rbsSpacer (rbsMaxDur, 0);
     
@@ -1002,28 +1017,26 @@ void ModuleExperiment::runPromoterIsValidForAchaea() {
         }
     }
     
-    cout << promoterIsValid << endl;
-    
-    
+    return promoterIsValid;
 }
 
 
 
 void ModuleExperiment::runPromoterIsValidForBacteria() {
     
-    OptionsExperiment::PromoterIsValidForBacteria expOptions = options.promoterIsValidForBacteria;
-    
     // open mod file
-    ModelFile mfile (expOptions.fnmod, ModelFile::READ);
+    ModelFile mfile (options.promoterIsValidForBacteria.fnmod, ModelFile::READ);
+    
+    cout << checkPromoterIsValidForBacteria(options.promoterIsValidForBacteria, mfile) << endl;
+}
+
+string ModuleExperiment::checkPromoterIsValidForBacteria(const OptionsExperiment::PromoterIsValidForBacteria &expOptions, const ModelFile &mfile) const {
     
     string rbsSpacerStr = mfile.readValueForKey("PROMOTER_POS_DISTR");       // get spacer distribution
-    string rbsMaxDurStr = mfile.readValueForKey("PROMOTER_MAX_DUR");         // get maximum duration
-    size_t rbsMaxDur = boost::lexical_cast<size_t>(rbsMaxDurStr);
+    size_t rbsMaxDur = boost::lexical_cast<size_t>(mfile.valueViewForKey("PROMOTER_MAX_DUR"));        // get maximum duration
     
-    string numLeaderlessStr = mfile.readValueForKey("PROMOTER_NUM_LEADERLESS");       // get number of leaderless
-    string numFGIOStr = mfile.readValueForKey("PROMOTER_NUM_FGIO");                   // get number of first-genes-in-operon
-    size_t numLeaderless = boost::lexical_cast<size_t>(numLeaderlessStr);
-    size_t numFGIO = boost::lexical_cast<size_t>(numFGIOStr);
+    size_t numLeaderless = boost::lexical_cast<size_t>(mfile.valueViewForKey("PROMOTER_NUM_LEADERLESS"));     // get number of leaderless
+    size_t numFGIO = boost::lexical_cast<size_t>(mfile.valueViewForKey("PROMOTER_NUM_FGIO"));                 // get number of first-genes-in-operon
     
     // if labels file provided, count leaderless and FGIO from it
     if (!expOptions.fnlabels.empty() && !expOptions.fnseq.empty()) {
@@ -1031,57 +1044,58 @@ void ModuleExperiment::runPromoterIsValidForBacteria() {
         CharNumConverter cnc(&alph);
         NumAlphabetDNA numAlph(alph, cnc);
         
-        SequenceFile seqFile (expOptions.fnseq, SequenceFile::READ);
-        Sequence seqStr = seqFile.read();
-        NumSequence sequence(seqStr, cnc);
-        
-        
-        vector<Label*> labels;
-        LabelFile file (expOptions.fnlabels, LabelFile::READ);
-        file.read(labels);
+        // read contigs, and the labels of each (copied from the cache if there is one, since short genes are removed below)
+        vector<NumSequence> readContigs;
+        vector<LabelSet> contigLabels;
+        const vector<NumSequence> *cachedContigs = &readContigs;
         
-        // remove short genes
-        for (size_t n = 0; n < labels.size(); n++) {
-            if (labels[n] == NULL)
-                throw invalid_argument("Label cannot be null");
-            
-            // "remove" short genes
-            if (labels[n]->right - labels[n]->left + 1 < expOptions.minGeneLength) {
-                delete labels[n];
-                labels[n] = NULL;
-            }
+        if (cache != NULL) {
+            cachedContigs = &cache->contigs(expOptions.fnseq);
+            contigLabels = cache->labels(expOptions.fnlabels, expOptions.fnseq);
         }
-        
-        // actually remove
-        vector<Label*>::iterator toRem = remove_if(labels.begin(), labels.end(), isNull);
-        labels.erase(toRem, labels.end());
-        
-        // split labels into sets based on operon status
-        vector<LabelsParser::operon_status_t> operonStatuses;
-        LabelsParser::partitionBasedOnOperonStatus(labels, expOptions.fgioDistThresh, expOptions.fgioDistThresh, operonStatuses);
-        
-        // count number of FGIO
-        size_t numFGIO = 0;
-        for (size_t n = 0; n < operonStatuses.size(); n++) {
-            if (operonStatuses[n] == LabelsParser::FGIO)        numFGIO++;
+        else {
+            SequenceFile seqFile (expOptions.fnseq, SequenceFile::READ);
+            vector<string> contigIDs;
+            seqFile.read(readContigs, contigIDs, cnc);
+            
+            LabelFile file (expOptions.fnlabels, LabelFile::READ);
+            file.read(contigIDs, contigLabels);
         }
         
-        // get FGIO upstreams
-        vector<Label*> labelsFGIO (numFGIO);
-        size_t currFGIO = 0;        // indices
-        
-        for (size_t n = 0; n < operonStatuses.size(); n++) {
-            if (operonStatuses[n] == LabelsParser::FGIO)        labelsFGIO[currFGIO++] = labels[n];
-        }
+        const vector<NumSequence> &contigs = *cachedContigs;
         
         vector<NumSequence> upstreamsPromoter;
+        vector<NumSequence> upstreamsFGIO;
         
         size_t upstrLen = 20;
         
-        // match FGIO to 16S tail
-        vector<NumSequence> upstreamsFGIO;
-        SequenceParser::extractUpstreamSequences(sequence, labelsFGIO, cnc, upstrLen, upstreamsFGIO);
+        for (size_t c = 0; c < contigs.size(); c++) {
+            LabelSet &labels = contigLabels[c];
+            
+            // remove short genes
+            labels.removeShorterThan(expOptions.minGeneLength);
+            
+            // split labels into sets based on operon status
+            vector<LabelsParser::operon_status_t> operonStatuses;
+            LabelsParser::partitionBasedOnOperonStatus(labels, expOptions.fgioDistThresh, expOptions.fgioDistThresh, operonStatuses);
+            
+            // get FGIO labels
+            vector<Label> labelsFGIO;
+            for (size_t n = 0; n < operonStatuses.size(); n++) {
+                if (operonStatuses[n] == LabelsParser::FGIO)        labelsFGIO.push_back(labels.label(n));
+            }
+            
+            vector<Label*> pointersFGIO (labelsFGIO.size());
+            for (size_t n = 0; n < labelsFGIO.size(); n++)
+                pointersFGIO[n] = &labelsFGIO[n];
+            
+            // get FGIO upstreams of this contig
+            vector<NumSequence> contigUpstreams;
+            SequenceParser::extractUpstreamSequences(contigs[c], pointersFGIO, cnc, upstrLen, contigUpstreams);
+            upstreamsFGIO.insert(upstreamsFGIO.end(), contigUpstreams.begin(), contigUpstreams.end());
+        }
         
+        // match FGIO to 16S tail
         Sequence strMatchSeq (expOptions.matchTo);
         NumSequence matchSeq (strMatchSeq, cnc);
         
@@ -1109,14 +1123,10 @@ void ModuleExperiment::runPromoterIsValidForBacteria() {
         percentLeaderless = 100.0 * numLeaderless / (double) numFGIO;
     
     // check whether enough leaderless
-    if (percentLeaderless < expOptions.minLeaderlessPercent) {
-        cout << "no" << endl;
-        return;
-    }
-    if (numLeaderless < expOptions.minLeaderlessCount) {
-        cout << "no" << endl;
-        return;
-    }
+    if (percentLeaderless < expOptions.minLeaderlessPercent)
+        return "no";
+    if (numLeaderless < expOptions.minLeaderlessCount)
+        return "no";
     
     vector<double> rbsSpacer (rbsMaxDur, 0);
     
@@ -1149,9 +1159,7 @@ void ModuleExperiment::runPromoterIsValidForBacteria() {
         }
     }
     
-    cout << promoterIsValid << endl;
-    
-    
+    return promoterIsValid;
 }
 
 
@@ -1188,17 +1196,18 @@ void splitGenesIntoMatchAndUnmatch (const NumSequence &sequence, const vector<La
 }
 
 
-void runMotifFinder(const NumSequence &sequence, const vector<Label*> &labels, const OptionsMFinder &optionsMFinder, const NumAlphabetDNA  &numAlph, size_t upstreamLength, NonUniformMarkov* &motifMarkov, UnivariatePDF* &motifSpacer) {
+void runMotifFinder(const NumSequence &sequence, const NumSequenceIndex &index, const vector<Label*> &labels, const OptionsMFinder &optionsMFinder, const NumAlphabetDNA  &numAlph, size_t upstreamLength, NonUniformMarkov* &motifMarkov, UnivariatePDF* &motifSpacer) {
     
     AlphabetDNA alph;
     CharNumConverter cnc(&alph);
     
-    vector<NumSequence> sequencesRaw;
+    vector<NumSequenceView> sequencesRaw;
     SequenceParser::extractUpstreamSequences(sequence, labels, cnc, upstreamLength, sequencesRaw);
     
-    vector<NumSequence> upstreams;
+    // skip upstreams with ambiguous letters (checked against the genome's prefix counts)
+    vector<NumSequenceView> upstreams;
     for (size_t n = 0; n < sequencesRaw.size(); n++) {
-        if (!sequencesRaw[n].containsInvalid(numAlph))
+        if (!index.containsInvalid(sequencesRaw[n]))
             upstreams.push_back(sequencesRaw[n]);
     }
     
@@ -1212,7 +1221,7 @@ void runMotifFinder(const NumSequence &sequence, const vector<Label*> &labels, c
     // build RBS model
     NonUniformCounts motifCounts(optionsMFinder.motifOrder, optionsMFinder.width, numAlph);
     for (size_t n = 0; n < upstreams.size(); n++) {
-        motifCounts.count(upstreams[n].begin()+positions[n], upstreams[n].begin()+positions[n]+optionsMFinder.width);
+        motifCounts.count(upstreams[n].subview(positions[n], optionsMFinder.width));
     }
     
     motifMarkov = new NonUniformMarkov(optionsMFinder.motifOrder, optionsMFinder.width, numAlph);
@@ -1337,11 +1346,13 @@ void ModuleExperiment::runStartModelStrategy2() {
     UnivariatePDF *motifSpacerIG_Unmatched      ;
     
     
-    runMotifFinder(numSequence, labelsFGIO_Matched, expOptions.mfinderFGIOMatchedOptions, numAlph, expOptions.upstreamLengthFGIOMatched, motifMarkovFGIO_Matched, motifSpacerFGIO_Matched);
-    runMotifFinder(numSequence, labelsFGIO_Unmatched, expOptions.mfinderFGIOUnmatchedOptions, numAlph, expOptions.upstreamLengthFGIOUnmatched, motifMarkovFGIO_Unmatched, motifSpacerFGIO_Unmatched);
+    NumSequenceIndex index (numSequence, numAlph);
     
-    runMotifFinder(numSequence, labelsIG_Matched, expOptions.mfinderIGMatchedOptions, numAlph, expOptions.upstreamLengthIGMatched, motifMarkovIG_Matched, motifSpacerIG_Matched);
-    runMotifFinder(numSequence, labelsIG_Unmatched, expOptions.mfinderIGUnmatchedOptions, numAlph, expOptions.upstreamLengthIGUnmatched, motifMarkovIG_Unmatched, motifSpacerIG_Unmatched);
+    runMotifFinder(numSequence, index, labelsFGIO_Matched, expOptions.mfinderFGIOMatchedOptions, numAlph, expOptions.upstreamLengthFGIOMatched, motifMarkovFGIO_Matched, motifSpacerFGIO_Matched);
+    runMotifFinder(numSequence, index, labelsFGIO_Unmatched, expOptions.mfinderFGIOUnmatchedOptions, numAlph, expOptions.upstreamLengthFGIOUnmatched, motifMarkovFGIO_Unmatched, motifSpacerFGIO_Unmatched);
+    
+    runMotifFinder(numSequence, index, labelsIG_Matched, expOptions.mfinderIGMatchedOptions, numAlph, expOptions.upstreamLengthIGMatched, motifMarkovIG_Matched, motifSpacerIG_Matched);
+    runMotifFinder(numSequence, index, labelsIG_Unmatched, expOptions.mfinderIGUnmatchedOptions, numAlph, expOptions.upstreamLengthIGUnmatched, motifMarkovIG_Unmatched, motifSpacerIG_Unmatched);
     
     
     // get string representations
@@ -1417,10 +1428,13 @@ string getConsensus(map<char, vector<double> > &mapVec) {
 
 void ModuleExperiment::runPromoterAndRBSMatch() {
     
-    OptionsExperiment::PromoterAndRBSMatch expOptions = options.promoterAndRBSMatch;
-    
     // open mod file
-    ModelFile mfile (expOptions.fnmod, ModelFile::READ);
+    ModelFile mfile (options.promoterAndRBSMatch.fnmod, ModelFile::READ);
+    
+    cout << checkPromoterAndRBSMatch(options.promoterAndRBSMatch, mfile) << endl;
+}
+
+string ModuleExperiment::checkPromoterAndRBSMatch(const OptionsExperiment::PromoterAndRBSMatch &expOptions, const ModelFile &mfile) const {
     
     string promoterMatStr = mfile.readValueForKey("PROMOTER_MAT");          // promoter matrix
     string rbsMatStr = mfile.readValueForKey("RBS_MAT");                    // RBS matrix
@@ -1449,16 +1463,20 @@ void ModuleExperiment::runPromoterAndRBSMatch() {
     size_t longestMatchLength = matchedSeq.size();
     
     if (longestMatchLength >= expOptions.numberOfMatches)
-        cout << "yes" << endl;
+        return "yes";
     else
-        cout << "no" << endl;
+        return "no";
 }
 
 void ModuleExperiment::runRbsConsensus16SMatch() {
-    OptionsExperiment::RBSConsensusAnd16SMatch expOptions = options.rbsConsensusAnd16SMatch;
     
     // open mod file
-    ModelFile mfile (expOptions.fnmod, ModelFile::READ);
+    ModelFile mfile (options.rbsConsensusAnd16SMatch.fnmod, ModelFile::READ);
+    
+    cout << checkRbsConsensus16SMatch(options.rbsConsensusAnd16SMatch, mfile) << endl;
+}
+
+string ModuleExperiment::checkRbsConsensus16SMatch(const OptionsExperiment::RBSConsensusAnd16SMatch &expOptions, const ModelFile &mfile) const {
     
     string rbsMatStr = mfile.readValueForKey("RBS_MAT");
     map<char, vector<double> >rbsMat;
@@ -1487,10 +1505,9 @@ void ModuleExperiment::runRbsConsensus16SMatch() {
     size_t longestMatchLength = matchedSeq.size();
     
     if (longestMatchLength >= expOptions.matchThresh)
-        cout << "yes" << endl;
+        return "yes";
     else
-        cout << "no" << endl;
-    
+        return "no";
 }
 
 
@@ -1503,14 +1520,16 @@ void ModuleExperiment::runRbsConsensus16SMatch() {
 
 void ModuleExperiment::runRbsIsLocalized() {
     
-    OptionsExperiment::RBSIsLocalized expOptions = options.rbsIsLocalized;
-    
     // open mod file
-    ModelFile mfile (expOptions.fnmod, ModelFile::READ);
+    ModelFile mfile (options.rbsIsLocalized.fnmod, ModelFile::READ);
+    
+    cout << checkRbsIsLocalized(options.rbsIsLocalized, mfile) << endl;
+}
+
+string ModuleExperiment::checkRbsIsLocalized(const OptionsExperiment::RBSIsLocalized &expOptions, const ModelFile &mfile) const {
     
     string rbsSpacerStr = mfile.readValueForKey("RBS_POS_DISTR");       // get spacer distribution
-    string rbsMaxDurStr = mfile.readValueForKey("RBS_MAX_DUR");         // get maximum duration
-    size_t rbsMaxDur = boost::lexical_cast<size_t>(rbsMaxDurStr);
+    size_t rbsMaxDur = boost::lexical_cast<size_t>(mfile.valueViewForKey("RBS_MAX_DUR"));        // get maximum duration
     
     
     vector<double> rbsSpacer (rbsMaxDur, 0);
@@ -1544,5 +1563,72 @@ void ModuleExperiment::runRbsIsLocalized() {
         }
     }
     
-    cout << promoterIsValid << endl;
+    return promoterIsValid;
+}
+
+
+
+// Run one check of a batch, keeping its verdict (or the reason it failed)
+void ModuleExperiment::runValidationCheck(OptionsExperiment::experiment_t check, const ModelFile &mfile, string &verdict, string &error) const {
+    
+    const OptionsExperiment::ValidateGroups &expOptions = options.validateGroups;
+    
+    try {
+        if (check == OptionsExperiment::PROMOTER_IS_VALID_FOR_ARCHAEA)
+            verdict = checkPromoterIsValidForArchaea(expOptions.promoterIsValidForArchaea, mfile);
+        else if (check == OptionsExperiment::PROMOTER_IS_VALID_FOR_BACTERIA)
+            verdict = checkPromoterIsValidForBacteria(expOptions.promoterIsValidForBacteria, mfile);
+        else if (check == OptionsExperiment::RBS_IS_LOCALIZED)
+            verdict = checkRbsIsLocalized(expOptions.rbsIsLocalized, mfile);
+        else if (check == OptionsExperiment::MATCH_RBS_TO_16S)
+            verdict = checkMatchRBSTo16S(expOptions.matchRBSTo16S, false);
+        else if (check == OptionsExperiment::PROMOTER_AND_RBS_MATCH)
+            verdict = checkPromoterAndRBSMatch(expOptions.promoterAndRBSMatch, mfile);
+        else if (check == OptionsExperiment::RBS_CONSENSUS_AND_16S_MATCH)
+            verdict = checkRbsConsensus16SMatch(expOptions.rbsConsensusAnd16SMatch, mfile);
+        else
+            throw invalid_argument("Not a group-validation check");
+    }
+    catch (exception &ex) {
+        error = ex.what();
+    }
+    catch (...) {
+        error = "unknown error";
+    }
+}
+
+
+void ModuleExperiment::runValidateGroups() {
+    
+    const OptionsExperiment::ValidateGroups &expOptions = options.validateGroups;
+    size_t numChecks = expOptions.checks.size();
+    
+    // the mod file is opened once, and read by all checks
+    ModelFile mfile (expOptions.fnmod, ModelFile::READ);
+    
+    vector<string> verdicts (numChecks);
+    vector<string> errors (numChecks);
+    
+    // checks are independent (they only read the mod file), so each runs on its own thread.
+    // Only promoter-is-valid-for-bacteria uses the genome cache, so it is never shared.
+    if (numChecks == 1) {
+        runValidationCheck(expOptions.checks[0], mfile, verdicts[0], errors[0]);
+    }
+    else {
+        boost::thread_group workers;
+        for (size_t n = 0; n < numChecks; n++) {
+            workers.create_thread(boost::bind(&ModuleExperiment::runValidationCheck, this, expOptions.checks[n], boost::cref(mfile),
+                                              boost::ref(verdicts[n]), boost::ref(errors[n])));
+        }
+        workers.join_all();
+    }
+    
+    // one line per check, in the requested order: the check's name, followed by the output of its
+    // own experiment (tab-separated), or by "error" and the reason it failed
+    for (size_t n = 0; n < numChecks; n++) {
+        if (errors[n].empty())
+            cout << expOptions.checkNames[n] << "\t" << verdicts[n] << endl;
+        else
+            cout << expOptions.checkNames[n] << "\terror\t" << errors[n] << endl;
+    }
 }
@@ -10,6 +10,7 @@
 #include "GMS2Trainer.hpp"
 
 #include "ModelFile.hpp"
+#include "ModelWriter.hpp"
 #include "LabelFile.hpp"
 #include "SequenceFile.hpp"
 #include <iostream>
@@ -18,7 +19,7 @@ using namespace std;
 using namespace gmsuite;
 
 // constructor initializing the module's options
-ModuleGMS2Training::ModuleGMS2Training(const OptionsGMS2Training &opt) : options(opt) {
+ModuleGMS2Training::ModuleGMS2Training(const OptionsGMS2Training &opt, GenomeCache *cache) : options(opt), cache(cache) {
     
 }
 
@@ -30,17 +31,27 @@ void ModuleGMS2Training::run() {
     CharNumConverter cnc(&alph);
     NumAlphabetDNA numAlph(alph, cnc);
     NumGeneticCode numGeneticCode(geneticCode, cnc);
-    // read sequence from file
-    SequenceFile seqFile(options.fn_sequence, SequenceFile::READ);
-    Sequence strSeq = seqFile.read();
     
-    // get numeric sequence
-    NumSequence sequence(strSeq, cnc);
+    // contigs and their labels: from the cache if there is one, otherwise read from file
+    vector<NumSequence> readContigs;
+    vector<LabelSet> readLabels;
+    const vector<NumSequence> *contigs = &readContigs;
+    const vector<LabelSet> *labels = &readLabels;
     
-    // read labels from file
-    LabelFile labFile(options.fn_labels, LabelFile::READ);
-    vector<Label*> labels;
-    labFile.read(labels);
+    if (cache != NULL) {
+        contigs = &cache->contigs(options.fn_sequence);
+        labels = &cache->labels(options.fn_labels, options.fn_sequence);
+    }
+    else {
+        // read contigs from file, straight into their numeric form
+        SequenceFile seqFile(options.fn_sequence, SequenceFile::READ);
+        vector<string> contigIDs;
+        seqFile.read(readContigs, contigIDs, cnc);
+        
+        // read labels of each contig from file
+        LabelFile labFile(options.fn_labels, LabelFile::READ);
+        labFile.read(contigIDs, readLabels);
+    }
     
     
     // set up trainer
@@ -50,46 +61,28 @@ void ModuleGMS2Training::run() {
     GMS2Trainer::Builder builder;
     GMS2Trainer trainer = builder.build(options);
     
-    trainer.estimateParameters(sequence, labels);
+    if (cache != NULL)
+        trainer.setContigIndexes(cache->contigIndexes(options.fn_sequence));
+    
+    trainer.estimateParameters(*contigs, *labels, options.numThreads);
     
-    // get parameters from training
-    vector<pair<string, string> > toMod;
-    trainer.toModFile(toMod, options);
+    // write parameters to file, with values given in the settings file taking precedence
+    ModelWriter writer(options.fn_outmod, "NATIVE");
     
-    // write settings that were given in from the settings file
     if (!options.fn_settings.empty()) {
         ModelFile settingsMFile(options.fn_settings, ModelFile::READ);
         
-        map<string, string> settings;
-        settingsMFile.read(settings);
+        vector<pair<string, string> > settingsList;
+        settingsMFile.read(settingsList);
         
-        for (map<string, string>::const_iterator iter = settings.begin(); iter != settings.end(); iter++) {
-            // search for key
-            vector<pair<string, string> >::iterator key;
-            for (key = toMod.begin(); key != toMod.end(); key++) {
-                if (key->first == iter->first)      // if key found
-                    break;
-            }
-            
-            // if key not found, add it
-            if (key == toMod.end()) {
-                toMod.insert(toMod.begin()+1, pair<string, string>(iter->first, iter->second));       // add element to top of list
-            }
-            // if key found, replace value
-            else {
-                key->second = iter->second;
-            }
-        }
+        boost::unordered_map<string, string> settings;
+        for (size_t n = 0; n < settingsList.size(); n++)
+            settings[settingsList[n].first] = settingsList[n].second;
+        
+        writer.setOverrides(settings);
     }
     
-    // write parameters to file
-    ModelFile modFile(options.fn_outmod, ModelFile::WRITE);
-    modFile.write(toMod, "NATIVE");
-    
-    
-    // free up memory for labels
-    for (size_t n = 0; n < labels.size(); n++)
-        if (labels[n] != NULL)
-            delete labels[n];
+    trainer.toModFile(writer, options);
+    writer.close();
 }
 
@@ -33,6 +33,8 @@ void ModuleMFinder::run() {
     MotifFinder::Builder b;
     b.setAlign(options.align).setWidth(options.width).setMaxIter(options.maxIter).setMaxEMIter(options.maxEMIter).setNumTries(options.tries);
     b.setPcounts(options.pcounts).setMotifOrder(options.motifOrder).setBackOrder(options.bkgdOrder).setShiftEvery(options.shiftEvery);
+    b.setNumThreads(options.numThreads).setSeed(options.seed);
+    b.setConvergeAfter(options.convergeAfter).setTimeBudget(options.timeBudget).setIterBudget(options.iterBudget);
     
     // build motif finder from above options
     MotifFinder mfinder = b.build();
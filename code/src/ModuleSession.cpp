@@ -0,0 +1,149 @@
+//
+//  ModuleSession.cpp
+//  GeneMark Suite
+//
+
+#include "ModuleSession.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+#include "OptionsUtilities.hpp"
+#include "OptionsExperiment.hpp"
+#include "OptionsGMS2Training.hpp"
+#include "ModuleUtilities.hpp"
+#include "ModuleExperiment.hpp"
+#include "ModuleGMS2Training.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+#define SESSION_PROGRAM_NAME "biogem"
+#define SESSION_STATUS "##status"
+
+#define MOD_UTILITIES "utilities"
+#define MOD_EXPERIMENT "experiment"
+#define MOD_GMS2_TRAINING "gms2-training"
+
+#define CMD_QUIT "quit"
+#define CMD_CLEAR_CACHE "clear-cache"
+
+
+// constructor
+ModuleSession::ModuleSession(istream &commands) : commands(commands) {
+    
+}
+
+
+// Run commands until the end of the stream, or until "quit"
+void ModuleSession::run() {
+    
+    string line;
+    while (getline(commands, line)) {
+        
+        vector<string> words;
+        
+        try {
+            splitCommand(line, words);
+            
+            if (words.empty())
+                continue;
+            
+            if (words[0] == CMD_QUIT)
+                break;
+            
+            if (words[0] == CMD_CLEAR_CACHE)
+                cache.clear();
+            else
+                runCommand(words);
+            
+            cout << SESSION_STATUS << " ok" << endl;
+        }
+        catch (exception &ex) {
+            cout << SESSION_STATUS << " error " << ex.what() << endl;
+        }
+    }
+}
+
+
+// Run a single command (mode followed by its arguments)
+void ModuleSession::runCommand(const vector<string> &words) {
+    
+    // arguments as the modes' options expect them: program name, mode, then the rest
+    vector<const char*> argv;
+    argv.push_back(SESSION_PROGRAM_NAME);
+    for (size_t n = 0; n < words.size(); n++)
+        argv.push_back(words[n].c_str());
+    
+    int argc = (int) argv.size();
+    const string &mode = words[0];
+    
+    if (mode == MOD_GMS2_TRAINING) {
+        OptionsGMS2Training options(mode);
+        if (!options.parse(argc, &argv[0]))
+            throw invalid_argument("Could not parse options of " + mode);
+        
+        ModuleGMS2Training module (options, &cache);
+        module.run();
+    }
+    else if (mode == MOD_EXPERIMENT) {
+        OptionsExperiment options(mode);
+        if (!options.parse(argc, &argv[0]))
+            throw invalid_argument("Could not parse options of " + mode);
+        
+        ModuleExperiment module (options, &cache);
+        module.run();
+    }
+    else if (mode == MOD_UTILITIES) {
+        OptionsUtilities options(mode);
+        if (!options.parse(argc, &argv[0]))
+            throw invalid_argument("Could not parse options of " + mode);
+        
+        ModuleUtilities module (options);
+        module.run();
+    }
+    else
+        throw invalid_argument("Unknown mode: " + mode);
+}
+
+
+// Split a command line into its arguments, on whitespace outside of quotes
+void ModuleSession::splitCommand(const string &line, vector<string> &words) {
+    
+    words.clear();
+    
+    string word;
+    bool inWord = false;
+    char quote = 0;
+    
+    for (size_t n = 0; n < line.size(); n++) {
+        char c = line[n];
+        
+        if (quote != 0) {
+            if (c == quote)
+                quote = 0;
+            else
+                word += c;
+        }
+        else if (c == '"' || c == '\'') {
+            quote = c;
+            inWord = true;
+        }
+        else if (isspace(c)) {
+            if (inWord)
+                words.push_back(word);
+            word.clear();
+            inWord = false;
+        }
+        else {
+            word += c;
+            inWord = true;
+        }
+    }
+    
+    if (quote != 0)
+        throw invalid_argument("Unclosed quote in command: " + line);
+    
+    if (inWord)
+        words.push_back(word);
+}
@@ -60,6 +60,8 @@ void ModuleUtilities::run() {
         runComputeGC();
     else if (options.utility == OptionsUtilities::SEPARATE_FGIO_AND_IG)
         runSeparateFGIOAndIG();
+    else if (options.utility == OptionsUtilities::CONVERT_MODEL)
+        runConvertModel();
     
 //    else            // unrecognized utility to run
 //        throw invalid_argument("Unknown utility function " + options.utility);
@@ -253,9 +255,10 @@ void ModuleUtilities::runStartModelInfo() {
     
     // Generate non-coding sequences
     vector<NumSequence> simNonCoding (options.startModelInfoUtility.numOfSimNonCoding);
+    RandomGenerator rng (optTrain->optionsMFinder.seed);
     
     for (size_t n = 0; n < simNonCoding.size(); n++) {
-        simNonCoding[n] = trainer.noncoding->emit(optTrain->upstreamLength);
+        simNonCoding[n] = trainer.noncoding->emit(optTrain->upstreamLength, rng);
 //        cout << cnc.convert(simNonCoding[n].begin(), simNonCoding[n].end()) << endl;
     }
     
@@ -426,9 +429,10 @@ void ModuleUtilities::runMatchSeqToNoncoding() {
     
     // Generate non-coding sequences
     vector<NumSequence> simNonCoding (options.matchSeqWithNoncoding.numOfSimNonCoding);
+    RandomGenerator rng (optTrain->optionsMFinder.seed);
     
     for (size_t n = 0; n < simNonCoding.size(); n++) {
-        simNonCoding[n] = trainer.noncoding->emit(optTrain->upstreamLength);
+        simNonCoding[n] = trainer.noncoding->emit(optTrain->upstreamLength, rng);
     }
     
     
@@ -488,7 +492,8 @@ void ModuleUtilities::runEmitNonCoding() {
     NonCodingMarkov nonCodingMarkov(nonCodingProbs, numAlph, cnc);
     
     // emit noncoding sequence
-    NumSequence emittedNumSeq = nonCodingMarkov.emit(options.emitNonCoding.length);
+    RandomGenerator rng (options.emitNonCoding.seed);
+    NumSequence emittedNumSeq = nonCodingMarkov.emit(options.emitNonCoding.length, rng);
     
     // get string form of sequence
     Sequence emittedSeq = Sequence(cnc.convert(emittedNumSeq.begin(), emittedNumSeq.end()));
@@ -779,6 +784,13 @@ void ModuleUtilities::runComputeGC() {
     SequenceFile sequenceFile (utilOpt.fn_sequence, SequenceFile::READ);
     Sequence strSequence = sequenceFile.read();
     
+    AlphabetDNA alph;
+    CharNumConverter cnc (&alph);
+    NumAlphabetDNA numAlph(alph, cnc);
+    
+    NumSequence numSequence (strSequence, cnc);
+    NumSequenceIndex index (numSequence, numAlph);
+    
     // read label file (if given)
     vector<Label*> labels;
     
@@ -787,14 +799,14 @@ void ModuleUtilities::runComputeGC() {
         labelFile.read(labels);
         
         vector<double> gcs;
-        SequenceAlgorithms::computeGC(strSequence, labels, gcs);
+        SequenceAlgorithms::computeGC(index, labels, gcs);
         for (size_t n = 0; n < gcs.size(); n++)
             cout << gcs[n] << endl;
         
     }
     // for entire sequence
     else {
-        double gc = SequenceAlgorithms::computeGC(strSequence);
+        double gc = index.gc(0, index.size());
         cout << gc << endl;
     }
 }
@@ -844,13 +856,18 @@ void ModuleUtilities::runSeparateFGIOAndIG() {
 }
 
 
-
-
-
-
-
-
-
-
-
-
+void ModuleUtilities::runConvertModel() {
+    OptionsUtilities::ConvertModel utilOpt = options.convertModel;
+    
+    // read model file (text or binary image)
+    ModelFile in (utilOpt.fn_mod, ModelFile::READ);
+    vector<pair<string, string> > keyValue;
+    in.read(keyValue);
+    
+    // write it as a binary image or as text
+    ModelFile out (utilOpt.fn_out, ModelFile::WRITE);
+    if (utilOpt.binary)
+        out.writeBinary(keyValue, in.getSectionHeader());
+    else
+        out.write(keyValue, in.getSectionHeader());
+}
@@ -9,7 +9,6 @@
 #include "MotifFinder.hpp"
 
 #include <float.h>              // DBL_MAX
-#include <stdlib.h>             // rand
 #include <iostream>
 #include <algorithm>
 #include "CountModels.hpp"
@@ -19,6 +18,10 @@
 #include "ProbabilityModels.hpp"
 #include "ProbabilityModelsV1.hpp"
 
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
 using namespace std;
 using namespace gmsuite;
 
@@ -34,7 +37,12 @@ MotifFinder::MotifFinder(
                          unsigned maxIter,
                          unsigned maxEMIter,
                          unsigned shiftEvery,
-                         double filterThresh) {
+                         double filterThresh,
+                         unsigned numThreads,
+                         RandomGenerator::result_type seed,
+                         unsigned convergeAfter,
+                         double timeBudget,
+                         unsigned iterBudget) {
     
     this->width = width;
     this->motifOrder = motifOrder;
@@ -46,52 +54,186 @@ MotifFinder::MotifFinder(
     this->maxEMIter = maxEMIter;
     this->shiftEvery = shiftEvery;
     this->filterThresh = filterThresh;
+    this->numThreads = numThreads;
+    this->seed = seed;
+    this->convergeAfter = convergeAfter;
+    this->timeBudget = timeBudget;
+    this->iterBudget = iterBudget;
+    
+    bestTry = 0;
+    bestScore = -DBL_MAX;
 }
 
 
 // Find motifs in sequences.
 void MotifFinder::findMotifs (const vector<NumSequence> &sequences, vector<NumSequence::size_type> &positions) {
+    findMotifs(SequenceBatch(sequences), positions);
+}
+
+
+// Find motifs in sequence views
+void MotifFinder::findMotifs (const vector<NumSequenceView> &sequences, vector<NumSequence::size_type> &positions) {
+    findMotifs(SequenceBatch(sequences), positions);
+}
+
+
+// Find motifs in the valid rows of a batch.
+void MotifFinder::findMotifs (const SequenceBatch &sequences, vector<NumSequence::size_type> &positions) {
+    
+    bestTry = 0;
+    bestScore = -DBL_MAX;
     
     // if no sequences, just return
-    if (sequences.size() == 0)
+    if (sequences.numValid() == 0)
         return;
     
+    // every try splits its own stream from this generator, so results depend only on the seed
+    RandomGenerator generator (seed);
+    
+    vector<double> tryScores (tries, -DBL_MAX);                         // alignment probability of each try
+    vector<vector<NumSequence::size_type> > tryPositions (tries);       // motif positions of each try
+    
+    unsigned numWorkers = std::max(1u, std::min(numThreads, tries));
+    
+    try_queue_t queue;
+    queue.nextTry = 0;
+    queue.numWorkers = numWorkers;
+    queue.reservedIterations = 0;
+    queue.start = boost::posix_time::microsec_clock::universal_time();
+    
+    // run tries on the current thread
+    if (numWorkers == 1) {
+        runTries(sequences, generator, tryScores, tryPositions, queue);
+    }
+    // otherwise, run tries concurrently on a pool of workers
+    else {
+        boost::thread_group workers;
+        for (unsigned w = 0; w < numWorkers; w++) {
+            workers.create_thread(boost::bind(&MotifFinder::runTries, this, boost::cref(sequences), boost::cref(generator),
+                                              boost::ref(tryScores), boost::ref(tryPositions), boost::ref(queue)));
+        }
+        workers.join_all();
+    }
+    
     double maxProbability = -DBL_MAX;                   // maximum probability over all tries
-    vector<NumSequence::size_type> maxPositions;        // motif position for max-probability try
+    size_t maxTry = 0;                                  // index of max-probability try
     
-    // run algorithm several times; choose output with maximum probability
+    // choose output with maximum probability (earliest try wins ties)
     for (unsigned t = 0; t < tries; t++) {
+        if (tryScores[t] > maxProbability) {
+            maxProbability = tryScores[t];
+            maxTry = t;
+        }
+    }
+    
+    // get best positions for output
+    if (tries > 0)
+        positions = tryPositions[maxTry];
+    
+    bestTry = maxTry;
+    bestScore = maxProbability;
+    
+}
+
+
+// Worker loop: claim tries one at a time until none are left
+void MotifFinder::runTries(const SequenceBatch &sequences, const RandomGenerator &generator, vector<double> &scores, vector<vector<NumSequence::size_type> > &positions, try_queue_t &queue) {
+    
+    while (true) {
+        
+        // claim next try, along with its share of the budget
+        unsigned t;
+        try_budget_t budget;
+        {
+            boost::mutex::scoped_lock scopedLock(queue.lock);
+            if (queue.nextTry >= scores.size())
+                break;
+            t = queue.nextTry++;
+            budget = allotBudget(queue, t);
+        }
         
-        vector<NumSequence::size_type> tempPosition;
-        double tempProb = gibbsFinder(sequences, tempPosition);         // run gibbs finder
+        size_t iterations = 0;
+        RandomGenerator rng = generator.split(t);                                           // random stream of this try
+        scores[t] = gibbsFinder(sequences, positions[t], rng, budget, iterations);          // run gibbs finder
         
-        // if found better alignment, record it
-        if (tempProb > maxProbability) {
-            maxProbability = tempProb;
-            maxPositions = tempPosition;
+        // return unused iterations to the budget
+        if (iterBudget > 0) {
+            boost::mutex::scoped_lock scopedLock(queue.lock);
+            queue.reservedIterations -= budget.maxIterations - std::min(iterations, budget.maxIterations);
         }
     }
+}
+
+
+// Allot a budget to a try, as a share of the remaining budget
+MotifFinder::try_budget_t MotifFinder::allotBudget(try_queue_t &queue, unsigned t) const {
+    
+    try_budget_t budget;
+    budget.maxIterations = std::numeric_limits<size_t>::max();
+    budget.deadline = boost::posix_time::not_a_date_time;
+    
+    unsigned triesLeft = tries - t;                     // tries not started yet, including this one
+    
+    if (iterBudget > 0) {
+        size_t remaining = (iterBudget > queue.reservedIterations ? iterBudget - queue.reservedIterations : 0);
+        budget.maxIterations = remaining / triesLeft;
+        queue.reservedIterations += budget.maxIterations;
+    }
     
-    // get best positions for output
-    positions = maxPositions;
+    // tries run numWorkers at a time, so each gets that many shares of the remaining time
+    if (timeBudget > 0) {
+        boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+        double elapsed = (now - queue.start).total_microseconds() / 1e6;
+        double share = std::max(0.0, timeBudget - elapsed) * std::min(queue.numWorkers, triesLeft) / triesLeft;
+        budget.deadline = now + boost::posix_time::microseconds((long) (share * 1e6));
+    }
     
+    return budget;
+}
+
+
+// check whether a try has used up its budget
+static bool budgetExhausted(size_t iterations, size_t maxIterations, const boost::posix_time::ptime &deadline) {
+    
+    if (iterations >= maxIterations)
+        return true;
+    
+    return !deadline.is_not_a_date_time() && boost::posix_time::microsec_clock::universal_time() >= deadline;
+}
+
+
+
+// shuffle indices using the given random engine
+static void shuffleIndices(vector<size_t> &indices, RandomGenerator &rng) {
+    for (size_t i = indices.size(); i > 1; i--) {
+        boost::random::uniform_int_distribution<size_t> dist (0, i-1);
+        std::swap(indices[i-1], indices[dist(rng)]);
+    }
 }
 
 
 
 // Run a single try of gibbs-finder to search for the best motif alignment.
-double MotifFinder::gibbsFinder(const vector<NumSequence> &sequences, vector<NumSequence::size_type> &positions) {
+double MotifFinder::gibbsFinder(const SequenceBatch &sequences, vector<NumSequence::size_type> &positions, RandomGenerator &rng, const try_budget_t &budget, size_t &iterations) {
     
-    vector<NumSequence>::size_type numSeqs = sequences.size();            // number of sequences
+    SequenceBatch::size_type numSeqs = sequences.numValid();             // number of (valid) sequences
     
     /***** Initialize random alignment *****/
     
-    // start by randomly selecting motif locations in sequences
-    vector<Sequence::size_type> tempPositions (numSeqs);
+    // start by randomly selecting motif locations in sequences (invalid rows have none)
+    vector<Sequence::size_type> tempPositions (sequences.size(), NumSequence::npos);
+    
+    vector<size_t> shuffled;
+    shuffled.reserve(numSeqs);
     
-    for (vector<NumSequence>::size_type n = 0; n < numSeqs; n++) {
+    for (SequenceBatch::size_type n = 0; n < sequences.size(); n++) {
+        if (!sequences.isValid(n))
+            continue;
+        
         // get random position between 0 and number of valid motif positions (i.e. consider motif width)
-        tempPositions[n] = rand() % (sequences[n].size() - width + 1);
+        boost::random::uniform_int_distribution<Sequence::size_type> dist (0, sequences.length(n) - width);
+        tempPositions[n] = dist(rng);
+        shuffled.push_back(n);
     }
     
     CharNumConverter cnc(&this->alphabet);
@@ -104,24 +246,29 @@ double MotifFinder::gibbsFinder(const vector<NumSequence> &sequences, vector<Num
     
     // allocate space for probability models
     ProbabilityModels *probs = new ProbabilityModelsV1(numAlphabet, width, motifOrder, backOrder, pcounts, align);
+    probs->construct(counts);
     
     double maxScore = -DBL_MAX;                 // maximum alignment score
     vector<Sequence::size_type> maxPositions;   // maximum alignment positions
     
     
-    vector<size_t> shuffled (numSeqs);
-    for (size_t k = 0; k < numSeqs; k++)
-        shuffled[k] = k;
-    
+    // filtering is disabled for the first round of iterations (local copy, since tries may run concurrently)
     bool filteringEnabled = false;
-    double tempFilterThresh = this->filterThresh;
-    this->filterThresh = -std::numeric_limits<double>::infinity();
+    double filterThresh = -std::numeric_limits<double>::infinity();
+    
+    size_t stalled = 0;                         // number of consecutive iterations without improvement
+    iterations = 0;
     
     // run all iterations until maximum iteration number is reached
     for (size_t iter = 0; iter < maxIter; iter++) {
         
+        // stop once the budget is used up (the first iteration always runs)
+        if (iterations > 0 && budgetExhausted(iterations, budget.maxIterations, budget.deadline))
+            break;
+        iterations++;
+        
         // shuffle indeces to select sequences in random order
-        random_shuffle(shuffled.begin(), shuffled.end());
+        shuffleIndices(shuffled, rng);
         
         // 1) select a sequence z
         // 2) remove z from counts
@@ -129,86 +276,118 @@ double MotifFinder::gibbsFinder(const vector<NumSequence> &sequences, vector<Num
         // 4) find new motif location in z
         // 5) add new z info back to counts
         
-        for (vector<NumSequence>::size_type k = 0; k < numSeqs; k++) {
+        for (vector<size_t>::size_type k = 0; k < numSeqs; k++) {
             
             Sequence::size_type zIndex = shuffled[k];                                       // select sequence z
             
-            counts->decount(sequences[zIndex], tempPositions[zIndex]);                      // remove z from counts
+            counts->decount(sequences, zIndex, tempPositions[zIndex]);                      // remove z from counts
             
-            probs->construct(counts);                                                       // build models from remaining sequences counts
+            probs->update(counts, sequences, zIndex, tempPositions[zIndex]);                // update models from remaining sequences counts
             
-            tempPositions[zIndex] = probs->samplePosition(sequences[zIndex]);               // find new motif location in z
+            tempPositions[zIndex] = probs->samplePosition(sequences, zIndex, rng);               // find new motif location in z
             
-            if (probs->computePositionScore(sequences[zIndex], tempPositions[zIndex]) < filterThresh)
+            if (probs->computePositionScore(sequences, zIndex, tempPositions[zIndex]) < filterThresh)
                 tempPositions[zIndex] = NumSequence::npos;
             
-            counts->count(sequences[zIndex], tempPositions[zIndex]);                        // add new z info back to counts
+            counts->count(sequences, zIndex, tempPositions[zIndex]);                        // add new z info back to counts
+            probs->update(counts, sequences, zIndex, tempPositions[zIndex]);
             
         }
         
         // try shifting motifs left and right to find better locations
         if (iter > 0 && iter % shiftEvery == 0) {
-            int amountToShift = attemptShift(sequences, tempPositions);                     // try shifting
+            int amountToShift = attemptShift(sequences, tempPositions, counts, probs, rng);      // try shifting
             
             // if shift successful
             if (amountToShift != 0) {
                 vector<Sequence::size_type> shiftedPositions;
                 shiftPositions(tempPositions, amountToShift, sequences, shiftedPositions);  // shift positions by amountToShift
                 
+                moveMotifs(sequences, tempPositions, shiftedPositions, counts, probs);      // update counts and models to new positions
                 tempPositions = shiftedPositions;                                           // assign new positions
-                counts->construct(sequences, tempPositions);                                // construct new counts
             }
         }
         
-        // compute probabilities based on latest counts
-        probs->construct(counts);
-        
-        // calculate alignment conditional log-likelihood
+        // calculate alignment conditional log-likelihood (models are kept current by updates)
         double tempScore = probs->computeCLL();
         
         if (tempScore > maxScore) {
             maxScore = tempScore;
             maxPositions = tempPositions;
+            stalled = 0;
         }
+        else
+            stalled++;
+        
+        // a round ends after maxIter iterations, or once the score has converged
+        bool converged = convergeAfter > 0 && stalled >= convergeAfter;
+        if (converged && filteringEnabled)
+            break;
         
         // reset iter and enable filtering if not done already
-        if (iter == maxIter-1 && !filteringEnabled) {
+        if ((iter == maxIter-1 || converged) && !filteringEnabled) {
             iter = 0;
             filteringEnabled = true;
-            this->filterThresh = tempFilterThresh;
+            filterThresh = this->filterThresh;
+            stalled = 0;
         }
     }
     
     
+    filterThresh = this->filterThresh;         // filtering always enabled for EM
+    
     // get best configuration, and construct new counts
     tempPositions = maxPositions;
     counts->construct(sequences, tempPositions);
+    probs->construct(counts);
+    
+    stalled = 0;
     
     // perform EM on best configuration
     for (size_t iter = 0; iter < maxEMIter; iter++) {
         
+        // stop once the budget is used up
+        if (budgetExhausted(iterations, budget.maxIterations, budget.deadline))
+            break;
+        iterations++;
+        
         // shuffle indeces to select sequences in random order
-        random_shuffle(shuffled.begin(), shuffled.end());
+        shuffleIndices(shuffled, rng);
+        
+        bool changed = false;                   // whether any position changed in this iteration
         
-        for (vector<NumSequence>::size_type k = 0; k < numSeqs; k++) {
+        for (vector<size_t>::size_type k = 0; k < numSeqs; k++) {
             NumSequence::size_type zIndex = shuffled[k];                                    // select sequence z
-            counts->decount(sequences[zIndex], tempPositions[zIndex]);                      // remove z from counts
-            probs->construct(counts);                                                       // build models from remaining sequences counts
-            tempPositions[zIndex] = probs->samplePosition(sequences[zIndex], true);         // find new motif location in z (get max since it's EM)
-            if (probs->computePositionScore(sequences[zIndex], tempPositions[zIndex]) < filterThresh)
+            NumSequence::size_type previous = tempPositions[zIndex];
+            counts->decount(sequences, zIndex, tempPositions[zIndex]);                      // remove z from counts
+            probs->update(counts, sequences, zIndex, tempPositions[zIndex]);                // update models from remaining sequences counts
+            tempPositions[zIndex] = probs->samplePosition(sequences, zIndex, rng, true);         // find new motif location in z (get max since it's EM)
+            if (probs->computePositionScore(sequences, zIndex, tempPositions[zIndex]) < filterThresh)
                 tempPositions[zIndex] = NumSequence::npos;
-            counts->count(sequences[zIndex], tempPositions[zIndex]);                        // add new z info back to counts
+            if (tempPositions[zIndex] != previous)
+                changed = true;
+            counts->count(sequences, zIndex, tempPositions[zIndex]);                        // add new z info back to counts
+            probs->update(counts, sequences, zIndex, tempPositions[zIndex]);
         }
         
-        probs->construct(counts);
-        
-        // calculate alignment conditional log-likelihood
+        // calculate alignment conditional log-likelihood (models are kept current by updates)
         double tempScore = probs->computeCLL();
         
         if (tempScore > maxScore) {
             maxScore = tempScore;
             maxPositions = tempPositions;
+            stalled = 0;
         }
+        else
+            stalled++;
+        
+        // no position changed, so every motif is already at its best position given the
+        // others: further iterations would not change anything
+        if (!changed)
+            break;
+        
+        if (convergeAfter > 0 && stalled >= convergeAfter)
+            break;
     }
     
     
@@ -224,22 +403,24 @@ double MotifFinder::gibbsFinder(const vector<NumSequence> &sequences, vector<Num
 
 
 
-void MotifFinder::shiftPositions(const vector<NumSequence::size_type> &original, int shiftAmount, const vector<NumSequence> &sequences, vector<NumSequence::size_type> &result) {
+void MotifFinder::shiftPositions(const vector<NumSequence::size_type> &original, int shiftAmount, const SequenceBatch &sequences, vector<NumSequence::size_type> &result) {
     
     if (shiftAmount == 0) {
         result = original;
         return;
     }
     
-    vector<NumSequence>::size_type numSeqs = sequences.size();
+    SequenceBatch::size_type numSeqs = sequences.size();
     result.resize(numSeqs);
     
     for (size_t i = 0; i < numSeqs; i++) {
         
-        if (original[i] == NumSequence::npos)       // can't shift what isn't there :)
+        if (original[i] == NumSequence::npos) {     // can't shift what isn't there :)
+            result[i] = NumSequence::npos;
             continue;
+        }
         
-        Sequence::size_type maxMotifPos = sequences[i].size() - width + 1;     // get maximum valid motif position in sequence
+        Sequence::size_type maxMotifPos = sequences.length(i) - width + 1;     // get maximum valid motif position in sequence
         
         // if shift amount negative
         if (shiftAmount < 0) {
@@ -269,50 +450,62 @@ void MotifFinder::shiftPositions(const vector<NumSequence::size_type> &original,
 
 
 
-int MotifFinder::attemptShift(const vector<NumSequence> &sequences, const vector<NumSequence::size_type> &positions) {
+int MotifFinder::attemptShift(const SequenceBatch &sequences, const vector<NumSequence::size_type> &positions, CountModels *counts, ProbabilityModels *probs, RandomGenerator &rng) {
     
     int minShift = -2;      // minimum shift amount
     int maxShift = 2;       // maximum shift amount
     
     int numShifts = abs(minShift) + abs(maxShift) + 1;      // number of shifts to perform
     
-    CharNumConverter cnc(&this->alphabet);
-    NumAlphabetDNA numAlphabet(this->alphabet, cnc);
-    
     // hold shift scores (to sample from)
     vector<double> shiftScores (numShifts, 0);
+    vector<NumSequence::size_type> shiftedPositions;
+    vector<NumSequence::size_type> currentPositions (positions);
     
-    // for every shift
+    // for every shift, in increasing order (so that motifs move from the previous shift, rather
+    // than from their original positions and back)
     for (int shiftIdx = 0; shiftIdx < numShifts; shiftIdx++) {
         
         // get shift amount
         int shift = shiftIdx + minShift;
         
-        // shift motif positions
-        vector<Sequence::size_type> shiftedPositions;
+        // shift motif positions, and move motifs in counts and models accordingly
         shiftPositions(positions, shift, sequences, shiftedPositions);
-        
-        // construct new probability models from shifts
-        ProbabilityModels* probs = new ProbabilityModelsV1(numAlphabet, width, motifOrder, backOrder, pcounts, align);
-        probs->construct(sequences, shiftedPositions);
+        moveMotifs(sequences, currentPositions, shiftedPositions, counts, probs);
+        currentPositions.swap(shiftedPositions);
         
         // compute shift score
         shiftScores[shiftIdx] = probs->computeCLL();
-        
-        // free space for probabilities
-        delete probs;
     }
     
+    // move motifs back to their original positions
+    moveMotifs(sequences, currentPositions, positions, counts, probs);
     
-    // build a distribution from log-space scores
-    UnivariatePDF scoreDistribution (shiftScores, true);
-    
-    int shiftAmount = ((int) scoreDistribution.sample()) + minShift;
+    // sample directly from log-space scores
+    int shiftAmount = ((int) UnivariatePDF::sampleFromLogWeights(shiftScores, rng)) + minShift;
     return shiftAmount;
     
 }
 
 
+// move motifs in counts from one set of positions to another
+void MotifFinder::moveMotifs(const SequenceBatch &sequences, const vector<NumSequence::size_type> &from, const vector<NumSequence::size_type> &to, CountModels *counts, ProbabilityModels *probs) const {
+    
+    for (size_t i = 0; i < sequences.size(); i++) {
+        if (from[i] == to[i])
+            continue;
+        
+        counts->decount(sequences, i, from[i]);
+        if (probs != NULL)
+            probs->update(counts, sequences, i, from[i]);
+        
+        counts->count(sequences, i, to[i]);
+        if (probs != NULL)
+            probs->update(counts, sequences, i, to[i]);
+    }
+}
+
+
 
 
 
@@ -47,6 +47,16 @@ void NonUniformCounts::resetCounts() {
         fill(model[p].begin(), model[p].end(), 0);      // set all values to zero
 }
 
+// Add the counts of another model with the same structure
+void NonUniformCounts::add(const NonUniformCounts &other) {
+    if (other.order != order || other.model.size() != model.size())
+        throw invalid_argument("Cannot add counts of models with different structures");
+    
+    for (size_t p = 0; p < model.size(); p++)
+        for (size_t w = 0; w < model[p].size(); w++)
+            model[p][w] += other.model[p][w];
+}
+
 // initialize empty markov model
 void NonUniformCounts::initialize() {
     
@@ -8,6 +8,7 @@
 
 #include "NonUniformMarkov.hpp"
 #include "NonUniformCounts.hpp"
+#include "ModelWriter.hpp"
 
 #include <math.h>
 #include <limits>
@@ -220,6 +221,31 @@ string NonUniformMarkov::toString() const {
     return ssm.str();
 }
 
+// Write the model to a model writer, one row per key (same output as toString)
+void NonUniformMarkov::writeTable(ModelWriter &writer, const string &key) const {
+    
+    // make all positions the same order, as in toString
+    nonunif_joint_t joint = this->jointProbs;
+    for (size_t p = 0; p < joint.size(); p++) {
+        if (p < order)
+            getHigherOrderJoint((unsigned) p, this->jointProbs[p], order, joint[p]);
+    }
+    
+    size_t wordLength = order+1;
+    vector<double> row (joint.size());
+    
+    writer.beginTable(key);
+    for (size_t idx = 0; idx < joint[0].size(); idx++) {
+        NumSequence numSeq = this->indexToNumSequence(idx, wordLength);
+        
+        for (size_t p = 0; p < joint.size(); p++)
+            row[p] = joint[p][idx];
+        
+        writer.writeRow(alphabet->getCNC()->convert(numSeq.begin(), numSeq.end()), row.empty() ? NULL : &row[0], row.size());
+    }
+    writer.endTable();
+}
+
 
 // Initialize the model by allocating space, setting the keys, and setting counts to 0
 void NonUniformMarkov::initialize() {
@@ -20,7 +20,11 @@ using namespace gmsuite;
 NumAlphabetDNA::NumAlphabetDNA(const AlphabetDNA &alph, const CharNumConverter &cnc) {
     
     this->cnc = &cnc;
-
+    
+    std::fill(validElement, validElement + 256, false);
+    std::fill(ambiguousElement, ambiguousElement + 256, false);
+    for (size_t c = 0; c < 256; c++)
+        complementDNA[c] = (element_t) c;
     
     // get alph
     for (AlphabetDNA::const_iterator iter = alph.begin(); iter != alph.end(); iter++)
@@ -30,10 +34,16 @@ NumAlphabetDNA::NumAlphabetDNA(const AlphabetDNA &alph, const CharNumConverter &
     for (AlphabetDNA::const_iterator iter = alph.beginValid(); iter != alph.endValid(); iter++)
         this->alphValid.push_back(cnc.convert(*iter));
     
+    for (size_type i = 0; i < alphValid.size(); i++)
+        validElement[alphValid[i]] = true;
+    
     // get invalid alphabet
     for (AlphabetDNA::const_iterator iter = alph.beginInvalid(); iter != alph.endInvalid(); iter++)
         this->alphAmbiguous.push_back(cnc.convert(*iter));
     
+    for (size_type i = 0; i < alphAmbiguous.size(); i++)
+        ambiguousElement[alphAmbiguous[i]] = true;
+    
     // get DNA complement alphabet
     for (AlphabetDNA::const_iterator iter = alph.beginValid(); iter != alph.endValid(); iter++)
         this->complementDNA[cnc.convert(*iter)] = cnc.convert(alph.complement(*iter));
@@ -57,32 +67,7 @@ NumAlphabetDNA::size_type NumAlphabetDNA::sizeInvalid() const {
 
 // Check if alphabet contains a character
 bool NumAlphabetDNA::contains(element_t c) const {
-    return find(alph.begin(), alph.end(), c) != alph.end();
-}
-
-// Check if character is valid (i.e. non-ambiguous)
-bool NumAlphabetDNA::isValid(element_t c) const {
-    return find(alphValid.begin(), alphValid.end(), c) != alphValid.end();
-}
-
-
-// Check if character is ambiguous (i.e. N, R, S, ...)
-bool NumAlphabetDNA::isAmbiguous(element_t c) const {
-    return find(alphAmbiguous.begin(), alphAmbiguous.end(), c) != alphAmbiguous.end();
-}
-
-
-// complement a character
-NumAlphabetDNA::element_t NumAlphabetDNA::complement(element_t c) const {
-    map<element_t, element_t>::const_iterator it = complementDNA.find(c);     // find character complement
-    
-    // if character not found, return it as it is
-    if (it == complementDNA.end())
-        return c;
-    
-    // otherwise, return the complement
-    else
-        return it->second;
+    return validElement[c] || ambiguousElement[c];
 }
 
 
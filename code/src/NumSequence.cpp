@@ -12,6 +12,8 @@
 using std::invalid_argument;
 using namespace gmsuite;
 
+const NumSequence::size_type NumSequence::npos;
+
 // Default constructor: create an empty numeric sequence.
 NumSequence::NumSequence() {
     
@@ -23,6 +25,11 @@ NumSequence::NumSequence(const Sequence &sequence, const CharNumConverter &conve
     converter.convert(sequence.begin(), sequence.end(), this->numSeq);
 }
 
+// Constructor: create a numeric sequence from sequence text
+NumSequence::NumSequence(const char* begin, const char* end, const CharNumConverter &converter) {
+    converter.convertText(begin, end, this->numSeq);
+}
+
 // Constructor: create a numeric sequence from vector of num_t elements
 NumSequence::NumSequence(const vector<num_t> &numSequence) {
     this->numSeq = numSequence;
@@ -54,29 +61,7 @@ NumSequence NumSequence::subseq(size_type n, size_type length) const {
 
 // reverse complement in-place
 void NumSequence::reverseComplement(const CharNumConverter &cnc) {
-    
-    // if size zero, nothing to do :)
-    if (numSeq.size() == 0)
-        return;
-    
-    size_type left = 0;
-    size_type right = numSeq.size()-1;
-    
-    // for each position < N/2, swap the symmetric 'left' and 'right' elements, and complement each
-    // if N is even, the final left will be right before the final right
-    // if N is odd, an extra elements remains that needs to be complemented and "swapped" with itself
-    for (size_t n = 0; n < numSeq.size()/2; n++) {
-        num_t temp = numSeq[left];
-        numSeq[left] = cnc.complement(numSeq[right]);   // exchange and complement
-        numSeq[right] = cnc.complement(temp);           // exchange and complement
-        
-        left++;
-        right--;
-    }
-    
-    // if N is odd, complement the floor(N/2)'th element
-    if (numSeq.size() % 2 != 0)
-        numSeq[numSeq.size()/2] = cnc.complement(numSeq[numSeq.size()/2]);
+    cnc.reverseComplement(numSeq.begin(), numSeq.end());
 }
 
 
@@ -0,0 +1,96 @@
+//
+//  NumSequenceIndex.cpp
+//  GeneMark Suite
+//
+
+#include "NumSequenceIndex.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+using namespace std;
+using namespace gmsuite;
+
+#define BLOCK_SIZE 64
+
+// Build the index over a sequence
+NumSequenceIndex::NumSequenceIndex(const NumSequence &sequence, const NumAlphabetDNA &alph) : sequence(&sequence), length(sequence.size()) {
+    
+    NumSequence::num_t G = alph.getCNC()->convert('G');
+    NumSequence::num_t C = alph.getCNC()->convert('C');
+    
+    // one extra block, so that a count up to the end of the sequence never reads past the tables
+    size_type numBlocks = length / BLOCK_SIZE + 1;
+    
+    ambiguousBits.assign(numBlocks, 0);
+    ambiguousBefore.assign(numBlocks, 0);
+    gcBits.assign(numBlocks, 0);
+    gcBefore.assign(numBlocks, 0);
+    
+    size_type numAmbiguous = 0, numGC = 0;
+    for (size_type b = 0; b < numBlocks; b++) {
+        ambiguousBefore[b] = numAmbiguous;
+        gcBefore[b] = numGC;
+        
+        size_type begin = b * BLOCK_SIZE;
+        size_type end = std::min(begin + BLOCK_SIZE, length);
+        
+        block_t ambiguous = 0, gc = 0;
+        for (size_type i = begin; i < end; i++) {
+            NumSequence::num_t element = sequence[i];
+            ambiguous |= (block_t) alph.isAmbiguous(element) << (i - begin);
+            gc |= (block_t) (element == G || element == C) << (i - begin);
+        }
+        
+        ambiguousBits[b] = ambiguous;
+        gcBits[b] = gc;
+        numAmbiguous += __builtin_popcountll(ambiguous);
+        numGC += __builtin_popcountll(gc);
+    }
+}
+
+
+// number of marked elements before a position
+NumSequenceIndex::size_type NumSequenceIndex::rank(const vector<block_t> &bits, const vector<size_type> &before, size_type position) {
+    size_type block = position / BLOCK_SIZE;
+    block_t below = ((block_t) 1 << (position % BLOCK_SIZE)) - 1;
+    return before[block] + __builtin_popcountll(bits[block] & below);
+}
+
+// check that a window lies in the sequence
+void NumSequenceIndex::checkWindow(size_type left, size_type length) const {
+    if (left > this->length || length > this->length - left)
+        throw out_of_range("Window goes past the end of the sequence");
+}
+
+
+NumSequenceIndex::size_type NumSequenceIndex::numAmbiguous(size_type left, size_type length) const {
+    checkWindow(left, length);
+    return rank(ambiguousBits, ambiguousBefore, left + length) - rank(ambiguousBits, ambiguousBefore, left);
+}
+
+NumSequenceIndex::size_type NumSequenceIndex::numGC(size_type left, size_type length) const {
+    checkWindow(left, length);
+    return rank(gcBits, gcBefore, left + length) - rank(gcBits, gcBefore, left);
+}
+
+bool NumSequenceIndex::containsInvalid(size_type left, size_type length) const {
+    return numAmbiguous(left, length) > 0;
+}
+
+bool NumSequenceIndex::containsInvalid(const NumSequenceView &view) const {
+    if (view.getSequence() != sequence)
+        throw invalid_argument("View is not over the indexed sequence");
+    
+    // the reverse complement of an ambiguous element is ambiguous, so the strand doesn't matter
+    return containsInvalid(view.getOffset(), view.size());
+}
+
+double NumSequenceIndex::gc(size_type left, size_type length) const {
+    size_type count = numGC(left, length);
+    
+    if (length == 0)
+        return 0;
+    
+    return 100 * count / (double) length;
+}
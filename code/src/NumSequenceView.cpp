@@ -0,0 +1,85 @@
+//
+//  NumSequenceView.cpp
+//  GeneMark Suite
+//
+
+#include "NumSequenceView.hpp"
+#include <stdexcept>
+
+using std::invalid_argument;
+using namespace gmsuite;
+
+// Default constructor: create an empty view.
+NumSequenceView::NumSequenceView() {
+    sequence = NULL;
+    cnc = NULL;
+    offset = 0;
+    length = 0;
+    reverse = false;
+}
+
+// Constructor: create a view over part of a sequence.
+NumSequenceView::NumSequenceView(const NumSequence &sequence, const CharNumConverter &cnc, size_type offset, size_type length, bool reverseComplement) {
+
+    if (offset > sequence.size() || length > sequence.size() - offset)
+        throw invalid_argument("View cannot go past the end of the sequence.");
+
+    this->sequence = &sequence;
+    this->cnc = &cnc;
+    this->offset = offset;
+    this->length = length;
+    this->reverse = reverseComplement;
+}
+
+// begin const_iterator
+NumSequenceView::const_iterator NumSequenceView::begin() const {
+    return const_iterator(reverse ? sequenceEnd() : sequenceBegin(), reverse, cnc);
+}
+
+// end const_iterator
+NumSequenceView::const_iterator NumSequenceView::end() const {
+    return const_iterator(reverse ? sequenceBegin() : sequenceEnd(), reverse, cnc);
+}
+
+// start of window in the underlying sequence
+NumSequence::const_iterator NumSequenceView::sequenceBegin() const {
+    if (sequence == NULL)
+        return NumSequence::const_iterator();
+    return sequence->begin() + offset;
+}
+
+// end of window in the underlying sequence
+NumSequence::const_iterator NumSequenceView::sequenceEnd() const {
+    if (sequence == NULL)
+        return NumSequence::const_iterator();
+    return sequence->begin() + offset + length;
+}
+
+// get subview
+NumSequenceView NumSequenceView::subview(size_type n, size_type length) const {
+
+    if (n >= this->length)
+        throw invalid_argument("Input n should be less than view length.");
+
+    if (n + length > this->length)
+        throw invalid_argument("Input n+length should be less than or equal to view length.");
+
+    // on the negative strand, reading position n is counted from the right end of the window
+    size_type subOffset = (reverse ? offset + this->length - n - length : offset + n);
+    return NumSequenceView(*sequence, *cnc, subOffset, length, reverse);
+}
+
+// check for ambiguous elements; complements of ambiguous elements are ambiguous, so the strand doesn't matter
+bool NumSequenceView::containsInvalid(const NumAlphabetDNA &alph) const {
+    for (NumSequence::const_iterator element = sequenceBegin(); element != sequenceEnd(); element++) {
+        if (alph.isAmbiguous(*element))
+            return true;
+    }
+
+    return false;
+}
+
+// copy elements into a numeric sequence
+NumSequence NumSequenceView::toNumSequence() const {
+    return NumSequence(vector<num_t>(begin(), end()));
+}
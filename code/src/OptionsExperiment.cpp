@@ -9,6 +9,8 @@
 #include "OptionsExperiment.hpp"
 #include "NumSequence.hpp"
 #include <iostream>
+#include <sstream>
+#include <algorithm>
 
 using namespace std;
 using namespace gmsuite;
@@ -27,6 +29,7 @@ using namespace gmsuite;
 #define STR_PROMOTER_AND_RBS_MATCH "promoter-and-rbs-match"
 #define STR_RBS_CONSENSUS_AND_16S_MATCH "rbs-consensus-and-16s-match"
 #define STR_RBS_IS_LOCALIZED        "rbs-is-localized"
+#define STR_VALIDATE_GROUPS         "validate-groups"
 
 namespace gmsuite {
     // convert string to experiment_t
@@ -48,6 +51,7 @@ namespace gmsuite {
         else if (token == STR_PROMOTER_AND_RBS_MATCH)   unit = OptionsExperiment::PROMOTER_AND_RBS_MATCH;
         else if (token == STR_RBS_CONSENSUS_AND_16S_MATCH) unit = OptionsExperiment::RBS_CONSENSUS_AND_16S_MATCH;
         else if (token == STR_RBS_IS_LOCALIZED)         unit = OptionsExperiment::RBS_IS_LOCALIZED;
+        else if (token == STR_VALIDATE_GROUPS)          unit = OptionsExperiment::VALIDATE_GROUPS;
         else
             throw boost::program_options::invalid_option_value(token);
         
@@ -169,6 +173,8 @@ bool OptionsExperiment::parse(int argc, const char **argv) {
             addProcessOptions_RBSConsensusAnd16SMatch(rbsConsensusAnd16SMatch, expDesc);
         if (experiment == RBS_IS_LOCALIZED)
             addProcessOptions_RBSIsLocalized(rbsIsLocalized, expDesc);
+        if (experiment == VALIDATE_GROUPS)
+            addProcessOptions_ValidateGroups(validateGroups, expDesc);
         
         cmdline_options.add(expDesc);
         
@@ -190,6 +196,24 @@ bool OptionsExperiment::parse(int argc, const char **argv) {
         
         // update all values and make sure required are provided
         po::notify(vm);
+        
+        // only group-validation checks can be batched
+        if (experiment == VALIDATE_GROUPS) {
+            validateGroups.checks.clear();
+            for (size_t n = 0; n < validateGroups.checkNames.size(); n++) {
+                experiment_t check;
+                istringstream ssm (validateGroups.checkNames[n]);
+                ssm >> check;
+                
+                if (check != PROMOTER_IS_VALID_FOR_ARCHAEA && check != PROMOTER_IS_VALID_FOR_BACTERIA && check != RBS_IS_LOCALIZED
+                    && check != MATCH_RBS_TO_16S && check != PROMOTER_AND_RBS_MATCH && check != RBS_CONSENSUS_AND_16S_MATCH)
+                    throw boost::program_options::invalid_option_value(validateGroups.checkNames[n]);
+                if (std::find(validateGroups.checks.begin(), validateGroups.checks.end(), check) != validateGroups.checks.end())
+                    throw boost::program_options::error("check given more than once: " + validateGroups.checkNames[n]);
+                
+                validateGroups.checks.push_back(check);
+            }
+        }
     }
     catch (exception &ex) {
         cerr << "Error: " << ex.what() << endl;
@@ -292,13 +316,29 @@ void OptionsExperiment::addProcessOptions_ScoreStarts(ScoreStarts &options, po::
     
 }
 
-void OptionsExperiment::addProcessOptions_MatchRBSTo16SOptions(MatchRBSTo16S &options, po::options_description &processOptions) {
+void OptionsExperiment::addProcessOptions_MatchRBSTo16SOptions(MatchRBSTo16S &options, po::options_description &processOptions, string prefix) {
 //    Options::addProcessOptions_GenericOptions(options, processOptions);
+    
+    // prefixed options are part of a batch of checks, where only the selected checks need their files
+    po::typed_value<string> *matchTo = po::value<string>(&options.matchTo);
+    po::typed_value<string> *fnlabels = po::value<string>(&options.fnlabels);
+    if (prefix.empty()) {
+        matchTo->required();
+        fnlabels->required();
+    }
+    else
+        prefix += "-";
+    
+    string opt_matchTo      = prefix + "match-to";
+    string opt_fnlabels     = prefix + "fnlabels";
+    string opt_minMatch     = prefix + "min-match";
+    string opt_allowAGSub   = prefix + "allow-ag-sub";
+    
     processOptions.add_options()
-    ("match-to", po::value<string>(&options.matchTo)->required(), "Sequence to match to.")
-    ("fnlabels", po::value<string>(&options.fnlabels)->required(), "File containing gene labels with predicted RBS.")
-    ("min-match", po::value<unsigned>(&options.min16SMatch)->default_value(4), "Minimum number of consecutively matched nucleotides for a match to be considered as a match.")
-    ("allow-ag-sub", po::bool_switch(&options.allowAGSubstitution)->default_value(false), "Allow G to be substituted for A when matching to 16S tail")
+    (opt_matchTo.c_str(), matchTo, "Sequence to match to.")
+    (opt_fnlabels.c_str(), fnlabels, "File containing gene labels with predicted RBS.")
+    (opt_minMatch.c_str(), po::value<unsigned>(&options.min16SMatch)->default_value(4), "Minimum number of consecutively matched nucleotides for a match to be considered as a match.")
+    (opt_allowAGSub.c_str(), po::bool_switch(&options.allowAGSubstitution)->default_value(false), "Allow G to be substituted for A when matching to 16S tail")
     ;
     
 }
@@ -314,38 +354,81 @@ void OptionsExperiment::addProcessOptions_ScoreLabeledStarts(ScoreLabeledStarts
 
 
 
-void OptionsExperiment::addProcessOptions_PromoterIsValidForArchaea(PromoterIsValidForArchaea &options, po::options_description &processOptions) {
+void OptionsExperiment::addProcessOptions_PromoterIsValidForArchaea(PromoterIsValidForArchaea &options, po::options_description &processOptions, string prefix) {
+    
+    // prefixed options are part of a batch of checks, which share the batch's mod file
+    if (prefix.empty())
+        processOptions.add_options()
+        ("fnmod", po::value<string>(&options.fnmod)->required(), "Name of mod file containing RBS spacer.")
+        ;
+    else
+        prefix += "-";
+    
+    string opt_distThresh   = prefix + "dist-thresh";
+    string opt_scoreThresh  = prefix + "score-thresh";
+    string opt_windowSize   = prefix + "window-size";
+    
     processOptions.add_options()
-    ("fnmod", po::value<string>(&options.fnmod)->required(), "Name of mod file containing RBS spacer.")
-    ("dist-thresh", po::value<size_t>(&options.distanceThresh)->default_value(22), "Distance threshold after which spacer indicates promoter.")
-    ("score-thresh", po::value<double>(&options.scoreThresh)->default_value(0.1), "Minimum score above which spacer is considered localized.")
-    ("window-size", po::value<size_t>(&options.windowSize)->default_value(1), "Size of window in which to determine localization")
+    (opt_distThresh.c_str(), po::value<size_t>(&options.distanceThresh)->default_value(22), "Distance threshold after which spacer indicates promoter.")
+    (opt_scoreThresh.c_str(), po::value<double>(&options.scoreThresh)->default_value(0.1), "Minimum score above which spacer is considered localized.")
+    (opt_windowSize.c_str(), po::value<size_t>(&options.windowSize)->default_value(1), "Size of window in which to determine localization")
     ;
 }
 
-void OptionsExperiment::addProcessOptions_PromoterIsValidForBacteria(PromoterIsValidForBacteria &options, po::options_description &processOptions) {
+void OptionsExperiment::addProcessOptions_PromoterIsValidForBacteria(PromoterIsValidForBacteria &options, po::options_description &processOptions, string prefix) {
+    
+    // prefixed options are part of a batch of checks, which share the batch's mod file
+    if (prefix.empty())
+        processOptions.add_options()
+        ("fnmod", po::value<string>(&options.fnmod)->required(), "Name of mod file containing RBS spacer.")
+        ;
+    else
+        prefix += "-";
+    
+    string opt_distThresh           = prefix + "dist-thresh";
+    string opt_scoreThresh          = prefix + "score-thresh";
+    string opt_minLeaderlessPercent = prefix + "min-leaderless-percent";
+    string opt_minLeaderlessCount   = prefix + "min-leaderless-count";
+    string opt_windowSize           = prefix + "window-size";
+    string opt_fnlabels             = prefix + "fnlabels";
+    string opt_fnseq                = prefix + "fnseq";
+    string opt_minGeneLength        = prefix + "min-gene-length";
+    string opt_matchTo              = prefix + "match-to";
+    string opt_allowAGSubstitution  = prefix + "allow-ag-substitution";
+    string opt_matchThresh          = prefix + "match-thresh";
+    string opt_fgioDistanceThresh   = prefix + "fgio-distance-thresh";
+    
     processOptions.add_options()
-    ("fnmod", po::value<string>(&options.fnmod)->required(), "Name of mod file containing RBS spacer.")
-    ("dist-thresh", po::value<size_t>(&options.distanceThresh)->default_value(15), "Distance threshold before which spacer indicates promoter.")
-    ("score-thresh", po::value<double>(&options.scoreThresh)->default_value(0.1), "Minimum score above which spacer is considered localized.")
-    ("min-leaderless-percent", po::value<double>(&options.minLeaderlessPercent)->default_value(0.0), "Minimum percentage of leaderless transcripts")
-    ("min-leaderless-count", po::value<size_t>(&options.minLeaderlessCount)->default_value(0), "Minimum number of leaderless transcripts")
-    ("window-size", po::value<size_t>(&options.windowSize)->default_value(1), "Size of window in which to determine localization")
-    ("fnlabels", po::value<string>(&options.fnlabels)->default_value(""), "Labels file, if provided, is used to calculate number of leaderless and first-genes-in-operon")
-    ("fnseq", po::value<string> (&options.fnseq)->default_value(""), "Sequence file")
-    ("min-gene-length", po::value<NumSequence::size_type>(&options.minGeneLength)->default_value(300), "Minimum gene length allowed in training")
-    ("match-to", po::value<string>(&options.matchTo)->default_value("TAAGGAGGTGA"), "16S tail")
-    ("allow-ag-substitution", po::bool_switch(&options.allowAGSubstitution)->default_value(true), "Allow AG substitution.")
-    ("match-thresh", po::value<unsigned>(&options.matchThresh)->default_value(4), "Match threshold for 16S tail.")
-    ("fgio-distance-thresh", po::value<size_t>(&options.fgioDistThresh)->default_value(25), "Minimum distance between genes classified as first-genes-in-operon")
+    (opt_distThresh.c_str(), po::value<size_t>(&options.distanceThresh)->default_value(15), "Distance threshold before which spacer indicates promoter.")
+    (opt_scoreThresh.c_str(), po::value<double>(&options.scoreThresh)->default_value(0.1), "Minimum score above which spacer is considered localized.")
+    (opt_minLeaderlessPercent.c_str(), po::value<double>(&options.minLeaderlessPercent)->default_value(0.0), "Minimum percentage of leaderless transcripts")
+    (opt_minLeaderlessCount.c_str(), po::value<size_t>(&options.minLeaderlessCount)->default_value(0), "Minimum number of leaderless transcripts")
+    (opt_windowSize.c_str(), po::value<size_t>(&options.windowSize)->default_value(1), "Size of window in which to determine localization")
+    (opt_fnlabels.c_str(), po::value<string>(&options.fnlabels)->default_value(""), "Labels file, if provided, is used to calculate number of leaderless and first-genes-in-operon")
+    (opt_fnseq.c_str(), po::value<string> (&options.fnseq)->default_value(""), "Sequence file")
+    (opt_minGeneLength.c_str(), po::value<NumSequence::size_type>(&options.minGeneLength)->default_value(300), "Minimum gene length allowed in training")
+    (opt_matchTo.c_str(), po::value<string>(&options.matchTo)->default_value("TAAGGAGGTGA"), "16S tail")
+    (opt_allowAGSubstitution.c_str(), po::bool_switch(&options.allowAGSubstitution)->default_value(true), "Allow AG substitution.")
+    (opt_matchThresh.c_str(), po::value<unsigned>(&options.matchThresh)->default_value(4), "Match threshold for 16S tail.")
+    (opt_fgioDistanceThresh.c_str(), po::value<size_t>(&options.fgioDistThresh)->default_value(25), "Minimum distance between genes classified as first-genes-in-operon")
     ;
 }
 
 
-void OptionsExperiment::addProcessOptions_PromoterAndRBSMatchOptions(PromoterAndRBSMatch &options, po::options_description &processOptions) {
+void OptionsExperiment::addProcessOptions_PromoterAndRBSMatchOptions(PromoterAndRBSMatch &options, po::options_description &processOptions, string prefix) {
+    
+    // prefixed options are part of a batch of checks, which share the batch's mod file
+    if (prefix.empty())
+        processOptions.add_options()
+        ("fnmod", po::value<string>(&options.fnmod)->required(), "Name of mod file containing RBS spacer.")
+        ;
+    else
+        prefix += "-";
+    
+    string opt_matchThresh = prefix + "match-thresh";
+    
     processOptions.add_options()
-    ("fnmod", po::value<string>(&options.fnmod)->required(), "Name of mod file containing RBS spacer.")
-    ("match-thresh", po::value<size_t>(&options.numberOfMatches)->default_value(4), "Match threshold for 16S tail.")
+    (opt_matchThresh.c_str(), po::value<size_t>(&options.numberOfMatches)->default_value(4), "Match threshold for 16S tail.")
     ;
 }
 
@@ -391,23 +474,64 @@ void OptionsExperiment::addProcessOptions_StartModelStrategy2Options(StartModelS
 }
 
 
-void OptionsExperiment::addProcessOptions_RBSConsensusAnd16SMatch(RBSConsensusAnd16SMatch &options, po::options_description &processOptions){
+void OptionsExperiment::addProcessOptions_RBSConsensusAnd16SMatch(RBSConsensusAnd16SMatch &options, po::options_description &processOptions, string prefix){
+    
+    // prefixed options are part of a batch of checks, which share the batch's mod file
+    if (prefix.empty())
+        processOptions.add_options()
+        ("fnmod", po::value<string>(&options.fnmod)->required(), "Name of mod file containing RBS.")
+        ;
+    else
+        prefix += "-";
+    
+    string opt_matchThresh  = prefix + "match-thresh";
+    string opt_matchTo      = prefix + "match-to";
+    string opt_allowAGSub   = prefix + "allow-ag-sub";
+    
     processOptions.add_options()
-    ("fnmod", po::value<string>(&options.fnmod)->required(), "Name of mod file containing RBS.")
-    ("match-thresh", po::value<unsigned>(&options.matchThresh)->default_value(4), "Match threshold for 16S tail.")
-    ("match-to", po::value<string>(&options.matchTo)->default_value("TAAGGAGGTGA"), "16S tail")
-    ("allow-ag-sub",    po::bool_switch(&options.allowAGSubstitution)->default_value(true), "Allow G to be substituted for A when matching to 16S tail")
+    (opt_matchThresh.c_str(), po::value<unsigned>(&options.matchThresh)->default_value(4), "Match threshold for 16S tail.")
+    (opt_matchTo.c_str(), po::value<string>(&options.matchTo)->default_value("TAAGGAGGTGA"), "16S tail")
+    (opt_allowAGSub.c_str(),    po::bool_switch(&options.allowAGSubstitution)->default_value(true), "Allow G to be substituted for A when matching to 16S tail")
     ;
 }
 
 
 
 
-void OptionsExperiment::addProcessOptions_RBSIsLocalized(RBSIsLocalized &options, po::options_description &processOptions) {
+void OptionsExperiment::addProcessOptions_RBSIsLocalized(RBSIsLocalized &options, po::options_description &processOptions, string prefix) {
+    
+    // prefixed options are part of a batch of checks, which share the batch's mod file
+    if (prefix.empty())
+        processOptions.add_options()
+        ("fnmod", po::value<string>(&options.fnmod)->required(), "Name of mod file containing RBS spacer.")
+        ;
+    else
+        prefix += "-";
+    
+    string opt_distThresh   = prefix + "dist-thresh";
+    string opt_scoreThresh  = prefix + "score-thresh";
+    string opt_windowSize   = prefix + "window-size";
+    
+    processOptions.add_options()
+    (opt_distThresh.c_str(), po::value<size_t>(&options.distanceThresh)->default_value(15), "Distance threshold before which spacer indicates promoter.")
+    (opt_scoreThresh.c_str(), po::value<double>(&options.scoreThresh)->default_value(0.1), "Minimum score above which spacer is considered localized.")
+    (opt_windowSize.c_str(), po::value<size_t>(&options.windowSize)->default_value(1), "Size of window in which to determine localization")
+    ;
+}
+
+
+void OptionsExperiment::addProcessOptions_ValidateGroups(ValidateGroups &options, po::options_description &processOptions) {
     processOptions.add_options()
-    ("fnmod", po::value<string>(&options.fnmod)->required(), "Name of mod file containing RBS spacer.")
-    ("dist-thresh", po::value<size_t>(&options.distanceThresh)->default_value(15), "Distance threshold before which spacer indicates promoter.")
-    ("score-thresh", po::value<double>(&options.scoreThresh)->default_value(0.1), "Minimum score above which spacer is considered localized.")
-    ("window-size", po::value<size_t>(&options.windowSize)->default_value(1), "Size of window in which to determine localization")
+    ("fnmod", po::value<string>(&options.fnmod)->required(), "Name of mod file checked by all checks.")
+    ("checks", po::value<vector<string> >(&options.checkNames)->multitoken()->required(), "Checks to run, in the order their verdicts are printed: any of "
+        STR_PROMOTER_IS_VALID_FOR_ARCHAEA ", " STR_PROMOTER_IS_VALID_FOR_BACTERIA ", " STR_RBS_IS_LOCALIZED ", "
+        STR_MATCH_RBS_TO_16S ", " STR_PROMOTER_AND_RBS_MATCH ", " STR_RBS_CONSENSUS_AND_16S_MATCH ". Each check's options are those of its experiment, prefixed by its name (e.g. --" STR_RBS_IS_LOCALIZED "-dist-thresh).")
     ;
+    
+    addProcessOptions_PromoterIsValidForArchaea(options.promoterIsValidForArchaea, processOptions, STR_PROMOTER_IS_VALID_FOR_ARCHAEA);
+    addProcessOptions_PromoterIsValidForBacteria(options.promoterIsValidForBacteria, processOptions, STR_PROMOTER_IS_VALID_FOR_BACTERIA);
+    addProcessOptions_RBSIsLocalized(options.rbsIsLocalized, processOptions, STR_RBS_IS_LOCALIZED);
+    addProcessOptions_MatchRBSTo16SOptions(options.matchRBSTo16S, processOptions, STR_MATCH_RBS_TO_16S);
+    addProcessOptions_PromoterAndRBSMatchOptions(options.promoterAndRBSMatch, processOptions, STR_PROMOTER_AND_RBS_MATCH);
+    addProcessOptions_RBSConsensusAnd16SMatch(options.rbsConsensusAnd16SMatch, processOptions, STR_RBS_CONSENSUS_AND_16S_MATCH);
 }
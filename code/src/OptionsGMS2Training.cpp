@@ -119,6 +119,7 @@ bool OptionsGMS2Training::parse(int argc, const char *argv[]) {
         ("fn-sequence,s", po::value<string>(&fn_sequence)->required(), "Name of sequence file")
         ("fn-labels,l", po::value<string>(&fn_labels)->required(), "Name of labels file")
         ("fn-mod,m", po::value<string>(&fn_outmod)->required(), "Name of output model file")
+        ("num-threads", po::value<unsigned>(&numThreads)->default_value(1), "Number of threads used in training, shared between counting contigs and motif-search restarts")
         ;
         
         addProcessOptions(*this, config);
@@ -185,6 +186,10 @@ bool OptionsGMS2Training::parse(int argc, const char *argv[]) {
         // try parsing arguments.
         po::notify(vm);
         
+        // training has one thread budget; the motif finder's --threads sets it if --num-threads doesn't
+        if (vm["num-threads"].defaulted() && vm.count("threads") > 0 && !vm["threads"].defaulted())
+            numThreads = optionsMFinder.numThreads;
+        
     }
     catch (exception &ex) {
         cerr << "Error: " << ex.what() << endl;
@@ -7,6 +7,7 @@
 //
 
 #include "OptionsMFinder.hpp"
+#include "RandomGenerator.hpp"
 
 #include <vector>
 #include <limits.h>
@@ -41,7 +42,11 @@ namespace gmsuite {
 
 
 OptionsMFinder::OptionsMFinder(string mode) : Options(mode) {
-    
+    numThreads = 1;         // single-threaded unless set otherwise
+    seed = RandomGenerator::DEFAULT_SEED;
+    convergeAfter = 0;
+    timeBudget = 0;
+    iterBudget = 0;
 }
 
 
@@ -169,6 +174,11 @@ void OptionsMFinder::addProcessOptions(OptionsMFinder &optionsMFinder, po::optio
     string opt_shiftEvery   = prefix + "shift-every"    ;
     string opt_pcount       = prefix + "pcount"         ;
     string opt_filterThresh = prefix + "filter-thresh"  ;
+    string opt_threads      = prefix + "threads"        ;
+    string opt_seed         = prefix + "seed"           ;
+    string opt_convergeAfter= prefix + "converge-after" ;
+    string opt_timeBudget   = prefix + "time-budget"    ;
+    string opt_iterBudget   = prefix + "iter-budget"    ;
     
     
     processOptions.add_options()
@@ -182,6 +192,11 @@ void OptionsMFinder::addProcessOptions(OptionsMFinder &optionsMFinder, po::optio
     (opt_shiftEvery.c_str(),    po::value<unsigned> (&optionsMFinder.shiftEvery)->default_value(10), "Number of iterations before shifting motif")
     (opt_pcount.c_str(),        po::value<double>   (&optionsMFinder.pcounts)->default_value(1), "Pseudocounts")
     (opt_filterThresh.c_str(),  po::value<double>   (&optionsMFinder.filterThresh)->default_value(-std::numeric_limits<double>::infinity()), "Value for filtering out motifs with low score")
+    (opt_threads.c_str(),       po::value<unsigned> (&optionsMFinder.numThreads)->default_value(1), "Number of threads used to run restarts concurrently")
+    (opt_seed.c_str(),          po::value<unsigned long long> (&optionsMFinder.seed)->default_value(RandomGenerator::DEFAULT_SEED), "Seed of the random number generator")
+    (opt_convergeAfter.c_str(), po::value<unsigned> (&optionsMFinder.convergeAfter)->default_value(0), "Stop a round of iterations after this many iterations without improvement (0 to disable)")
+    (opt_timeBudget.c_str(),    po::value<double>   (&optionsMFinder.timeBudget)->default_value(0), "Wall-clock budget in seconds, spread across restarts (0 for none)")
+    (opt_iterBudget.c_str(),    po::value<unsigned> (&optionsMFinder.iterBudget)->default_value(0), "Budget of iterations, spread across restarts (0 for none)")
     ;
 }
 
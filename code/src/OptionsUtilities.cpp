@@ -7,6 +7,7 @@
 //
 
 #include "OptionsUtilities.hpp"
+#include "RandomGenerator.hpp"
 
 #include <vector>
 #include <fstream>
@@ -36,6 +37,7 @@ OptionsUtilities::OptionsUtilities(string mode) : Options(mode) {
 #define STR_EXTRACT_SC_PER_MOTIF_STATUS "extract-sc-per-motif-status"
 #define STR_COMPUTE_GC "compute-gc"
 #define STR_SEPARATE_FGIO_AND_IG "separate-fgio-and-ig"
+#define STR_CONVERT_MODEL "convert-model"
 
 namespace gmsuite {
     // convert string to utility_t
@@ -54,6 +56,7 @@ namespace gmsuite {
         else if (token == STR_EXTRACT_SC_PER_MOTIF_STATUS) unit = OptionsUtilities::EXTRACT_SC_PER_MOTIF_STATUS;
         else if (token == STR_COMPUTE_GC)               unit = OptionsUtilities::COMPUTE_GC;
         else if (token == STR_SEPARATE_FGIO_AND_IG)     unit = OptionsUtilities::SEPARATE_FGIO_AND_IG;
+        else if (token == STR_CONVERT_MODEL)            unit = OptionsUtilities::CONVERT_MODEL;
         else
             throw boost::program_options::invalid_option_value(token);
         
@@ -382,6 +385,21 @@ bool OptionsUtilities::parse(int argc, const char *argv[]) {
             opts.erase(opts.begin());       // erase mode
             opts.erase(opts.begin());       // erase command name
             
+            // Parse again...
+            po::store(po::command_line_parser(opts).options(utilDesc).run(), vm);
+        }
+        else if (utility == CONVERT_MODEL) {
+            po::options_description utilDesc (string(STR_CONVERT_MODEL) + " options");
+            addProcessOptions_ConvertModel(convertModel, utilDesc);
+            
+            cmdline_options.add(utilDesc);
+            
+            // Collect all the unrecognized options from the first pass. This will include the
+            // (positional) mode and command name, so we need to erase them
+            vector<string> opts = po::collect_unrecognized(parsed.options, po::include_positional);
+            opts.erase(opts.begin());       // erase mode
+            opts.erase(opts.begin());       // erase command name
+            
             // Parse again...
             po::store(po::command_line_parser(opts).options(utilDesc).run(), vm);
         }
@@ -457,6 +475,7 @@ void OptionsUtilities::addProcessOptions_EmitNonCoding(EmitNonCoding &options, p
         ("mod,m", po::value<string>(&options.fn_mod)->required(), "Model file containing non-coding model")
         ("out,o", po::value<string>(&options.fn_out)->required(), "Name of output file containing sequence")
         ("length,l", po::value<NumSequence::size_type>(&options.length)->required(), "Length of generated non-coding sequence")
+        ("seed", po::value<unsigned long long>(&options.seed)->default_value(RandomGenerator::DEFAULT_SEED), "Seed of the random number generator")
     ;
     
 }
@@ -517,4 +536,10 @@ void OptionsUtilities::addProcessOptions_SeparateFGIOAndIG(SeparateFGIOAndIG &op
     ;
 }
 
-
+void OptionsUtilities::addProcessOptions_ConvertModel(ConvertModel &options, po::options_description &processOptions) {
+    processOptions.add_options()
+    ("mod,m", po::value<string>(&options.fn_mod)->required(), "Model filename (text or binary image)")
+    ("out,o", po::value<string>(&options.fn_out)->required(), "Output filename")
+    ("binary", po::bool_switch(&options.binary)->default_value(false), "If set, the model is written as a binary image; otherwise as text")
+    ;
+}
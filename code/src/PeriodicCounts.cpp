@@ -48,6 +48,16 @@ void PeriodicCounts::resetCounts() {
         fill(model[p].begin(), model[p].end(), 0);          // set all values to zero
 }
 
+// Add the counts of another model with the same structure
+void PeriodicCounts::add(const PeriodicCounts &other) {
+    if (other.order != order || other.model.size() != model.size())
+        throw invalid_argument("Cannot add counts of models with different structures");
+    
+    for (size_t p = 0; p < model.size(); p++)
+        for (size_t w = 0; w < model[p].size(); w++)
+            model[p][w] += other.model[p][w];
+}
+
 // initialize empty markov model
 void PeriodicCounts::initialize() {
     
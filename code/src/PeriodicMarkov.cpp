@@ -8,6 +8,7 @@
 
 #include "PeriodicMarkov.hpp"
 #include "PeriodicCounts.hpp"
+#include "ModelWriter.hpp"
 
 #include <math.h>
 #include <limits>
@@ -222,6 +223,29 @@ string PeriodicMarkov::toString() const {
     return ssm.str();
 }
 
+// Write the model to a model writer, one row per key (same output as toString)
+void PeriodicMarkov::writeTable(ModelWriter &writer, const string &key) const {
+    
+    writer.beginTable(key);
+    
+    if (jointProbs.size() > 0) {
+        size_t wordLength = order+1;
+        vector<double> row (period);
+        
+        for (size_t idx = 0; idx < jointProbs[0][order].size(); idx++) {
+            NumSequence numSeq = this->indexToNumSequence(idx, wordLength);
+            
+            // convert frames to HMM frames, as in toString
+            for (size_t p = 0; p < period; p++)
+                row[p] = this->jointProbs[(p + (wordLength-1)) % period][order][idx];
+            
+            writer.writeRow(alphabet->getCNC()->convert(numSeq.begin(), numSeq.end()), row.empty() ? NULL : &row[0], row.size());
+        }
+    }
+    
+    writer.endTable();
+}
+
 
 
 
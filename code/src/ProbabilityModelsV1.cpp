@@ -16,6 +16,23 @@ using namespace std;
 using namespace gmsuite;
 
 
+// natural log of a count. Counts (with integer pseudocounts) are whole numbers, so their logs
+// are looked up in a cache, which keeps incremental updates free of log() calls.
+inline double ProbabilityModelsV1::logCount(double value) const {
+    size_t n = (size_t) value;
+    if (n == value && n < logCache.size())
+        return logCache[n];
+    return log(value);
+}
+
+
+// negated natural log of a count; a zero count yields -infinity (rather than +infinity), so that
+// windows containing it get a zero score
+inline double ProbabilityModelsV1::negLogCount(double value) const {
+    return (value != 0 ? -logCount(value) : -HUGE_VAL);
+}
+
+
 /**
  * Constructor
  */
@@ -37,6 +54,37 @@ ProbabilityModelsV1::ProbabilityModelsV1(const NumAlphabetDNA &alphabet, NumSequ
     if (align != MFinderModelParams::NONE) {
         positionDistribution = new UnivariatePDF();      // empty distribution
     }
+    
+    // setup scoring tables
+    source = NULL;
+    modelsCurrent = true;
+    markovPcounts = (int) pcounts;                      // Markov models take integer pseudocounts
+    elementEncodingSize = ceil(log2(alphabet.sizeValid()));
+    wordMask = 0;
+    for (size_t n = 0; n < elementEncodingSize * (motifOrder+1); n++) {
+        wordMask <<= 1;
+        wordMask |= 1;
+    }
+    backTotal = 0;
+    positionTotal = 0;
+    
+    // the background probability of the first letters of a motif comes from the joint distribution
+    // (up to motifOrder+1 letters), and from conditional probabilities afterwards
+    jointEnd = (motifOrder < width ? motifOrder : width-1);
+    
+    // background conditionals are split into a word term and a context term, so that a change in
+    // a word count only touches two entries; when the motif is at least motifOrder+1 long, the
+    // word term also serves as the (unnormalized) joint
+    scorer = new SlidingWindowScorer(width, motifOrder, alphabet);
+    backWordTable = scorer->addSharedTable(motifOrder+1);
+    backContextTable = scorer->addSharedTable(motifOrder);
+    backJointTable = (jointEnd == motifOrder ? backWordTable : scorer->addSharedTable(jointEnd+1));
+    
+    scorer->attachSharedTable(jointEnd, backJointTable);
+    for (size_t p = jointEnd+1; p < width; p++) {
+        scorer->attachSharedTable(p, backWordTable);
+        scorer->attachSharedTable(p, backContextTable);
+    }
 }
 
 /**
@@ -56,9 +104,12 @@ ProbabilityModelsV1::ProbabilityModelsV1(const ProbabilityModelsV1 &obj) {
     mMotifCounts = new NonUniformCounts(*obj.mMotifCounts);
     mBack = new UniformMarkov(*obj.mBack);
     
+    positionDistribution = NULL;
     if (align != MFinderModelParams::NONE)
         positionDistribution = new UnivariatePDF(*obj.positionDistribution);
-
+    
+    scorer = new SlidingWindowScorer(*obj.scorer);
+    copyTables(obj);
 }
 
 /**
@@ -82,14 +133,19 @@ ProbabilityModelsV1& ProbabilityModelsV1::operator=(const ProbabilityModelsV1& o
         delete mBack;
     if (positionDistribution != NULL)
         delete positionDistribution;
+    if (scorer != NULL)
+        delete scorer;
     
     mMotif = new NonUniformMarkov(*other.mMotif);
     mMotifCounts = new NonUniformCounts(*other.mMotifCounts);
     mBack = new UniformMarkov(*other.mBack);
     
+    positionDistribution = NULL;
     if (align != MFinderModelParams::NONE)
         positionDistribution = new UnivariatePDF(*other.positionDistribution);
     
+    scorer = new SlidingWindowScorer(*other.scorer);
+    copyTables(other);
     return *this;
 }
 
@@ -100,6 +156,7 @@ ProbabilityModelsV1::~ProbabilityModelsV1() {
     delete mMotif;
     delete mBack;
     delete mMotifCounts;
+    delete scorer;
     
     if (positionDistribution != NULL)
         delete positionDistribution;
@@ -112,7 +169,7 @@ ProbabilityModelsV1::~ProbabilityModelsV1() {
  * @param sequences the sequences
  * @param positions the positions of motifs in these sequences
  */
-void ProbabilityModelsV1::construct(const vector<NumSequence> &sequences, const vector<NumSequence::size_type> &positions) {
+void ProbabilityModelsV1::construct(const SequenceBatch &sequences, const vector<NumSequence::size_type> &positions) {
     // create counts
     CountModelsV1 *counts = new CountModelsV1(*alphabet, width, motifOrder, backOrder, align);
     counts->construct(sequences, positions);
@@ -120,6 +177,7 @@ void ProbabilityModelsV1::construct(const vector<NumSequence> &sequences, const
     construct(counts);
     
     delete counts;
+    source = NULL;              // counts no longer available for updates
 }
 
 
@@ -132,104 +190,278 @@ void ProbabilityModelsV1::construct(const vector<NumSequence> &sequences, const
 void ProbabilityModelsV1::construct(const CountModels* counts) {
     const CountModelsV1* countsV1 = dynamic_cast<const CountModelsV1*>(counts);
     
-    mMotif->construct(countsV1->mMotif, pcounts);               // create motif probabilities
-    (*mMotifCounts) = (*countsV1->mMotif);                      // copy motif counts
-    mBack->construct(countsV1->mBack, pcounts);                 // create background probabilities
-    
+    constructModels(countsV1);
     positionCounts = countsV1->positionCounts;                  // copy position counts
     
+    constructTables(countsV1);
+}
+
+
+// build the models (only read by toString; scoring works from the tables)
+void ProbabilityModelsV1::constructModels(const CountModelsV1 *counts) const {
+    
+    mMotif->construct(counts->mMotif, pcounts);                 // create motif probabilities
+    (*mMotifCounts) = (*counts->mMotif);                        // copy motif counts
+    mBack->construct(counts->mBack, pcounts);                   // create background probabilities
+    
     if (align != MFinderModelParams::NONE)
-        positionDistribution->construct(countsV1->positionCounts, false, pcounts);         // create position distribution
+        positionDistribution->construct(counts->positionCounts, false, pcounts);           // create position distribution
+    
+    modelsCurrent = true;
+}
+
+
+/**
+ * Update probabilities after a single motif has been counted or decounted
+ */
+void ProbabilityModelsV1::update(const CountModels* counts, const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos) {
+    
+    // nothing was counted for filtered-out sequences
+    if (pos == NumSequence::npos)
+        return;
+    
+    // if counts differ from those the tables were built from, do a full construction
+    if (counts != source || source == NULL) {
+        construct(counts);
+        return;
+    }
+    
+    modelsCurrent = false;
+    
+    SequenceBatch::const_iterator sequence = sequences.begin(n);
+    NumSequence::size_type length = sequences.length(n);
+    
+    // motif: one word per motif position
+    size_t wordIndex = 0;
+    for (size_t p = 0; p < width; p++) {
+        wordIndex = ((wordIndex << elementEncodingSize) + sequence[pos+p]) & wordMask;
+        updateMotifBlock(p, wordIndex);
+    }
+    
+    // background: only words overlapping the motif have changed
+    NumSequence::size_type begin, end;
+    source->backgroundRegion(length, pos, begin, end);
+    
+    wordIndex = 0;
+    for (size_t i = begin; i < end; i++) {
+        wordIndex = ((wordIndex << elementEncodingSize) + sequence[i]) & wordMask;
+        if (i >= begin + motifOrder)
+            updateBackgroundWord(wordIndex);
+    }
+    scorer->setOffset(logCount(backTotal));          // normalizes background joint entries
+    
+    // position
+    if (align == MFinderModelParams::LEFT)
+        updatePosition(pos);
+    else if (align == MFinderModelParams::RIGHT)
+        updatePosition(length - width - pos);
+}
+
 
+// copy scoring tables from another instance
+void ProbabilityModelsV1::copyTables(const ProbabilityModelsV1 &other) {
+    source = other.source;
+    modelsCurrent = other.modelsCurrent;
+    markovPcounts = other.markovPcounts;
+    elementEncodingSize = other.elementEncodingSize;
+    wordMask = other.wordMask;
+    jointEnd = other.jointEnd;
+    backWordTable = other.backWordTable;
+    backContextTable = other.backContextTable;
+    backJointTable = other.backJointTable;
+    motifLogCounts = other.motifLogCounts;
+    backCounts = other.backCounts;
+    backDenominators = other.backDenominators;
+    backTotal = other.backTotal;
+    positionLogWeights = other.positionLogWeights;
+    positionTotal = other.positionTotal;
+    logCache = other.logCache;
 }
 
 
-// a class to compute the score of an alignment from the markov models
-class ScoreComputer : public UniformMarkov, public NonUniformMarkov, public NonUniformCounts {
-    
-public:
-    ScoreComputer(const NonUniformMarkov *mMotif, const UniformMarkov *mBackground, const NonUniformCounts *mMotifCounts,
-                  const UnivariatePDF *positionDistribution, MFinderModelParams::align_t align,
-                  const vector<double> &positionCounts) : UniformMarkov(*mBackground), NonUniformMarkov(*mMotif), NonUniformCounts(*mMotifCounts)  {
-        
-        // raise order of background model to that of motif model
-        UniformMarkov::changeOrder(mMotif->getOrder());
-        
-        if (this->UniformMarkov::order != this->NonUniformMarkov::order)
-            throw logic_error("ScoreComputer: Orders of models should be the same.");
-        
-        this->positionDistribution = positionDistribution;
-        this->positionCounts = &positionCounts;
-        this->align = align;
+// build all scoring tables from counts
+void ProbabilityModelsV1::constructTables(const CountModelsV1 *counts) {
+    
+    source = counts;
+    size_t blockSize = alphabet->sizeValid();
+    
+    const vector<vector<double> > &motifCounts = counts->mMotif->model;
+    
+    // background counts and their normalizers: per context (block of words), and in total
+    backCounts = counts->mBack->model;
+    backDenominators.assign(backCounts.size() / blockSize, 0);
+    backTotal = 0;
+    for (size_t word = 0; word < backCounts.size(); word++) {
+        backDenominators[word / blockSize] += backCounts[word] + markovPcounts;
+        backTotal += backCounts[word] + markovPcounts;
     }
     
-    double computeScore() const {
-        double score = 0;
-        unsigned order = this->NonUniformMarkov::order;
-        
-        // for uniform model, get conditional pdf for every order <= "motif model order"
-        vector<vector<double> > mBackConditionals (order+1);
-        for (size_t n = 0; n < mBackConditionals.size()-1; n++) {
-            mBackConditionals[n] = this->UniformMarkov::jointProbs[n];      // copy joint
-            UniformMarkov::jointToMarkov(mBackConditionals[n]);             // convert joint to markov
+    // cache logs of counts up to twice the largest block denominator, so that the cache stays
+    // small (counts may grow as sequences are counted back in; larger counts fall back to log())
+    double maxDenominator = 0;
+    for (size_t context = 0; context < backDenominators.size(); context++)
+        maxDenominator = std::max(maxDenominator, backDenominators[context]);
+    for (size_t p = 0; p < motifCounts.size(); p++) {
+        for (size_t word = 0; word < motifCounts[p].size(); word += blockSize) {
+            double denominator = 0;
+            for (size_t i = word; i < word + blockSize; i++)
+                denominator += motifCounts[p][i] + markovPcounts;
+            maxDenominator = std::max(maxDenominator, denominator);
         }
-        
-        // for last one, just copy it
-        mBackConditionals[mBackConditionals.size()-1] = this->UniformMarkov::model;
-        
-        
-        
-        // for each position in motif model
-        for (NonUniformMarkov::nonunif_markov_t::size_type pos = 0; pos < this->NonUniformMarkov::model.size(); pos++) {
-            
-            // get size of word (i.e. depending on order and position)
-            size_t wordSize = order+1;
-            if (pos < order)
-                wordSize = pos+1;
-            
-            
-            
-            // for every word in that position
-            for (size_t word = 0; word < this->NonUniformMarkov::model[pos].size(); word++) {
-                double ratio = 0;
-                if (mBackConditionals[wordSize-1][word] != 0) {
-                    ratio = this->NonUniformMarkov::model[pos][word] / mBackConditionals[wordSize-1][word];
-                }
-                
-                if (ratio != 0)
-                    score += this->NonUniformCounts::model[pos][word] * log(ratio);
-            }
-        }
-        
-        if (align != MFinderModelParams::NONE) {
-    
-            // for each valid position in model
-            for (vector<double>::size_type p = 0; p < positionCounts->size(); p++) {
-                if ((*positionDistribution)[p] != 0)
-                    score += (*positionCounts)[p] * log((*positionDistribution)[p]);
-            }
+    }
+    
+    size_t cacheSize = 2 * (size_t) maxDenominator + 1;
+    if (logCache.size() < cacheSize) {
+        size_t oldSize = logCache.size();
+        logCache.resize(cacheSize);
+        for (size_t i = oldSize; i < cacheSize; i++)
+            logCache[i] = log((double) i);
+    }
+    
+    // motif conditionals: one block at a time
+    motifLogCounts.resize(motifCounts.size());
+    for (size_t p = 0; p < motifCounts.size(); p++) {
+        motifLogCounts[p].resize(motifCounts[p].size());
+        for (size_t word = 0; word < motifCounts[p].size(); word++)
+            motifLogCounts[p][word] = logCount(motifCounts[p][word] + markovPcounts);
+        for (size_t word = 0; word < motifCounts[p].size(); word += blockSize)
+            updateMotifBlock(p, word);
+    }
+    
+    // background words, contexts and joints
+    for (size_t word = 0; word < backCounts.size(); word++)
+        scorer->setShared(backWordTable, word, negLogCount(backCounts[word] + markovPcounts));
+    for (size_t context = 0; context < backDenominators.size(); context++)
+        scorer->setShared(backContextTable, context, logCount(backDenominators[context]));
+    
+    if (jointEnd < motifOrder) {
+        size_t suffixBits = elementEncodingSize * (motifOrder - jointEnd);
+        for (size_t word = 0; word < backCounts.size(); word += ((size_t) 1 << suffixBits))
+            updateBackgroundJoint(word);
+    }
+    
+    scorer->setOffset(logCount(backTotal));
+    
+    // position weights and normalizer
+    positionTotal = 0;
+    if (align != MFinderModelParams::NONE) {
+        positionLogWeights.resize(positionCounts.size());
+        for (size_t n = 0; n < positionCounts.size(); n++) {
+            double weight = positionCounts[n] + (pcounts > 0 ? pcounts : 0);
+            positionLogWeights[n] = logCount(weight);
+            positionTotal += weight;
         }
-
-        
-        return score;
     }
+}
+
+
+// recompute the block of motif conditional probabilities containing a word (whose count may have changed)
+void ProbabilityModelsV1::updateMotifBlock(size_t position, size_t word) {
+    
+    size_t blockSize = alphabet->sizeValid();
+    size_t blockStart = word - word % blockSize;
     
-private:
+    const vector<double> &counts = source->mMotif->model[position];
+    vector<double> &logCounts = motifLogCounts[position];
     
-    MFinderModelParams::align_t align;
-    const UnivariatePDF *positionDistribution;
-    const vector<double> *positionCounts;
+    logCounts[word] = logCount(counts[word] + markovPcounts);
     
-};
+    double denominator = 0;
+    for (size_t i = blockStart; i < blockStart + blockSize; i++)
+        denominator += counts[i] + markovPcounts;
+    
+    double logDenominator = logCount(denominator);
+    
+    for (size_t i = blockStart; i < blockStart + blockSize; i++)
+        scorer->set(position, i, (denominator != 0 ? logCounts[i] - logDenominator : -HUGE_VAL));
+}
+
+
+// copy the count of a background word, and update its entry and that of its context. The background
+// conditional log-probability of a word is the sum of the two: log(denominator) - log(count).
+void ProbabilityModelsV1::updateBackgroundWord(size_t word) {
+    
+    double delta = source->mBack->model[word] - backCounts[word];
+    if (delta == 0)
+        return;
+    
+    size_t context = word >> elementEncodingSize;
+    
+    backCounts[word] += delta;
+    backDenominators[context] += delta;
+    backTotal += delta;
+    
+    scorer->setShared(backWordTable, word, negLogCount(backCounts[word] + markovPcounts));
+    scorer->setShared(backContextTable, context, logCount(backDenominators[context]));
+    
+    if (jointEnd < motifOrder)
+        updateBackgroundJoint(word);
+}
+
+
+// copy the count of a motif position, and update the position normalizer
+void ProbabilityModelsV1::updatePosition(size_t idx) {
+    positionTotal += source->positionCounts[idx] - positionCounts[idx];
+    positionCounts[idx] = source->positionCounts[idx];
+    positionLogWeights[idx] = logCount(positionCounts[idx] + (pcounts > 0 ? pcounts : 0));
+}
+
+
+// recompute the background joint entry that marginalizes over a background word (only needed when
+// the motif is not longer than the background order). Entries are not normalized: the scorer offset
+// holds the log of the normalizer (backTotal).
+void ProbabilityModelsV1::updateBackgroundJoint(size_t word) {
+    
+    // marginalize over all words of motifOrder+1 letters that share the first jointEnd+1 letters
+    size_t suffixBits = elementEncodingSize * (motifOrder - jointEnd);
+    size_t prefix = word >> suffixBits;
+    size_t begin = prefix << suffixBits;
+    size_t end = (prefix + 1) << suffixBits;
+    
+    double joint = 0;
+    for (size_t i = begin; i < end; i++)
+        joint += backCounts[i] + markovPcounts;
+    
+    scorer->setShared(backJointTable, prefix, negLogCount(joint));
+}
+
+
+// position log-score of a motif, relative to a uniform distribution over positions
+double ProbabilityModelsV1::positionLogScore(const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos) const {
+    
+    if (align == MFinderModelParams::NONE)
+        return 0;
+    
+    size_t idx = (align == MFinderModelParams::LEFT ? pos : sequences.length(n) - width - pos);
+    
+    double score = positionLogWeights[idx] + log((double) positionCounts.size());
+    if (positionTotal > 0)
+        score -= log(positionTotal);
+    
+    return score;
+}
 
 
 /**
  * Compute conditional log-likelihood
  */
 double ProbabilityModelsV1::computeCLL() {
-
-    ScoreComputer scoreComputer(mMotif, mBack, mMotifCounts, positionDistribution, align, positionCounts);
-    return scoreComputer.computeScore();
+    
+    // the scoring tables are kept current by incremental updates, and hold the log-ratios of
+    // the motif and (raised-order) background conditionals, so the models need not be rebuilt
+    const NonUniformCounts *motifCounts = (source != NULL ? source->mMotif : mMotifCounts);
+    double score = scorer->scoreCounts(motifCounts->model);
+    
+    // position log-likelihood
+    if (align != MFinderModelParams::NONE && positionTotal > 0) {
+        double logTotal = log(positionTotal);
+        for (size_t p = 0; p < positionCounts.size(); p++) {
+            if (positionCounts[p] != 0)
+                score += positionCounts[p] * (positionLogWeights[p] - logTotal);
+        }
+    }
+    
+    return score;
     
     
 //    double score = 0;
@@ -272,82 +504,88 @@ double ProbabilityModelsV1::computeCLL() {
 /**
  * Compute the score for a given motif position
  *
- * @param sequence the sequence
+ * @param sequences the sequences
+ * @param n the row of the sequence
  * @param pos the position of the motif in the sequence
  */
-double ProbabilityModelsV1::computePositionScore(const NumSequence &sequence, NumSequence::size_type pos) {
-    // copute motif score
-    double motifScore = mMotif->evaluate(sequence.begin()+pos, sequence.begin()+pos+width);
+double ProbabilityModelsV1::computePositionScore(const SequenceBatch &sequences, SequenceBatch::size_type n, NumSequence::size_type pos) {
+    return exp(scorer->score(sequences.begin(n) + pos) + positionLogScore(sequences, n, pos));
+}
+
+
+// compute the log-scores of all valid motif positions in one pass over the sequence
+void ProbabilityModelsV1::computePositionLogScores(const SequenceBatch &sequences, SequenceBatch::size_type n, vector<double> &scores) const {
     
-    // compute background scores of motif
-    double backScore = mBack->evaluate(sequence.begin()+pos, sequence.begin()+pos+width);;
+    NumSequence::size_type length = sequences.length(n);
+    if (length < width)
+        throw std::invalid_argument("Sequence length cannot be shorter than motif width.");
     
-    // compute combined score
-    if (backScore == 0)
-        return 0;
+    scorer->scoreAll(sequences.begin(n), length, scores);
     
-    double score = motifScore / backScore;
+    if (align == MFinderModelParams::NONE)
+        return;
     
-    if (align != MFinderModelParams::NONE) {
-        if (align == MFinderModelParams::LEFT)
-            score *= (*positionDistribution)[pos];
-        else if (align == MFinderModelParams::RIGHT)
-            score *= (*positionDistribution)[sequence.size() - width - pos];
-        
-        score /= (1.0 / positionDistribution->size());          // normalize on uniform distribution
-    }
+    // add position log-scores, normalized on uniform distribution
+    double normalizer = log((double) positionCounts.size());
+    if (positionTotal > 0)
+        normalizer -= log(positionTotal);
     
-    return score;
+    size_t numPositions = scores.size();
+    for (size_t pos = 0; pos < numPositions; pos++) {
+        size_t idx = (align == MFinderModelParams::LEFT ? pos : length - width - pos);
+        scores[pos] += positionLogWeights[idx] + normalizer;
+    }
 }
 
 
 /**
  * Compute the scores for each valid motif position in the sequence
  *
- * @param sequence the sequence
+ * @param sequences the sequences
+ * @param n the row of the sequence
  * @param scores the output scores of all valid positions in the sequence
  */
-void ProbabilityModelsV1::computePositionScores(const NumSequence &sequence, vector<double> &scores) {
-    if (sequence.size() < width)
-        throw std::invalid_argument("Sequence length cannot be shorter than motif width.");
-    
-    Sequence::size_type numPositions = sequence.size() - width + 1;
+void ProbabilityModelsV1::computePositionScores(const SequenceBatch &sequences, SequenceBatch::size_type n, vector<double> &scores) {
     
-    scores.resize(numPositions, 0);
+    computePositionLogScores(sequences, n, scores);
     
-    for (Sequence::size_type pos = 0; pos < numPositions; pos++)
-        scores[pos] = computePositionScore(sequence, pos);
-
+    for (size_t pos = 0; pos < scores.size(); pos++)
+        scores[pos] = exp(scores[pos]);
 }
 
 
 /**
  * Sample the position for motif in sequences
  *
- * @param sequence the sequence
+ * @param sequences the sequences
+ * @param n the row of the sequence
  * @param getMax if set, the position with the highest probability is returned; otherwise it is sampled.
  *
  * @return the position of a motif
  */
-NumSequence::size_type ProbabilityModelsV1::samplePosition(const NumSequence &sequence, bool getMax) {
-    // compute all position scores
-    vector<double> scores;
-    computePositionScores(sequence, scores);
+NumSequence::size_type ProbabilityModelsV1::samplePosition(const SequenceBatch &sequences, SequenceBatch::size_type n, RandomGenerator &rng, bool getMax) {
+    // compute all position log-scores (into a reused buffer)
+    vector<double> &scores = positionScoreBuffer;
+    computePositionLogScores(sequences, n, scores);
     
     // if get max is on, simply get position of max score
     if (getMax) {
         return std::distance(scores.begin(), std::max_element(scores.begin(), scores.end()));
     }
     
-    // otherwise, build a distribution and then sample value
-    UnivariatePDF dist (scores);
-    return dist.sample();
+    // otherwise, sample directly from the log-space scores
+    return UnivariatePDF::sampleFromLogWeights(scores, rng);
 }
 
 /**
  * Get string representation of counting models
  */
 string ProbabilityModelsV1::toString() const {
+    
+    // models are not kept current by incremental updates
+    if (!modelsCurrent && source != NULL)
+        constructModels(source);
+    
     string output = "";
     
     output += mMotif->toString() + "\n\n";
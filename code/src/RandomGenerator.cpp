@@ -0,0 +1,53 @@
+//
+//  RandomGenerator.cpp
+//  GeneMark Suite
+//
+
+#include "RandomGenerator.hpp"
+
+using namespace gmsuite;
+
+
+const RandomGenerator::result_type RandomGenerator::DEFAULT_SEED;
+
+
+// Constructor: create a generator from a seed
+RandomGenerator::RandomGenerator(result_type seed) {
+    this->seed(seed);
+}
+
+
+// Reset the generator to the start of a seed's sequence
+void RandomGenerator::seed(result_type seed) {
+
+    initialSeed = seed;
+
+    // fill the state from splitmix64, which never yields an all-zero state
+    result_type x = seed;
+    for (size_t i = 0; i < 4; i++)
+        state[i] = splitmix(x);
+}
+
+
+// Create an independent generator for a stream
+RandomGenerator RandomGenerator::split(result_type stream) const {
+
+    // hash the seed and stream index together, so that nearby indices give unrelated seeds
+    result_type x = initialSeed;
+    result_type streamSeed = splitmix(x);
+
+    x = stream ^ streamSeed;
+    streamSeed ^= splitmix(x);
+
+    return RandomGenerator(streamSeed);
+}
+
+
+// Advance a splitmix64 state and return its next output
+RandomGenerator::result_type RandomGenerator::splitmix(result_type &x) {
+
+    result_type z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
@@ -78,75 +78,94 @@ NumSequence SequenceAlgorithms::longestCommonSubstring(const NumSequence &A, con
 
 
 
-NumSequence SequenceAlgorithms::longestMatchTo16S(const NumSequence &A, const NumSequence &B,
-                                                  std::pair<NumSequence::size_type, NumSequence::size_type>& positionsOfMatches,
-                                                  const std::vector<std::pair<NumSequence::num_t, NumSequence::num_t> >& subs) {
-    
-    // allocate space for LCS matrix
-    int** LCS = new int*[A.size()+1];
-    for (size_t i = 0; i <= A.size(); i++)
-        LCS[i] = new int[B.size()+1];
-    
-    // if A is empty, LCS of A,B=0
-    for (size_t i = 0; i <= B.size(); i++)
-        LCS[0][i] = 0;
-    
-    // if B is empty, LCS of A,B = 0
-    for (size_t i = 0; i <= A.size(); i++)
-        LCS[i][0] = 0;
-    
-    // fill the rest of the matrix
-    for (size_t i = 1; i <= A.size(); i++) {
-        for (size_t j = 1; j <= B.size(); j++) {
-            // match
-            bool match = (A[i-1] == B[j-1]);
-            for (size_t n = 0; n < subs.size(); n++) {
-                if (A[i-1] == subs[n].first && B[j-1] == subs[n].second)
-                    match |= true;
-            }
+namespace {
+    
+    // Longest match of A in B, for any B with size() and operator[] (a sequence or a view)
+    template <class SequenceB>
+    NumSequence longestMatch(const NumSequence &A, const SequenceB &B,
+                             std::pair<NumSequence::size_type, NumSequence::size_type>& positionsOfMatches,
+                             const std::vector<std::pair<NumSequence::num_t, NumSequence::num_t> >& subs) {
+    
+        // allocate space for LCS matrix
+        int** LCS = new int*[A.size()+1];
+        for (size_t i = 0; i <= A.size(); i++)
+            LCS[i] = new int[B.size()+1];
+    
+        // if A is empty, LCS of A,B=0
+        for (size_t i = 0; i <= B.size(); i++)
+            LCS[0][i] = 0;
+    
+        // if B is empty, LCS of A,B = 0
+        for (size_t i = 0; i <= A.size(); i++)
+            LCS[i][0] = 0;
+    
+        // fill the rest of the matrix
+        for (size_t i = 1; i <= A.size(); i++) {
+            for (size_t j = 1; j <= B.size(); j++) {
+                // match
+                bool match = (A[i-1] == B[j-1]);
+                for (size_t n = 0; n < subs.size(); n++) {
+                    if (A[i-1] == subs[n].first && B[j-1] == subs[n].second)
+                        match |= true;
+                }
             
-            if (match) {
-                LCS[i][j] = LCS[i-1][j-1] + 1;
-            }
-            // mismatch
-            else {
-                LCS[i][j] = 0;
+                if (match) {
+                    LCS[i][j] = LCS[i-1][j-1] + 1;
+                }
+                // mismatch
+                else {
+                    LCS[i][j] = 0;
+                }
             }
         }
-    }
     
-    size_t maxSubstringSize = 0;
-    size_t posOfMaxInA = 0;
-    size_t posOfMaxInB = 0;
-    // find the maximum element in the matrix
-    for (size_t i = 1; i <= A.size(); i++) {
-        for (size_t j = 1; j <= B.size(); j++) {
-            if (maxSubstringSize < LCS[i][j]) {
-                maxSubstringSize = LCS[i][j];
-                posOfMaxInA = i-1;
-                posOfMaxInB = j-1;
+        size_t maxSubstringSize = 0;
+        size_t posOfMaxInA = 0;
+        size_t posOfMaxInB = 0;
+        // find the maximum element in the matrix
+        for (size_t i = 1; i <= A.size(); i++) {
+            for (size_t j = 1; j <= B.size(); j++) {
+                if (maxSubstringSize < LCS[i][j]) {
+                    maxSubstringSize = LCS[i][j];
+                    posOfMaxInA = i-1;
+                    posOfMaxInB = j-1;
+                }
             }
         }
-    }
     
-    // extract substring from either sequence
-    vector<NumSequence::num_t> result (maxSubstringSize);
+        // extract substring from either sequence
+        vector<NumSequence::num_t> result (maxSubstringSize);
     
-    for (size_t i = 0; i < maxSubstringSize; i++) {
-        result[i] = B[posOfMaxInB - (maxSubstringSize-1) + i];
-    }
+        for (size_t i = 0; i < maxSubstringSize; i++) {
+            result[i] = B[posOfMaxInB - (maxSubstringSize-1) + i];
+        }
     
-    // set matched positions
-    positionsOfMatches.first = posOfMaxInA - (maxSubstringSize-1);
-    positionsOfMatches.second = posOfMaxInB - (maxSubstringSize-1);
+        // set matched positions
+        positionsOfMatches.first = posOfMaxInA - (maxSubstringSize-1);
+        positionsOfMatches.second = posOfMaxInB - (maxSubstringSize-1);
     
-    // delete LCS allocation
-    for (size_t i = 0; i < A.size(); i++)
-        delete [] LCS[i];
-    delete [] LCS;
+        // delete LCS allocation
+        for (size_t i = 0; i < A.size(); i++)
+            delete [] LCS[i];
+        delete [] LCS;
     
     
-    return NumSequence(result);
+        return NumSequence(result);
+    }
+}
+
+
+NumSequence SequenceAlgorithms::longestMatchTo16S(const NumSequence &A, const NumSequence &B,
+                                                  std::pair<NumSequence::size_type, NumSequence::size_type>& positionsOfMatches,
+                                                  const std::vector<std::pair<NumSequence::num_t, NumSequence::num_t> >& subs) {
+    return longestMatch(A, B, positionsOfMatches, subs);
+}
+
+
+NumSequence SequenceAlgorithms::longestMatchTo16S(const NumSequence &A, const NumSequenceView &B,
+                                                  std::pair<NumSequence::size_type, NumSequence::size_type>& positionsOfMatches,
+                                                  const std::vector<std::pair<NumSequence::num_t, NumSequence::num_t> >& subs) {
+    return longestMatch(A, B, positionsOfMatches, subs);
 }
 
 
@@ -196,6 +215,23 @@ void SequenceAlgorithms::computeGC(const Sequence &seq, const vector<Label*> &la
     }
 }
 
+// compute GC per gene, from the sequence's prefix counts
+void SequenceAlgorithms::computeGC(const NumSequenceIndex &index, const vector<Label*> &labels, vector<double> &gcs) {
+    
+    gcs.clear();
+    gcs.reserve(labels.size());
+    
+    for (size_t n = 0; n < labels.size(); n++) {
+        size_t left = labels[n]->left;
+        size_t right = labels[n]->right;
+        
+        if (left <= right && right < index.size())
+            gcs.push_back(index.gc(left, right - left + 1));
+        else
+            gcs.push_back(0);           // GC=0 for invalid ranges (to maintain equal vector lengths of labels and gcs)
+    }
+}
+
 
 
 
@@ -0,0 +1,96 @@
+//
+//  SequenceBatch.cpp
+//  GeneMark Suite
+//
+
+#include "SequenceBatch.hpp"
+#include <stdexcept>
+#include <algorithm>
+
+using std::invalid_argument;
+using namespace gmsuite;
+
+// Constructor: create an empty batch
+SequenceBatch::SequenceBatch(size_type stride) {
+    this->rowStride = stride;
+}
+
+// Constructor: create a batch from sequences
+SequenceBatch::SequenceBatch(const vector<NumSequence> &sequences) {
+
+    rowStride = 0;
+    for (size_t n = 0; n < sequences.size(); n++)
+        rowStride = std::max(rowStride, sequences[n].size());
+
+    reserve(sequences.size());
+    for (size_t n = 0; n < sequences.size(); n++)
+        push_back(sequences[n]);
+}
+
+// Constructor: create a batch from sequence views
+SequenceBatch::SequenceBatch(const vector<NumSequenceView> &sequences) {
+
+    rowStride = 0;
+    for (size_t n = 0; n < sequences.size(); n++)
+        rowStride = std::max(rowStride, sequences[n].size());
+
+    reserve(sequences.size());
+    for (size_t n = 0; n < sequences.size(); n++)
+        push_back(sequences[n]);
+}
+
+// Reserve space for a number of rows
+void SequenceBatch::reserve(size_type numRows) {
+    data.reserve(numRows * rowStride);
+    lengths.reserve(numRows);
+    valid.reserve(numRows);
+}
+
+// Append a sequence
+void SequenceBatch::push_back(const NumSequence &sequence, bool valid) {
+
+    if (sequence.size() > rowStride)
+        throw invalid_argument("Sequence cannot be longer than the batch stride.");
+
+    data.insert(data.end(), sequence.begin(), sequence.end());
+    data.resize(data.size() + rowStride - sequence.size(), 0);         // pad row to stride
+
+    lengths.push_back(sequence.size());
+    this->valid.push_back(valid);
+}
+
+// Append a sequence view
+void SequenceBatch::push_back(const NumSequenceView &sequence, bool valid) {
+
+    if (sequence.size() > rowStride)
+        throw invalid_argument("Sequence cannot be longer than the batch stride.");
+
+    data.insert(data.end(), sequence.begin(), sequence.end());
+    data.resize(data.size() + rowStride - sequence.size(), 0);         // pad row to stride
+
+    lengths.push_back(sequence.size());
+    this->valid.push_back(valid);
+}
+
+// Mark rows with ambiguous letters as invalid
+void SequenceBatch::invalidateAmbiguous(const NumAlphabetDNA &alph) {
+
+    for (size_type n = 0; n < size(); n++) {
+        for (const_iterator element = begin(n); element != end(n); element++) {
+            if (alph.isAmbiguous(*element)) {
+                valid[n] = false;
+                break;
+            }
+        }
+    }
+}
+
+// Get the number of valid rows
+SequenceBatch::size_type SequenceBatch::numValid() const {
+    return std::count(valid.begin(), valid.end(), (char) true);
+}
+
+// Copy a row into a numeric sequence
+NumSequence SequenceBatch::toNumSequence(size_type n) const {
+    return NumSequence(vector<num_t>(begin(n), end(n)));
+}
@@ -8,6 +8,7 @@
 
 #include "SequenceFile.hpp"
 #include <assert.h>
+#include <string.h>
 
 #include <fstream>
 
@@ -20,8 +21,10 @@ using namespace gmsuite;
 bool containsFastaDefLine(const char* const begin, const char* const end);      // check for fasta definition at start of file
 
 // read file per format
-string readNextFastaDefLine(const char*& current, const char* const end);
-string readNextFastaSequence(const char*& current, const char* const end);
+void readNextFastaDefLine(const char*& current, const char* const end, SequenceFile::record_t &record);
+void readNextFastaSequence(const char*& current, const char* const end, SequenceFile::record_t &record);
+void readNextPlainLine(const char*& current, const char* const end, SequenceFile::record_t &record);
+string recordSequence(const SequenceFile::record_t &record);
 
 // write file per format
 void writeNextFastaDefLine(const char*& current, const char* const end);
@@ -95,25 +98,78 @@ void SequenceFile::read(vector<Sequence> &output) const {
 }
 
 
+// read the first sequence from file (remaining records are not parsed)
 Sequence SequenceFile::read() const {
     
-    // read based on format set
-    if (this->format == FASTA) {
-        
-        // FIXME: Make this step more efficient and stable. No need to read all fasta defs
-        vector<Sequence> output;
-        read_fasta(output);
-        if (output.size() > 0)
-            return output[0];
+    const char* current = begin_read;
+    record_t record;
+    
+    if (readNextRecord(current, record))
+        return Sequence(recordSequence(record), record.definition());
+    
+    return Sequence();
+}
+
+
+// read the first sequence from file, in numeric form
+NumSequence SequenceFile::read(const CharNumConverter &cnc) const {
+    
+    const char* current = begin_read;
+    record_t record;
+    
+    if (readNextRecord(current, record))
+        return NumSequence(record.seqBegin, record.seqEnd, cnc);
+    
+    return NumSequence();
+}
+
+
+// read all sequences from file, in numeric form
+void SequenceFile::read(vector<NumSequence> &output, vector<string> &identifiers, const CharNumConverter &cnc) const {
+    
+    output.clear();
+    identifiers.clear();
+    
+    const char* current = begin_read;
+    record_t record;
+    
+    while (readNextRecord(current, record)) {
+        output.push_back(NumSequence(record.seqBegin, record.seqEnd, cnc));
+        identifiers.push_back(record.identifier());
     }
-    else if (this->format == PLAIN) {
-        vector<Sequence> output;
-        read_plain(output);
-        if (output.size() > 0)
-            return output[0];
+}
+
+
+// first word of the record's definition
+string SequenceFile::record_t::identifier() const {
+    
+    const char* end = defBegin;
+    while (end != defEnd && !isspace(*end))
+        end++;
+    
+    return string(defBegin, end);
+}
+
+
+// read the next record, based on format set
+bool SequenceFile::readNextRecord(const char* &current, record_t &record) const {
+    
+    // skip all space characters
+    while (current != end_read && isspace(*current))
+        current++;
+    
+    // if reached end of file, no records remain
+    if (current == end_read)
+        return false;
+    
+    if (this->format == FASTA) {
+        readNextFastaDefLine(current, end_read, record);
+        readNextFastaSequence(current, end_read, record);
     }
+    else
+        readNextPlainLine(current, end_read, record);
     
-    return Sequence();
+    return true;
 }
 
 
@@ -209,28 +265,15 @@ bool containsFastaDefLine(const char* const begin, const char* const end) {
 // read sequences from fasta file. This assumes that the file is indeed in FASTA format (i.e. check first)
 void SequenceFile::read_fasta(vector<Sequence> &output) const{
     
-    string fastaDef;        // stores single fasta definition
-    string fastaSeq;        // stores single fasta sequence
-    
     output.clear();         // clear output vector (sanity check)
     
     // point to start of data
     const char *  current = begin_read;
+    record_t record;
     
-    // loop over all file
-    while (current != end_read) {
-        
-        // read next fasta definition line
-        fastaDef = readNextFastaDefLine(current, end_read);
-        
-        // read (entire) fasta sequence. This may constitute multiple
-        // lines. The function will read until the next fasta header definition
-        // is found
-        fastaSeq = readNextFastaSequence(current, end_read);
-        
-        // create new sequence and add it to the output vector
-        output.push_back(Sequence(fastaSeq, fastaDef));
-    }
+    // loop over all records, and create a sequence from each
+    while (readNextRecord(current, record))
+        output.push_back(Sequence(recordSequence(record), record.definition()));
     
 }
 
@@ -238,34 +281,15 @@ void SequenceFile::read_fasta(vector<Sequence> &output) const{
 
 void SequenceFile::read_plain(vector<Sequence> &output) const {
     
-    string seq;        // stores single sequence
-    
     output.clear();         // clear output vector (sanity check)
     
     // point to start of data
     const char *  current = begin_read;
+    record_t record;
     
-    // loop over all file
-    while (current != end_read) {
-        
-        // skip all newline characters
-        while (current != end_read && isspace(*current))
-            current++;
-        
-        // if reached end of file, break
-        if (current == end_read)
-            break;
-        
-        // otherwise, read line
-        const char* startOfLine = current;
-        while (current != end_read && *current != '\n' && *current != '\r')
-            current++;
-        
-        const char* endOfLine = current;
-        
-        // create new sequence and add it to the output vector
-        output.push_back(Sequence(string(startOfLine, endOfLine)));
-    }
+    // loop over all lines, and create a sequence from each
+    while (readNextRecord(current, record))
+        output.push_back(Sequence(string(record.seqBegin, record.seqEnd)));
 
     
 }
@@ -275,114 +299,66 @@ void SequenceFile::read_plain(vector<Sequence> &output) const {
 
 
 
-
-string readNextFastaDefLine(const char*& current, const char* const end) {
-    string output = "";
+// read the definition line of a record; current should be at the first non-space character
+void readNextFastaDefLine(const char*& current, const char* const end, SequenceFile::record_t &record) {
     
-    // skip starting all space characters
-    while (current != end && isspace(*current))
-        current++;
+    record.defBegin = record.defEnd = current;
     
-    // if we've reached the end of the file or the first non-space character is NOT a '>'
-    // then this is not a FASTA file
+    // if the first non-space character is NOT a '>', then the record has no definition
     if (current == end || *current != '>')
-        return output;
+        return;
     
     // the current character is now '>'. Skip it
     current++;
-    const char* startOfDef = current;                   // beginning of fasta definition line
+    record.defBegin = current;                          // beginning of fasta definition line
     
     // read the remaining definition line until newline character is reached
     while (current != end && *current != '\n' && *current != '\r')
         current++;
     
-    const char* endOfDef = current;
-    
-    // create string from fasta definition
-    output = string(startOfDef, endOfDef);
-    
-    return output;
+    record.defEnd = current;
 }
 
-string readNextFastaSequence(const char*& current, const char* const end) {
-    string output = "";
+
+// read the sequence text of a record: all characters until the next '>' character, or the end of file
+void readNextFastaSequence(const char*& current, const char* const end, SequenceFile::record_t &record) {
     
     // skip starting all space characters
     while (current != end && isspace(*current))
         current++;
     
-    // if we've reached the end of the file or the first non-space character IS a '>'
-    // then no sequence exists
-    if (current == end || *current == '>')
-        return output;
-    
-    // the current character is now the first character of the sequence
-    const char* startOfLine = current;
-    
-    // read the remaining sequence lines until the next '>' character is reached, or the end of file is reached
-    while (current != end && *current != '>') {
-        
-        // if the character is an whitespace (or newline, ...) then extract the current fragment
-        if (isspace(*current)) {
-            
-            output += string(startOfLine, current);     // extract fragment and append it to existing fragments
-            
-            current++;
-            // skip all whitespaces
-            while (current != end && isspace(*current))
-                current++;
-            
-            startOfLine = current;          // new line
-        }
-        // otherwise, character is element of sequence
-        else {
-            current++;
-        }
-    }
+    record.seqBegin = current;
     
-    // append the last batch of characters (if any)
-    output += string(startOfLine, current);
+    const char* next = (const char*) memchr(current, '>', end - current);
+    current = (next == NULL ? end : next);
     
-    return output;
+    record.seqEnd = current;
 }
 
 
+// read a single line as the sequence of a record
+void readNextPlainLine(const char*& current, const char* const end, SequenceFile::record_t &record) {
+    
+    record.defBegin = record.defEnd = current;
+    record.seqBegin = current;
+    
+    while (current != end && *current != '\n' && *current != '\r')
+        current++;
+    
+    record.seqEnd = current;
+}
 
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+// copy the sequence text of a record, without whitespace
+string recordSequence(const SequenceFile::record_t &record) {
+    
+    string output;
+    output.reserve(record.seqEnd - record.seqBegin);
+    
+    for (const char* current = record.seqBegin; current != record.seqEnd; current++) {
+        if (!isspace(*current))
+            output.push_back(*current);
+    }
+    
+    return output;
+}
@@ -7,6 +7,7 @@
 //
 
 #include "SequenceParser.hpp"
+#include "LabelIndex.hpp"
 #include <cstdlib>
 #include <stdexcept>
 #include <iostream>
@@ -15,8 +16,23 @@ using namespace std;
 using namespace gmsuite;
 
 
+// Extract upstream sequences, as copies
 void SequenceParser::extractUpstreamSequences(const NumSequence& sequence, const vector<Label*> &labels, const CharNumConverter &cnc, NumSequence::size_type upstrLength, vector<NumSequence> &upstreamRegions, bool allowOverlapWithCDS, size_t minimumGeneLength, const vector<bool> &use) {
     
+    if (sequence.size() == 0)
+        return;
+    
+    vector<NumSequenceView> views;
+    extractUpstreamSequences(sequence, labels, cnc, upstrLength, views, allowOverlapWithCDS, minimumGeneLength, use);
+    
+    upstreamRegions.resize(views.size());
+    for (size_t n = 0; n < views.size(); n++)
+        upstreamRegions[n] = views[n].toNumSequence();
+}
+
+// Extract upstream sequences, as views over the sequence
+void SequenceParser::extractUpstreamSequences(const NumSequence& sequence, const vector<Label*> &labels, const CharNumConverter &cnc, NumSequence::size_type upstrLength, vector<NumSequenceView> &upstreamRegions, bool allowOverlapWithCDS, size_t minimumGeneLength, const vector<bool> &use) {
+    
     if (sequence.size() == 0)
         return;
     
@@ -25,6 +41,9 @@ void SequenceParser::extractUpstreamSequences(const NumSequence& sequence, const
         useAll = false;
     }
     
+    // neighbors are looked up in an index, so labels need not be sorted
+    LabelIndex index (labels);
+    
     // extract upstream region, and reverse complement when on negative strand
     upstreamRegions.resize(labels.size());
     
@@ -37,26 +56,10 @@ void SequenceParser::extractUpstreamSequences(const NumSequence& sequence, const
             if (labels[n]->right - labels[n]->left + 1 < minimumGeneLength)
                 skip = true;
             
+            // skip if overlapping with CDS: the upstream region must lie between the label and its nearest upstream gene
             if (!allowOverlapWithCDS) {
-                // skip if overlapping with CDS
-                if (labels[n]->strand == Label::NEG) {
-                    // boundaryRight is either end of sequence (if this is the last label), or the left-end of the gene to the "right" of the current gene
-                    size_t boundaryRight = (n == labels.size()-1 ? sequence.size()-1 : labels[n+1]->left-1);
-                    size_t boundaryLeft = labels[n]->right + 1;
-                    
-                    size_t length = (boundaryRight > boundaryLeft ? boundaryRight - boundaryLeft + 1 : 0);
-                    if (length < upstrLength)
-                        skip = true;
-                }
-                else {
-                    // boundaryLeft is either start of sequence (if this is the first label), or the right-end of the gene to the "left" of the current gene
-                    size_t boundaryLeft = (n == 0 ? 0 : labels[n-1]->right+1);
-                    size_t boundaryRight = labels[n]->left - 1;
-                    
-                    size_t length = (boundaryRight > boundaryLeft ? boundaryRight - boundaryLeft + 1 : 0);
-                    if (length < upstrLength)
-                        skip = true;
-                }
+                if (index.freeUpstreamLength(n, sequence.size()) < upstrLength)
+                    skip = true;
             }
             
             if (!useAll && !use[n])
@@ -65,19 +68,24 @@ void SequenceParser::extractUpstreamSequences(const NumSequence& sequence, const
             if (skip)
                 numSkipped++;
             else
-                upstreamRegions[n-numSkipped] = extractUpstreamSequence(sequence, *labels[n], cnc, upstrLength);
+                upstreamRegions[n-numSkipped] = extractUpstreamView(sequence, *labels[n], cnc, upstrLength);
         }
         catch (out_of_range) {
             numSkipped++;
         }
     }
     
-    // resize vector to remove skipped (empty) numsequences
+    // resize vector to remove skipped (empty) views
     upstreamRegions.resize(upstreamRegions.size()-numSkipped);
 }
 
 // Extract upstream sequence: throws exception when 'not enough' sequence to extract
 NumSequence SequenceParser::extractUpstreamSequence(const NumSequence& sequence, const Label &label, const CharNumConverter &cnc, NumSequence::size_type upstrLength) {
+    return extractUpstreamView(sequence, label, cnc, upstrLength).toNumSequence();
+}
+
+// Extract upstream view: throws exception when 'not enough' sequence to extract
+NumSequenceView SequenceParser::extractUpstreamView(const NumSequence& sequence, const Label &label, const CharNumConverter &cnc, NumSequence::size_type upstrLength) {
     
     if (upstrLength == 0)
         throw out_of_range("Cannot extract upstream sequence of length 0");
@@ -92,8 +100,7 @@ NumSequence SequenceParser::extractUpstreamSequence(const NumSequence& sequence,
         size_t right = label.left-1;                                // right idx of upstream sequence
         size_t length = right - left + 1;                           // length of upstream sequence
         
-        NumSequence upstream = sequence.subseq(left, length);       // get upstream subsequence
-        return upstream;
+        return NumSequenceView(sequence, cnc, left, length);        // view of upstream subsequence
     }
     else {                                      // negative strand; reverse complement
         
@@ -105,9 +112,7 @@ NumSequence SequenceParser::extractUpstreamSequence(const NumSequence& sequence,
         size_t right = label.right + upstrLength;                   // right idx of upstream sequence
         size_t length = right - left + 1;                           // length of upstream sequence
         
-        NumSequence upstream = sequence.subseq(left, length);       // get upstream subsequence
-        upstream.reverseComplement(cnc);                            // reverse complement
-        return upstream;
+        return NumSequenceView(sequence, cnc, left, length, true);  // view of upstream subsequence, reverse complemented
     }
 }
 
@@ -117,8 +122,20 @@ NumSequence SequenceParser::extractUpstreamSequence(const NumSequence& sequence,
 
 
 
+// Extract start context sequences, as copies
 void SequenceParser::extractStartContextSequences(const NumSequence& sequence, const vector<Label*> &labels, const CharNumConverter &cnc, long long posRelToStart, NumSequence::size_type length, vector<NumSequence> &contexts, const vector<bool> &use) {
     
+    vector<NumSequenceView> views;
+    extractStartContextSequences(sequence, labels, cnc, posRelToStart, length, views, use);
+    
+    contexts.resize(views.size());
+    for (size_t n = 0; n < views.size(); n++)
+        contexts[n] = views[n].toNumSequence();
+}
+
+// Extract start context sequences, as views over the sequence
+void SequenceParser::extractStartContextSequences(const NumSequence& sequence, const vector<Label*> &labels, const CharNumConverter &cnc, long long posRelToStart, NumSequence::size_type length, vector<NumSequenceView> &contexts, const vector<bool> &use) {
+    
     contexts.clear();
     
     bool useAll = true;
@@ -150,7 +167,7 @@ void SequenceParser::extractStartContextSequences(const NumSequence& sequence, c
                 size_t fragLength = fragRight - fragLeft + 1;
                 // if the right of fragment doesn't reach past the end of "sequence"
                 if (fragRight < sequence.size()) {
-                    contexts.push_back(sequence.subseq(fragLeft,fragLength));
+                    contexts.push_back(NumSequenceView(sequence, cnc, fragLeft, fragLength));
                 }
             }
         }
@@ -164,14 +181,12 @@ void SequenceParser::extractStartContextSequences(const NumSequence& sequence, c
                 size_t fragRight = fragLeft + length-1;
                 
                 if (fragRight < sequence.size()) {
-                    NumSequence subseq = sequence.subseq(fragLeft, fragRight - fragLeft + 1);
-                    subseq.reverseComplement(cnc);
-                    contexts.push_back(subseq);
+                    contexts.push_back(NumSequenceView(sequence, cnc, fragLeft, fragRight - fragLeft + 1, true));
                 }
             }
         }
         else
-            contexts.push_back(NumSequence());
+            contexts.push_back(NumSequenceView());
     }
 }
 
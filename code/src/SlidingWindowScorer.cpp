@@ -0,0 +1,187 @@
+//
+//  SlidingWindowScorer.cpp
+//  GeneMark Suite
+//
+
+#include "SlidingWindowScorer.hpp"
+
+#include <math.h>
+#include <stdexcept>
+
+using namespace std;
+using namespace gmsuite;
+
+
+// Constructor: create a scorer with all table entries set to zero
+SlidingWindowScorer::SlidingWindowScorer(size_t width, unsigned order, const NumAlphabetDNA &alph) {
+
+    if (width == 0)
+        throw invalid_argument("Width cannot be 0.");
+
+    this->width = width;
+    this->order = order;
+    this->offset = 0;
+
+    size_t numElements = alph.sizeValid();                  // number of elements that can make up valid words (e.g. A,C,G,T)
+    elementEncodingSize = ceil(log2(numElements));          // number of bits required to encode all elements
+
+    // a word at position p is made up of min(p, order)+1 letters
+    masks.resize(width);
+    table.resize(width);
+    sharedOf.resize(width);
+    sharedShift.resize(width);
+
+    size_t mask = 0;
+    for (size_t p = 0; p < width; p++) {
+        if (p <= order) {
+            for (size_t n = 0; n < elementEncodingSize; n++) {
+                mask <<= 1;         // shift by one position
+                mask |= 1;          // set lowest bit to one
+            }
+        }
+
+        masks[p] = mask;
+        table[p].resize(mask+1, 0);
+    }
+
+    // mask for a full word (independent of width)
+    wordMask = 0;
+    for (size_t n = 0; n < elementEncodingSize * (order+1); n++) {
+        wordMask <<= 1;
+        wordMask |= 1;
+    }
+}
+
+
+// Add a shared table with all entries set to zero
+size_t SlidingWindowScorer::addSharedTable(size_t wordLength) {
+    shared.push_back(vector<double> ((size_t) 1 << (elementEncodingSize * wordLength), 0));
+    sharedLength.push_back(wordLength);
+    return shared.size() - 1;
+}
+
+
+// Attach a shared table to a window position
+void SlidingWindowScorer::attachSharedTable(size_t position, size_t table) {
+
+    size_t positionLength = (position < order ? position : order) + 1;      // number of letters in words at position
+
+    if (sharedLength[table] > positionLength)
+        throw invalid_argument("Shared table words cannot be longer than words at that position.");
+
+    sharedOf[position].push_back(table);
+    sharedShift[position].push_back(elementEncodingSize * (positionLength - sharedLength[table]));
+}
+
+
+// Set the constant log-score added to every window
+void SlidingWindowScorer::setOffset(double offset) {
+    this->offset = offset;
+}
+
+
+// Compute the log-score of a single window
+double SlidingWindowScorer::score(const NumSequence &sequence, NumSequence::size_type pos) const {
+    return score(sequence.begin() + pos);
+}
+
+
+// Compute the log-score of a single window, from its first element
+double SlidingWindowScorer::score(NumSequence::const_iterator window) const {
+
+    double result = offset;
+    size_t wordIndex = 0;
+
+    NumSequence::const_iterator element = window;
+    for (size_t p = 0; p < width; p++, element++) {
+        wordIndex = ((wordIndex << elementEncodingSize) + *element) & masks[p];
+
+        result += table[p][wordIndex];
+        for (size_t t = 0; t < sharedOf[p].size(); t++)
+            result += shared[sharedOf[p][t]][wordIndex >> sharedShift[p][t]];
+    }
+
+    return result;
+}
+
+
+// Compute the total log-score of a set of windows, from per-position word counts
+double SlidingWindowScorer::scoreCounts(const vector<vector<double> > &counts) const {
+    
+    double result = 0;
+    
+    // the offset is added once per window, i.e. once per word counted at the first position
+    double numWindows = 0;
+    for (size_t word = 0; word < counts[0].size(); word++)
+        numWindows += counts[0][word];
+    
+    if (numWindows > 0)
+        result += numWindows * offset;
+    
+    for (size_t p = 0; p < width; p++) {
+        for (size_t word = 0; word < counts[p].size(); word++) {
+            
+            if (counts[p][word] == 0)
+                continue;
+            
+            double entry = table[p][word];
+            for (size_t t = 0; t < sharedOf[p].size(); t++)
+                entry += shared[sharedOf[p][t]][word >> sharedShift[p][t]];
+            
+            if (entry != HUGE_VAL && entry != -HUGE_VAL && entry == entry)
+                result += counts[p][word] * entry;
+        }
+    }
+    
+    return result;
+}
+
+
+// Compute the log-scores of all windows in a sequence
+void SlidingWindowScorer::scoreAll(const NumSequence &sequence, vector<double> &scores) const {
+    scoreAll(sequence.begin(), sequence.size(), scores);
+}
+
+
+// Compute the log-scores of all windows in a sequence, given by its elements
+void SlidingWindowScorer::scoreAll(NumSequence::const_iterator begin, NumSequence::size_type length, vector<double> &scores) const {
+
+    if (length < width)
+        throw invalid_argument("Sequence length cannot be shorter than window width.");
+
+    size_t numPositions = length - width + 1;
+    scores.assign(numPositions, offset);
+
+    // build the index of the word ending at every letter, in a single rolling pass (the buffer
+    // only grows, so that scoring sequences of similar lengths does not reallocate)
+    if (wordBuffer.size() < length)
+        wordBuffer.resize(length);
+    vector<size_t> &words = wordBuffer;
+
+    size_t wordIndex = 0;
+    NumSequence::const_iterator element = begin;
+    for (size_t i = 0; i < length; i++, element++) {
+        wordIndex = ((wordIndex << elementEncodingSize) + *element) & wordMask;
+        words[i] = wordIndex;
+    }
+
+    // add the entries of every window position to all windows: the window starting at s
+    // sees the word ending at letter s+p at its position p
+    for (size_t p = 0; p < width; p++) {
+
+        const vector<double> &positionTable = table[p];
+        const size_t *positionWords = &words[p];
+        size_t mask = masks[p];
+
+        for (size_t s = 0; s < numPositions; s++)
+            scores[s] += positionTable[positionWords[s] & mask];
+
+        for (size_t t = 0; t < sharedOf[p].size(); t++) {
+            const vector<double> &sharedTable = shared[sharedOf[p][t]];
+            size_t shift = sharedShift[p][t];
+
+            for (size_t s = 0; s < numPositions; s++)
+                scores[s] += sharedTable[(positionWords[s] & mask) >> shift];
+        }
+    }
+}
@@ -41,6 +41,16 @@ void UniformCounts::resetCounts() {
 }
 
 
+// Add the counts of another model with the same structure
+void UniformCounts::add(const UniformCounts &other) {
+    if (other.order != order || other.model.size() != model.size())
+        throw invalid_argument("Cannot add counts of models with different structures");
+    
+    for (size_t w = 0; w < model.size(); w++)
+        model[w] += other.model[w];
+}
+
+
 // Initialize the model by allocating space and setting counts to 0
 void UniformCounts::initialize() {
     size_t numElements = alphabet->sizeValid();             // the number of eleents that can make up valid words (e.g. A,C,G,T)
@@ -8,6 +8,7 @@
 
 #include "UniformMarkov.hpp"
 #include "UniformCounts.hpp"
+#include "ModelWriter.hpp"
 
 #include <math.h>
 #include <limits>
@@ -15,9 +16,6 @@
 #include <sstream>
 #include <iostream>
 
-#include <boost/random/mersenne_twister.hpp>
-#include <boost/random/uniform_real_distribution.hpp>
-#include <boost/random/variate_generator.hpp>
 
 
 using namespace std;
@@ -195,6 +193,17 @@ string UniformMarkov::toString() const {
     
 }
 
+// Write the model to a model writer, one row per key (same output as toString)
+void UniformMarkov::writeTable(ModelWriter &writer, const string &key) const {
+    
+    writer.beginTable(key, 16);
+    for (size_t idx = 0; idx < this->model.size(); idx++) {
+        NumSequence numSeq = this->indexToNumSequence(idx, this->order+1);
+        writer.writeRow(alphabet->getCNC()->convert(numSeq.begin(), numSeq.end()), &this->jointProbs[order][idx], 1);
+    }
+    writer.endTable();
+}
+
 
 // Initialize the model by allocating space, setting the keys, and setting counts to 0
 void UniformMarkov::initialize() {
@@ -243,7 +252,7 @@ void UniformMarkov::changeOrder(unsigned newOrder) {
 
 
 
-NumSequence UniformMarkov::emit(NumSequence::size_type length) const {
+NumSequence UniformMarkov::emit(NumSequence::size_type length, RandomGenerator &rng) const {
     
     if (length == 0)
         return NumSequence();
@@ -261,19 +270,9 @@ NumSequence UniformMarkov::emit(NumSequence::size_type length) const {
         }
     }
     
-    // get random number generator
-    typedef boost::mt19937                     ENG;     // Mersenne Twister
-    typedef boost::random::uniform_real_distribution<double> DIST;                // Normal Distribution
-    typedef boost::variate_generator<ENG,DIST> GEN;     // Variate generator
-    
-    ENG  eng;
-    DIST dist(0,1);
-    static GEN  gen(eng,dist);
-    
-    
     // if sequence length <= order+1, simply emit from joint
     if (length <= this->order + 1) {
-        double u = gen();
+        double u = rng.uniform();
         
         size_t i;       // index of emitted word
         
@@ -296,7 +295,7 @@ NumSequence UniformMarkov::emit(NumSequence::size_type length) const {
     
     // Emit first order+1 elements:
     size_t i;
-    double u = gen();
+    double u = rng.uniform();
     size_t wordLength = order+1;
     for (i = 0; i < cdfJoint[wordLength-1].size(); i++) {
         if (u < cdfJoint[wordLength-1][i])
@@ -340,7 +339,7 @@ NumSequence UniformMarkov::emit(NumSequence::size_type length) const {
     // loop over remaining "sequence"
     for (size_t n = wordLength; n < length; n++) {
         
-        u = gen();      // generate unif(0,1)
+        u = rng.uniform();      // generate unif(0,1)
         
         // get base from previous word
         size_t base = wordIndex & maskBase;
@@ -10,7 +10,6 @@
 
 #include <algorithm>
 #include <stdexcept>
-#include <stdlib.h>
 #include <sstream>
 #include <math.h>
 
@@ -34,7 +33,7 @@ void UnivariatePDF::construct(const vector<double> &weights, bool lnspace, doubl
     
     // check if conversion necessary
     if (lnspace)
-        convertFromLinearToLogspace();
+        convertFromLinearToLogspace(norm);
     
     // add pseudocounts
     if (pcounts > 0) {
@@ -50,43 +49,66 @@ void UnivariatePDF::construct(const vector<double> &weights, bool lnspace, doubl
 }
 
 /**
- * Sample a value from this distribution
+ * Sample a value from this distribution using the given random number generator
  */
-size_t UnivariatePDF::sample() const {
+size_t UnivariatePDF::sample(RandomGenerator &rng) const {
     
     if (cumulative.size() == 0)
         throw std::domain_error("Cannot sample from an empty distribution");
     
-    // generate a uniform random number between 0 and max(cumulative distribution), and select corresponding sample
-    double u = rand() / (double) RAND_MAX;
-    double b = cumulative[probabilities.size()-1];
+    return sampleFromUniform(rng.uniform());
+}
+
+// select the sample corresponding to the uniform value u in [0,1]
+size_t UnivariatePDF::sampleFromUniform(double u) const {
+    return sampleFromCumulative(cumulative, u);
+}
+
+// select the index of a cumulative buffer corresponding to the uniform value u in [0,1]
+size_t UnivariatePDF::sampleFromCumulative(const vector<double> &cumulative, double u) {
+    
+    u = u * cumulative.back();
+    
+    // find first location i where u <= cumulative[i]
+    return std::lower_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin();
+}
+
+
+// sample an index from a buffer of unnormalized log-weights
+size_t UnivariatePDF::sampleFromLogWeights(vector<double> &logWeights, RandomGenerator &rng) {
     
-    u = u * b;
+    if (logWeights.size() == 0)
+        throw std::domain_error("Cannot sample from an empty distribution");
     
-    size_t s = cumulative.size();
+    double maxLog = *std::max_element(logWeights.begin(), logWeights.end());
+    if (maxLog == HUGE_VAL || maxLog == -HUGE_VAL)
+        maxLog = 0;
     
-    // find location i where u < cumulative[i]
-    for (size_t i = 0; i < cumulative.size(); i++) {
-        if (u <= cumulative[i]) {
-            s = i;
-            break;
-        }
+    // turn log-weights into cumulative linear weights (shifted by the max), in place
+    double total = 0;
+    for (size_t i = 0; i < logWeights.size(); i++) {
+        total += exp(logWeights[i] - maxLog);
+        logWeights[i] = total;
     }
     
-    return s;
+    return sampleFromCumulative(logWeights, rng.uniform());
 }
 
 
-
 // convert values in <probabilities> from log-space to linear space
-void UnivariatePDF::convertFromLinearToLogspace() {
+void UnivariatePDF::convertFromLinearToLogspace(bool shift) {
     
     if (probabilities.size() == 0)
         return;
     
-    // apply exponential
+    // shift by the maximum before applying the exponential (log-sum-exp), so that
+    // large log-values do not overflow; the shift cancels out on normalization
+    double maxLog = shift ? *std::max_element(probabilities.begin(), probabilities.end()) : 0;
+    if (maxLog == HUGE_VAL || maxLog == -HUGE_VAL)
+        maxLog = 0;
+    
     for (size_t i = 0; i < probabilities.size(); i++)
-        probabilities[i] = exp(probabilities[i]);
+        probabilities[i] = exp(probabilities[i] - maxLog);
 }
 
 void UnivariatePDF::computeCumulativeDistribution() {
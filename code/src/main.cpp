@@ -25,6 +25,7 @@
 #include "ModuleUtilities.hpp"
 #include "ModuleExperiment.hpp"
 #include "ModuleGMS2Training.hpp"
+#include "ModuleSession.hpp"
 #include "VersionNumber.h"
 
 using namespace std;
@@ -35,6 +36,7 @@ using namespace gmsuite;
 #define MOD_UTILITIES "utilities"
 #define MOD_EXPERIMENT "experiment"
 #define MOD_GMS2_TRAINING "gms2-training"
+#define MOD_SESSION "session"
 
 
 string usage_message(string progName) {
@@ -48,6 +50,7 @@ string usage_message(string progName) {
     ssm << "\t" << MOD_UTILITIES << "\t" << "Utilities" << endl;
     ssm << "\t" << MOD_EXPERIMENT << "\t" << "Experiment" << endl;
     ssm << "\t" << MOD_GMS2_TRAINING << "\t" << "GMS2 Training step" << endl;
+    ssm << "\t" << MOD_SESSION << "\t" << "Run commands read from standard input, one per line" << endl;
     
     return ssm.str();
 }
@@ -109,6 +112,10 @@ int main(int argc, const char * argv[]) {
         ModuleGMS2Training module (options);            // create module with options
         module.run();                                   // run module
     }
+    else if (aMode == MOD_SESSION) {
+        ModuleSession module (cin);                     // commands from standard input
+        module.run();                                   // run until end of input
+    }
     else if (aMode == "--version") {
         cout << "Version: " << VERSION_NUMBER_MAJOR << "." << VERSION_NUMBER_MINOR << "." << BUILD_NUMBER << endl;
     }
@@ -0,0 +1,16 @@
+__NATIVE
+$NAME gms2-training
+$GCODE 11
+$COD_P_N 0.40000000000000002
+$RBS_MAT
+A	0.1	0.2
+C	0.3	0.4
+G	0.5	0.6
+T	0.7	0.8
+
+$RBS_POS_DISTR
+0	0.25
+1	0.75
+
+$PROMOTER_POS_DISTR 0 1.000000
+$GENOME_TYPE group-a
@@ -0,0 +1,51 @@
+//
+//  test_CharNumConverter.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+
+#include "catch.hpp"
+#include "Sequence.hpp"
+#include "NumSequence.hpp"
+#include "NumAlphabetDNA.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+TEST_CASE("Testing CharNumConverter") {
+
+    AlphabetDNA alph;
+    CharNumConverter cnc(&alph);
+    NumAlphabetDNA numAlph(alph, cnc);
+
+    SECTION("Sequences convert back to themselves") {
+        NumSequence sequence (Sequence("ACGTNRYACG"), cnc);
+        REQUIRE(cnc.convert(sequence.begin(), sequence.end()) == "ACGTNRYACG");
+    }
+
+    SECTION("Characters outside the alphabet are rejected") {
+        CharNumConverter::seq_t result;
+        REQUIRE_THROWS_AS(cnc.convert(string("ACGXT"), result), std::out_of_range);
+        REQUIRE_THROWS_AS(cnc.convert('x'), std::out_of_range);
+    }
+
+    SECTION("Reverse complement matches the character alphabet") {
+        string odd = "AACGTNCAG", even = "GATTACAN";
+
+        NumSequence sequenceOdd (Sequence(odd), cnc), sequenceEven (Sequence(even), cnc);
+        sequenceOdd.reverseComplement(cnc);
+        sequenceEven.reverseComplement(cnc);
+
+        REQUIRE(cnc.convert(sequenceOdd.begin(), sequenceOdd.end()) == alph.reverseComplement(odd));
+        REQUIRE(cnc.convert(sequenceEven.begin(), sequenceEven.end()) == alph.reverseComplement(even));
+    }
+
+    SECTION("Numeric alphabet classifies elements") {
+        REQUIRE(numAlph.isValid(cnc.convert('G')));
+        REQUIRE(numAlph.isAmbiguous(cnc.convert('N')));
+        REQUIRE(!numAlph.isAmbiguous(cnc.convert('T')));
+        REQUIRE(numAlph.complement(cnc.convert('A')) == cnc.convert('T'));
+        REQUIRE(numAlph.complement(cnc.convert('N')) == cnc.convert('N'));
+    }
+}
@@ -30,3 +30,95 @@ TEST_CASE("Testing LabelFile - ") {
     }
     
 }
+
+
+TEST_CASE("Testing LabelFile - parsing LST lines") {
+    
+    LabelFile labfile("test/data/parsing.lst", LabelFile::READ);
+    
+    LabelSet labels;
+    labfile.read(labels);
+    
+    SECTION("Only complete genes after the first SequenceID are read") {
+        REQUIRE(labels.size() == 5);
+        
+        size_t lefts[] = {1, 1799, 2099, 2399, 2699};
+        size_t rights[] = {771, 1998, 2298, 2598, 2898};
+        Label::strand_t strands[] = {Label::POS, Label::NEG, Label::POS, Label::POS, Label::NEG};
+        for (size_t n = 0; n < labels.size(); n++) {
+            REQUIRE(labels.left(n) == lefts[n]);
+            REQUIRE(labels.right(n) == rights[n]);
+            REQUIRE(labels.strand(n) == strands[n]);
+        }
+    }
+    
+    SECTION("Meta is the nucleotide prefix of the word after the gene class, if any") {
+        REQUIRE(labels.meta(0) == "");
+        REQUIRE(labels.meta(1) == "");
+        REQUIRE(labels.meta(2) == "");
+        REQUIRE(labels.meta(3) == "AGG");
+        REQUIRE(labels.meta(4) == "GGAGG");
+    }
+    
+    SECTION("Gene classes are read whole") {
+        REQUIRE(labels.numClasses() == 2);
+        REQUIRE(labels.className(labels.geneClass(0)) == "native");
+        REQUIRE(labels.className(labels.geneClass(1)) == "atypical");
+        REQUIRE(labels.geneClass(4) == labels.geneClass(1));
+    }
+    
+    SECTION("Label objects hold the same fields") {
+        vector<Label> output;
+        labfile.read(output);
+        
+        REQUIRE(output.size() == labels.size());
+        REQUIRE(output[1].left == 1799);
+        REQUIRE(output[1].right == 1998);
+        REQUIRE(output[1].strand == Label::NEG);
+        REQUIRE(output[1].geneClass == "atypical");
+        REQUIRE(output[3].meta == "AGG");
+    }
+}
+
+
+TEST_CASE("Testing LabelFile - matching labels to sequences") {
+    
+    vector<string> contigIDs;
+    contigIDs.push_back("gi|111|ref|contigA|");
+    contigIDs.push_back("gi|222|ref|contigB|");
+    
+    SECTION("Sequence IDs are matched to contigs by ID") {
+        LabelFile labfile("test/data/contigs_by_id.lst", LabelFile::READ);
+        
+        vector<LabelSet> output;
+        labfile.read(contigIDs, output);
+        
+        REQUIRE(output.size() == 2);
+        REQUIRE(output[0].size() == 1);         // contigA is listed second in the file
+        REQUIRE(output[0].left(0) == 9);
+        REQUIRE(output[1].size() == 2);
+        REQUIRE(output[1].left(0) == 1);
+    }
+    
+    SECTION("Sequence IDs that match no contig are taken as ordinals") {
+        LabelFile labfile("test/data/contigs_ordinal.lst", LabelFile::READ);
+        
+        vector<LabelSet> output;
+        labfile.read(contigIDs, output);
+        
+        REQUIRE(output.size() == 2);
+        REQUIRE(output[0].size() == 2);
+        REQUIRE(output[0].right(1) == 1493);
+        REQUIRE(output[0].strand(1) == Label::NEG);
+        REQUIRE(output[1].size() == 1);
+        REQUIRE(output[1].meta(0) == "AGGAGG");
+    }
+    
+    SECTION("Labels of a sequence ID that matches no contig are not dropped") {
+        LabelFile labfile("test/data/contigs_unmatched.lst", LabelFile::READ);
+        
+        vector<LabelSet> output;
+        REQUIRE_THROWS_AS(labfile.read(contigIDs, output), invalid_argument);
+    }
+}
+
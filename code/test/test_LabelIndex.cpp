@@ -0,0 +1,67 @@
+//
+//  test_LabelIndex.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+
+#include "catch.hpp"
+#include "LabelIndex.hpp"
+#include "LabelsParser.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+TEST_CASE("Testing LabelIndex") {
+    
+    // unsorted, with a gene (3) nested in gene 0
+    vector<Label> labels;
+    labels.push_back(Label(100, 400, Label::POS));          // 0
+    labels.push_back(Label(10, 60, Label::POS));            // 1
+    labels.push_back(Label(430, 700, Label::POS));          // 2
+    labels.push_back(Label(150, 200, Label::NEG));          // 3
+    labels.push_back(Label(900, 950, Label::NEG));          // 4
+    
+    vector<Label*> pointers;
+    for (size_t n = 0; n < labels.size(); n++)
+        pointers.push_back(&labels[n]);
+    
+    LabelIndex index (pointers);
+    
+    SECTION("Labels are sorted by left-end") {
+        REQUIRE(index.sortedByLeft(0) == 1);
+        REQUIRE(index.sortedByLeft(1) == 0);
+        REQUIRE(index.sortedByLeft(4) == 4);
+    }
+    
+    SECTION("Nearest upstream gene ignores nested genes") {
+        REQUIRE(index.upstreamNeighbor(1) == LabelIndex::NO_LABEL);
+        REQUIRE(index.upstreamNeighbor(0) == 1);
+        REQUIRE(index.upstreamNeighbor(2) == 0);                    // not the nested gene 3
+        REQUIRE(index.upstreamNeighbor(3) == 0);                    // negative strand: looks right, into gene 0
+        REQUIRE(index.upstreamNeighbor(4) == LabelIndex::NO_LABEL);
+        REQUIRE(index.upstreamNeighbor(2, Label::NEG) == 3);
+    }
+    
+    SECTION("Free upstream length and overlaps") {
+        REQUIRE(index.freeUpstreamLength(1, 1000) == 10);
+        REQUIRE(index.freeUpstreamLength(2, 1000) == 29);
+        REQUIRE(index.freeUpstreamLength(3, 1000) == 0);            // nested in gene 0
+        REQUIRE(index.freeUpstreamLength(4, 1000) == 49);
+        
+        REQUIRE(index.overlapsLabel(401, 429) == false);
+        REQUIRE(index.overlapsLabel(401, 430) == true);
+        REQUIRE(index.overlapsLabel(0, 9) == false);
+    }
+    
+    SECTION("Operon partition does not depend on label order") {
+        vector<LabelsParser::operon_status_t> status;
+        LabelsParser::partitionBasedOnOperonStatus(pointers, 35, 20, status);
+        
+        REQUIRE(status[1] == LabelsParser::FGIO);
+        REQUIRE(status[0] == LabelsParser::FGIO);                   // 40 from gene 1
+        REQUIRE(status[2] == LabelsParser::AMBIG);                  // 30 from gene 0
+        REQUIRE(status[3] == LabelsParser::FGIO);                   // gene 0 is on the opposite strand
+        REQUIRE(status[4] == LabelsParser::FGIO);
+    }
+}
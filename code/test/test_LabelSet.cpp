@@ -0,0 +1,113 @@
+//
+//  test_LabelSet.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+#include <sstream>
+#include <limits>
+
+#include "catch.hpp"
+#include "LabelSet.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+TEST_CASE("Testing LabelSet") {
+    
+    // lengths 100, 10, 50, 10 and 200, with meta of different lengths (some empty)
+    LabelSet labels;
+    labels.add(Label(0, 99, Label::POS, "native", "AGGAGG"));
+    labels.add(Label(200, 209, Label::NEG, "atypical", "TTT"));
+    labels.add(Label(300, 349, Label::NEG, "native", ""));
+    labels.add(Label(400, 409, Label::POS, "native-2", "GG"));
+    labels.add(Label(500, 699, Label::POS, "atypical", "ACGTA"));
+    
+    SECTION("Fields are stored per label, and classes are interned") {
+        REQUIRE(labels.size() == 5);
+        REQUIRE(labels.numClasses() == 3);
+        REQUIRE(labels.geneClass(0) == labels.geneClass(2));
+        REQUIRE(labels.geneClass(1) == labels.geneClass(4));
+        REQUIRE(labels.className(labels.geneClass(3)) == "native-2");
+        
+        REQUIRE(labels.left(1) == 200);
+        REQUIRE(labels.right(1) == 209);
+        REQUIRE(labels.strand(1) == Label::NEG);
+        REQUIRE(labels.meta(0) == "AGGAGG");
+        REQUIRE(labels.meta(2) == "");
+        REQUIRE(labels.meta(4) == "ACGTA");
+        
+        Label label = labels.label(3);
+        REQUIRE(label.left == 400);
+        REQUIRE(label.right == 409);
+        REQUIRE(label.strand == Label::POS);
+        REQUIRE(label.geneClass == "native-2");
+        REQUIRE(label.meta == "GG");
+    }
+    
+    SECTION("Classes are marked if their name contains the text") {
+        vector<bool> marked;
+        labels.markClassContaining("native", marked);
+        
+        REQUIRE(marked.size() == 5);
+        REQUIRE(marked[0]);
+        REQUIRE(!marked[1]);
+        REQUIRE(marked[2]);
+        REQUIRE(marked[3]);
+        REQUIRE(!marked[4]);
+        
+        labels.markClassContaining("typ", marked);
+        REQUIRE(marked[1]);
+        REQUIRE(marked[4]);
+        REQUIRE(!marked[0]);
+    }
+    
+    SECTION("Removing short labels keeps the order, and the meta, of the others") {
+        labels.removeShorterThan(50);
+        
+        REQUIRE(labels.size() == 3);
+        REQUIRE(labels.left(0) == 0);
+        REQUIRE(labels.left(1) == 300);
+        REQUIRE(labels.left(2) == 500);
+        
+        // the meta arena is compacted: each label keeps its own meta
+        REQUIRE(labels.meta(0) == "AGGAGG");
+        REQUIRE(labels.meta(1) == "");
+        REQUIRE(labels.meta(2) == "ACGTA");
+        REQUIRE(labels.className(labels.geneClass(2)) == "atypical");
+        
+        // labels added after compaction have their meta after the kept ones
+        labels.add(Label(800, 899, Label::NEG, "native", "CC"));
+        REQUIRE(labels.meta(2) == "ACGTA");
+        REQUIRE(labels.meta(3) == "CC");
+    }
+    
+    SECTION("Labels exactly at the minimum length are kept") {
+        labels.removeShorterThan(10);
+        REQUIRE(labels.size() == 5);
+        REQUIRE(labels.meta(3) == "GG");
+        
+        labels.removeShorterThan(1000);
+        REQUIRE(labels.empty());
+    }
+    
+    SECTION("Coordinates that do not fit are rejected, and leave the set unchanged") {
+        size_t tooLarge = (size_t) numeric_limits<LabelSet::coord_t>::max() + 1;
+        if (tooLarge != 0) {
+            REQUIRE_THROWS_AS(labels.add(Label(0, tooLarge, Label::POS, "native", "")), invalid_argument);
+            REQUIRE(labels.size() == 5);
+        }
+    }
+    
+    SECTION("At most 256 gene classes can be interned") {
+        LabelSet many;
+        for (size_t c = 0; c < 256; c++) {
+            stringstream name;
+            name << "class" << c;
+            many.add(Label(c, c, Label::POS, name.str(), ""));
+        }
+        REQUIRE(many.numClasses() == 256);
+        REQUIRE_THROWS_AS(many.add(Label(0, 0, Label::POS, "one-too-many", "")), invalid_argument);
+        REQUIRE(many.size() == 256);
+    }
+}
@@ -7,7 +7,6 @@
 //
 
 #include <stdio.h>
-#include <stdlib.h>
 
 #include "catch.hpp"
 #include "ModuleMFinder.hpp"
@@ -18,8 +17,6 @@ using namespace gmsuite;
 
 TEST_CASE("Testing Motif Finder") {
  
-    srand(1);
-    
     OptionsMFinder options("mfinder");
     options.align = MFinderModelParams::RIGHT;
     options.width = 6;
@@ -8,6 +8,10 @@
 
 #include <stdio.h>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string.h>
+#include <boost/cstdint.hpp>
 
 #include "catch.hpp"
 #include "ModelFile.hpp"
@@ -19,14 +23,120 @@ TEST_CASE("Testing Model File") {
     
     ModelFile mfile("/Users/Karl/repos/GeneMarkS-2/code/tmp/sample.mod", ModelFile::READ);
     
-    map<string,string> keyValue;
+    vector<pair<string,string> > keyValue;
     mfile.read(keyValue);
     
-    for (map<string,string>::const_iterator iter = keyValue.begin(); iter != keyValue.end(); iter++) {
+    for (vector<pair<string,string> >::const_iterator iter = keyValue.begin(); iter != keyValue.end(); iter++) {
         cout << iter->first << "\n" << iter->second << endl;
     }
     
     ModelFile mfile_write("/Users/Karl/repos/GeneMarkS-2/code/tmp/sample_write.mod", ModelFile::WRITE);
     mfile_write.write(keyValue);
 
-}
\ No newline at end of file
+}
+
+
+// read a whole file into a string
+static string readFile(const string &path) {
+    ifstream in (path.c_str(), ios::binary);
+    stringstream ssm;
+    ssm << in.rdbuf();
+    return ssm.str();
+}
+
+// write a string as a whole file
+static void writeFile(const string &path, const string &contents) {
+    ofstream out (path.c_str(), ios::binary);
+    out << contents;
+}
+
+// convert a model file, as the convert-model utility does
+static void convertModel(const string &from, const string &to, bool binary) {
+    ModelFile in (from, ModelFile::READ);
+    vector<pair<string, string> > keyValue;
+    in.read(keyValue);
+    
+    ModelFile out (to, ModelFile::WRITE);
+    if (binary)
+        out.writeBinary(keyValue, in.getSectionHeader());
+    else
+        out.write(keyValue, in.getSectionHeader());
+}
+
+TEST_CASE("Testing Model File - binary images") {
+    
+    string text = "test/data/model.mod";
+    string image = "test_ModelFile_image.modb";
+    string bad = "test_ModelFile_bad.modb";
+    string back = "test_ModelFile_back.mod";
+    
+    convertModel(text, image, true);
+    
+    SECTION("Text converted to an image and back is unchanged") {
+        convertModel(image, back, false);
+        REQUIRE(readFile(back) == readFile(text));
+        
+        ModelFile mfile (image, ModelFile::READ);
+        REQUIRE(mfile.isBinary());
+        REQUIRE(mfile.getSectionHeader() == "NATIVE");
+        REQUIRE(mfile.readValueForKey("GENOME_TYPE") == "group-a");
+    }
+    
+    SECTION("Numeric values are mapped from the image") {
+        ModelFile mfile (image, ModelFile::READ);
+        size_t rows, cols;
+        
+        const double* numbers = mfile.numbersForKey("RBS_MAT", rows, cols);
+        REQUIRE(numbers != NULL);
+        REQUIRE(rows == 4);
+        REQUIRE(cols == 2);
+        REQUIRE(numbers[0] == 0.1);
+        REQUIRE(numbers[7] == 0.8);
+        
+        numbers = mfile.numbersForKey("GCODE", rows, cols);
+        REQUIRE(numbers != NULL);
+        REQUIRE(rows == 1);
+        REQUIRE(cols == 1);
+        REQUIRE(numbers[0] == 11);
+        
+        REQUIRE(mfile.numbersForKey("NAME", rows, cols) == NULL);
+        
+        // a single line starting with a number is ambiguous (numbers, or a row labelled by a number)
+        REQUIRE(mfile.numbersForKey("PROMOTER_POS_DISTR", rows, cols) == NULL);
+        REQUIRE(mfile.readValueForKey("PROMOTER_POS_DISTR") == "0 1.000000");
+        
+        // text files have no numeric form
+        ModelFile textFile (text, ModelFile::READ);
+        REQUIRE(textFile.numbersForKey("RBS_MAT", rows, cols) == NULL);
+    }
+    
+    SECTION("Images of another version are rejected") {
+        string contents = readFile(image);
+        boost::uint32_t version = 2;
+        memcpy(&contents[8], &version, sizeof(version));            // version follows the 8-byte magic
+        writeFile(bad, contents);
+        
+        REQUIRE_THROWS_AS(ModelFile(bad, ModelFile::READ), invalid_argument);
+    }
+    
+    SECTION("Truncated images are rejected") {
+        string contents = readFile(image);
+        writeFile(bad, contents.substr(0, contents.size() - 8));
+        REQUIRE_THROWS_AS(ModelFile(bad, ModelFile::READ), invalid_argument);
+        
+        writeFile(bad, contents.substr(0, 16));
+        REQUIRE_THROWS_AS(ModelFile(bad, ModelFile::READ), invalid_argument);
+    }
+    
+    SECTION("Corrupted images are rejected") {
+        string contents = readFile(image);
+        contents[contents.size() / 2] ^= 0x01;
+        writeFile(bad, contents);
+        
+        REQUIRE_THROWS_AS(ModelFile(bad, ModelFile::READ), invalid_argument);
+    }
+    
+    remove(image.c_str());
+    remove(bad.c_str());
+    remove(back.c_str());
+}
@@ -0,0 +1,112 @@
+//
+//  test_ModelWriter.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+
+#include "catch.hpp"
+#include "ModelWriter.hpp"
+#include "ModelFile.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+// read a whole file into a string
+static string readFile(const string &path) {
+    ifstream in (path.c_str(), ios::binary);
+    stringstream ssm;
+    ssm << in.rdbuf();
+    return ssm.str();
+}
+
+TEST_CASE("Testing ModelWriter") {
+    
+    string path = "test_ModelWriter.mod";
+    
+    SECTION("Fixed notation matches streams") {
+        double values[] = {0, -0.0, 0.5, 0.0000025, 0.1234565, -1e-9, 999.9999995, 1e20, 0.853566};
+        for (size_t n = 0; n < sizeof(values) / sizeof(values[0]); n++) {
+            for (int precision = 0; precision <= 16; precision += 2) {
+                stringstream ssm;
+                ssm.precision(precision);
+                ssm << fixed << values[n];
+                
+                string output;
+                ModelWriter::appendFixed(output, values[n], precision);
+                REQUIRE(output == ssm.str());
+            }
+        }
+    }
+    
+    SECTION("Values too long for the formatting buffer match streams") {
+        double values[] = {1e300, -1e300, 1.5e100};
+        int precisions[] = {6, 400};
+        for (size_t n = 0; n < sizeof(values) / sizeof(values[0]); n++) {
+            for (size_t p = 0; p < 2; p++) {
+                stringstream ssm;
+                ssm.precision(precisions[p]);
+                ssm << fixed << values[n];
+                
+                string output;
+                ModelWriter::appendFixed(output, values[n], precisions[p]);
+                REQUIRE(output == ssm.str());
+            }
+        }
+    }
+    
+    SECTION("Output has the same layout as ModelFile::write") {
+        double row1[] = {0.25, 0.5};
+        double row2[] = {0.125, 1};
+        
+        {
+            ModelWriter writer (path, "NATIVE");
+            writer.write("NAME", "test");
+            writer.writeFixed("ATG", 0.9);
+            writer.beginTable("MAT");
+            writer.writeRow("A", row1, 2);
+            writer.writeRow("C", row2, 2);
+            writer.endTable();
+            writer.beginTable("ONE_ROW");
+            writer.writeRow("0", row1, 1);
+            writer.endTable();
+        }
+        
+        vector<pair<string, string> > keyValue;
+        keyValue.push_back(pair<string, string>("NAME", "test"));
+        keyValue.push_back(pair<string, string>("ATG", "0.900000"));
+        keyValue.push_back(pair<string, string>("MAT", "A\t0.250000\t0.500000\nC\t0.125000\t1.000000\n"));
+        keyValue.push_back(pair<string, string>("ONE_ROW", "0\t0.250000\n"));
+        
+        string written = readFile(path);
+        {
+            ModelFile mfile (path, ModelFile::WRITE);
+            mfile.write(keyValue, "NATIVE");
+        }
+        
+        REQUIRE(written == readFile(path));
+    }
+    
+    SECTION("Overrides replace values, and unused ones are added at the end") {
+        boost::unordered_map<string, string> overrides;
+        overrides["MAT"] = "1";
+        overrides["EXTRA"] = "2";
+        
+        double row[] = {0.25};
+        {
+            ModelWriter writer (path);
+            writer.setOverrides(overrides);
+            writer.write("NAME", "test");
+            writer.beginTable("MAT");
+            writer.writeRow("A", row, 1);
+            writer.writeRow("C", row, 1);
+            writer.endTable();
+        }
+        
+        REQUIRE(readFile(path) == "$NAME test\n$MAT 1\n$EXTRA 2\n");
+    }
+    
+    remove(path.c_str());
+}
@@ -0,0 +1,110 @@
+//
+//  test_ModuleGMS2Training.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "catch.hpp"
+#include "ModuleGMS2Training.hpp"
+#include "OptionsGMS2Training.hpp"
+#include "GMS2Trainer.hpp"
+#include "ModelWriter.hpp"
+#include "LabelFile.hpp"
+#include "SequenceFile.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+// read a whole file into a string
+static string readFile(const string &path) {
+    ifstream in (path.c_str(), ios::binary);
+    stringstream ssm;
+    ssm << in.rdbuf();
+    return ssm.str();
+}
+
+// parse training options as gms2.pl passes them (without motif search, which depends on the order of upstreams)
+static void parseOptions(OptionsGMS2Training &options, const string &fnseq, const string &fnlabels, const string &fnmod) {
+    const char *argv[] = {
+        "biogem", "gms2-training",
+        "-s", fnseq.c_str(), "-l", fnlabels.c_str(), "-m", fnmod.c_str(),
+        "--genome-group", "C", "--order-coding", "2", "--run-motif-search", "false"
+    };
+    
+    REQUIRE(options.parse(sizeof(argv) / sizeof(argv[0]), argv));
+}
+
+TEST_CASE("Testing ModuleGMS2Training - multi-contig genomes") {
+    
+    // two contigs, with labels as written by GeneMark.hmm (sequence IDs are ordinals)
+    string fnseq = "test/data/two_contigs.fna";
+    string fnlabels = "test/data/two_contigs.lst";
+    string fnmod = "test_ModuleGMS2Training.mod";
+    string fnmodReversed = "test_ModuleGMS2Training_reversed.mod";
+    
+    OptionsGMS2Training options;
+    parseOptions(options, fnseq, fnlabels, fnmod);
+    
+    ModuleGMS2Training module (options);
+    module.run();
+    
+    string model = readFile(fnmod);
+    
+    SECTION("A model is trained on the contigs of the file, with their labels") {
+        REQUIRE(model.find("__NATIVE") == 0);
+        REQUIRE(model.find("$COD_MAT") != string::npos);
+        REQUIRE(model.find("$NON_MAT") != string::npos);
+    }
+    
+    SECTION("The model does not depend on the order of the contigs") {
+        AlphabetDNA alph;
+        CharNumConverter cnc(&alph);
+        
+        vector<NumSequence> contigs;
+        vector<string> contigIDs;
+        SequenceFile seqFile (fnseq, SequenceFile::READ);
+        seqFile.read(contigs, contigIDs, cnc);
+        
+        vector<LabelSet> labels;
+        LabelFile labFile (fnlabels, LabelFile::READ);
+        labFile.read(contigIDs, labels);
+        
+        REQUIRE(contigs.size() == 2);
+        REQUIRE(labels.size() == 2);
+        REQUIRE(labels[0].size() == 5);
+        REQUIRE(labels[1].size() == 9);
+        
+        reverse(contigs.begin(), contigs.end());
+        reverse(labels.begin(), labels.end());
+        
+        GMS2Trainer::Builder builder;
+        GMS2Trainer trainer = builder.build(options);
+        trainer.estimateParameters(contigs, labels);
+        
+        {
+            ModelWriter writer (fnmodReversed, "NATIVE");
+            trainer.toModFile(writer, options);
+            writer.close();
+        }
+        
+        REQUIRE(readFile(fnmodReversed) == model);
+    }
+    
+    SECTION("The model does not depend on the number of threads") {
+        OptionsGMS2Training threaded;
+        parseOptions(threaded, fnseq, fnlabels, fnmodReversed);
+        threaded.numThreads = 2;
+        
+        ModuleGMS2Training threadedModule (threaded);
+        threadedModule.run();
+        
+        REQUIRE(readFile(fnmodReversed) == model);
+    }
+    
+    remove(fnmod.c_str());
+    remove(fnmodReversed.c_str());
+}
@@ -0,0 +1,108 @@
+//
+//  test_ModuleSession.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+#include <iostream>
+#include <sstream>
+
+#include "catch.hpp"
+#include "ModuleSession.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+// run a session over the given commands, and get the lines it printed
+static vector<string> runSession(const string &commands) {
+    
+    istringstream in (commands);
+    ostringstream out;
+    
+    streambuf *original = cout.rdbuf(out.rdbuf());
+    try {
+        ModuleSession session (in);
+        session.run();
+    }
+    catch (...) {
+        cout.rdbuf(original);
+        throw;
+    }
+    cout.rdbuf(original);
+    
+    vector<string> lines;
+    istringstream printed (out.str());
+    string line;
+    while (getline(printed, line))
+        lines.push_back(line);
+    
+    return lines;
+}
+
+TEST_CASE("Testing ModuleSession - splitting commands") {
+    
+    vector<string> words;
+    
+    SECTION("Words are separated by any whitespace") {
+        ModuleSession::splitCommand("  experiment\tmatch-rbs-to-16s   --min-match 4 ", words);
+        
+        REQUIRE(words.size() == 4);
+        REQUIRE(words[0] == "experiment");
+        REQUIRE(words[1] == "match-rbs-to-16s");
+        REQUIRE(words[2] == "--min-match");
+        REQUIRE(words[3] == "4");
+    }
+    
+    SECTION("Quotes keep whitespace, and can be empty") {
+        ModuleSession::splitCommand("utilities -s \"my genome.fna\" --name 'a \"b\"' '' x", words);
+        
+        REQUIRE(words.size() == 7);
+        REQUIRE(words[2] == "my genome.fna");
+        REQUIRE(words[4] == "a \"b\"");
+        REQUIRE(words[5] == "");
+        REQUIRE(words[6] == "x");
+    }
+    
+    SECTION("Quotes can join parts of a word") {
+        ModuleSession::splitCommand("--fnmod=\"a b\".mod", words);
+        
+        REQUIRE(words.size() == 1);
+        REQUIRE(words[0] == "--fnmod=a b.mod");
+    }
+    
+    SECTION("Blank lines have no words") {
+        ModuleSession::splitCommand(" \t ", words);
+        REQUIRE(words.empty());
+    }
+    
+    SECTION("Unclosed quotes are rejected") {
+        REQUIRE_THROWS_AS(ModuleSession::splitCommand("experiment 'unclosed", words), invalid_argument);
+    }
+}
+
+TEST_CASE("Testing ModuleSession - status lines") {
+    
+    SECTION("Each command is followed by its status, and blank lines are skipped") {
+        vector<string> lines = runSession("clear-cache\n\n   \nunknown-mode -x\nexperiment \"unclosed\n");
+        
+        REQUIRE(lines.size() == 3);
+        REQUIRE(lines[0] == "##status ok");
+        REQUIRE(lines[1] == "##status error Unknown mode: unknown-mode");
+        REQUIRE(lines[2].find("##status error Unclosed quote") == 0);
+    }
+    
+    SECTION("A command whose options cannot be parsed reports an error, and the session goes on") {
+        vector<string> lines = runSession("experiment\nclear-cache\n");
+        
+        REQUIRE(lines.size() >= 2);
+        REQUIRE(lines[lines.size()-2] == "##status error Could not parse options of experiment");
+        REQUIRE(lines[lines.size()-1] == "##status ok");
+    }
+    
+    SECTION("Quit ends the session, without a status") {
+        vector<string> lines = runSession("clear-cache\nquit\nclear-cache\n");
+        
+        REQUIRE(lines.size() == 1);
+        REQUIRE(lines[0] == "##status ok");
+    }
+}
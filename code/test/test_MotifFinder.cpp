@@ -0,0 +1,93 @@
+//
+//  test_MotifFinder.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "MotifFinder.hpp"
+#include "SequenceBatch.hpp"
+#include "RandomGenerator.hpp"
+#include "CharNumConverter.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+// build a batch of random sequences, each holding the motif at a random position (some rows invalid)
+static SequenceBatch plantMotifs(const string &motif, size_t numSequences, size_t length, RandomGenerator &rng, const CharNumConverter &cnc) {
+    
+    const char letters[] = {'A', 'C', 'G', 'T'};
+    
+    SequenceBatch batch (length);
+    for (size_t n = 0; n < numSequences; n++) {
+        string str (length, 'A');
+        for (size_t i = 0; i < length; i++)
+            str[i] = letters[rng() % 4];
+        
+        str.replace(rng() % (length - motif.size() + 1), motif.size(), motif);
+        
+        batch.push_back(NumSequence(Sequence(str), cnc), n % 10 != 9);
+    }
+    
+    return batch;
+}
+
+// find motifs with the given number of threads
+static void findMotifs(const SequenceBatch &batch, unsigned numThreads, vector<NumSequence::size_type> &positions, unsigned &bestTry, double &bestScore) {
+    
+    // short tries, so that they end at different scores (with this seed, a later try is chosen)
+    MotifFinder::Builder b;
+    MotifFinder mfinder = b.setWidth(6).setAlign(MFinderModelParams::RIGHT).setNumTries(12).setMaxIter(5).setShiftEvery(5).setNumThreads(numThreads).setSeed(5).build();
+    
+    mfinder.findMotifs(batch, positions);
+    bestTry = mfinder.getBestTry();
+    bestScore = mfinder.getBestScore();
+}
+
+TEST_CASE("Testing MotifFinder - threads") {
+    
+    AlphabetDNA alph;
+    CharNumConverter cnc (&alph);
+    
+    RandomGenerator rng (7);
+    SequenceBatch batch = plantMotifs("AGGAGG", 60, 30, rng, cnc);
+    
+    vector<NumSequence::size_type> positionsSingle;
+    unsigned trySingle;
+    double scoreSingle;
+    findMotifs(batch, 1, positionsSingle, trySingle, scoreSingle);
+    
+    SECTION("The same seed gives the same positions and try on 1 and 4 threads") {
+        vector<NumSequence::size_type> positionsMulti;
+        unsigned tryMulti;
+        double scoreMulti;
+        findMotifs(batch, 4, positionsMulti, tryMulti, scoreMulti);
+        
+        REQUIRE(positionsMulti.size() == batch.size());
+        REQUIRE(positionsMulti == positionsSingle);
+        REQUIRE(tryMulti == trySingle);
+        REQUIRE(scoreMulti == scoreSingle);
+    }
+    
+    SECTION("Repeated runs on 4 threads agree") {
+        for (size_t run = 0; run < 3; run++) {
+            vector<NumSequence::size_type> positionsMulti;
+            unsigned tryMulti;
+            double scoreMulti;
+            findMotifs(batch, 4, positionsMulti, tryMulti, scoreMulti);
+            
+            REQUIRE(positionsMulti == positionsSingle);
+            REQUIRE(tryMulti == trySingle);
+        }
+    }
+    
+    SECTION("Invalid rows get no position") {
+        for (size_t n = 0; n < batch.size(); n++) {
+            if (!batch.isValid(n))
+                REQUIRE(positionsSingle[n] == NumSequence::npos);
+        }
+    }
+}
@@ -0,0 +1,192 @@
+//
+//  test_MotifModels.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <sstream>
+
+#include "catch.hpp"
+#include "CountModelsV1.hpp"
+#include "ProbabilityModelsV1.hpp"
+#include "SequenceBatch.hpp"
+#include "RandomGenerator.hpp"
+#include "NumAlphabetDNA.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+// build a batch of random sequences of different lengths; one row is as long as the motif, and one is invalid
+static SequenceBatch randomBatch(size_t numSequences, size_t width, RandomGenerator &rng, const CharNumConverter &cnc) {
+    
+    const char letters[] = {'A', 'C', 'G', 'T'};
+    
+    SequenceBatch batch (width + 30);
+    for (size_t n = 0; n < numSequences; n++) {
+        size_t length = (n == 0 ? width : width + rng() % 30);
+        
+        string str (length, 'A');
+        for (size_t i = 0; i < length; i++)
+            str[i] = letters[rng() % 4];
+        
+        batch.push_back(NumSequence(Sequence(str), cnc), n != 1);
+    }
+    
+    return batch;
+}
+
+// pick a motif position: either end of the sequence, a random position, or none (filtered out)
+static NumSequence::size_type randomPosition(const SequenceBatch &batch, SequenceBatch::size_type n, size_t width, RandomGenerator &rng) {
+    
+    NumSequence::size_type last = batch.length(n) - width;
+    
+    switch (rng() % 4) {
+        case 0:     return 0;
+        case 1:     return last;
+        case 2:     return NumSequence::npos;
+        default:    return rng() % (last + 1);
+    }
+}
+
+// everything the motif finder reads from probability models: the models themselves, the CLL, and
+// the score of every motif position (which is read from the scoring tables)
+static string describe(ProbabilityModelsV1 &probs, const SequenceBatch &batch) {
+    
+    ostringstream ssm;
+    ssm.precision(17);
+    ssm << probs.toString() << "\nCLL " << probs.computeCLL() << "\n";
+    
+    vector<double> scores;
+    for (SequenceBatch::size_type n = 0; n < batch.size(); n++) {
+        if (!batch.isValid(n))
+            continue;
+        
+        probs.computePositionScores(batch, n, scores);
+        for (size_t i = 0; i < scores.size(); i++)
+            ssm << scores[i] << " ";
+        ssm << "\n";
+    }
+    
+    return ssm.str();
+}
+
+TEST_CASE("Testing CountModelsV1 - counting and decounting motifs") {
+    
+    AlphabetDNA alph;
+    CharNumConverter cnc (&alph);
+    NumAlphabetDNA numAlph (alph, cnc);
+    
+    const size_t width = 6;
+    const size_t numMoves = 300;
+    
+    MFinderModelParams::align_t aligns[] = {MFinderModelParams::NONE, MFinderModelParams::LEFT, MFinderModelParams::RIGHT};
+    unsigned orders[] = {0, 2};
+    
+    // move motifs one at a time (including to either end of their sequence), and compare the
+    // counts with counts constructed from scratch, through the models built from each
+    for (size_t a = 0; a < 3; a++) {
+        for (size_t o = 0; o < 2; o++) {
+            
+            RandomGenerator rng (100 * a + o);
+            SequenceBatch batch = randomBatch(12, width, rng, cnc);
+            
+            vector<NumSequence::size_type> positions (batch.size());
+            for (size_t n = 0; n < batch.size(); n++)
+                positions[n] = randomPosition(batch, n, width, rng);
+            
+            CountModelsV1 counts (numAlph, width, orders[o], orders[o], aligns[a]);
+            counts.construct(batch, positions);
+            
+            size_t mismatches = 0;
+            for (size_t move = 0; move < numMoves; move++) {
+                SequenceBatch::size_type n = rng() % batch.size();
+                if (!batch.isValid(n))
+                    continue;
+                
+                counts.decount(batch, n, positions[n]);
+                positions[n] = randomPosition(batch, n, width, rng);
+                counts.count(batch, n, positions[n]);
+                
+                if (move % 20 != 0 && move != numMoves - 1)
+                    continue;
+                
+                CountModelsV1 fresh (numAlph, width, orders[o], orders[o], aligns[a]);
+                fresh.construct(batch, positions);
+                
+                ProbabilityModelsV1 probs (numAlph, width, orders[o], orders[o], 1, aligns[a]);
+                ProbabilityModelsV1 freshProbs (numAlph, width, orders[o], orders[o], 1, aligns[a]);
+                probs.construct(&counts);
+                freshProbs.construct(&fresh);
+                
+                if (describe(probs, batch) != describe(freshProbs, batch))
+                    mismatches++;
+            }
+            
+            INFO("align " << aligns[a] << ", order " << orders[o]);
+            REQUIRE(mismatches == 0);
+        }
+    }
+}
+
+TEST_CASE("Testing ProbabilityModelsV1 - incremental updates") {
+    
+    AlphabetDNA alph;
+    CharNumConverter cnc (&alph);
+    NumAlphabetDNA numAlph (alph, cnc);
+    
+    const size_t width = 6;
+    const size_t numMoves = 300;
+    
+    MFinderModelParams::align_t aligns[] = {MFinderModelParams::NONE, MFinderModelParams::LEFT, MFinderModelParams::RIGHT};
+    unsigned orders[] = {0, 2};
+    
+    // move motifs one at a time as the gibbs sampler does (update after each decount and count),
+    // and compare the models with models constructed from scratch on the same positions
+    for (size_t a = 0; a < 3; a++) {
+        for (size_t o = 0; o < 2; o++) {
+            
+            RandomGenerator rng (100 * a + o + 50);
+            SequenceBatch batch = randomBatch(12, width, rng, cnc);
+            
+            vector<NumSequence::size_type> positions (batch.size());
+            for (size_t n = 0; n < batch.size(); n++)
+                positions[n] = randomPosition(batch, n, width, rng);
+            
+            CountModelsV1 counts (numAlph, width, orders[o], orders[o], aligns[a]);
+            counts.construct(batch, positions);
+            
+            ProbabilityModelsV1 probs (numAlph, width, orders[o], orders[o], 1, aligns[a]);
+            probs.construct(&counts);
+            
+            size_t mismatches = 0;
+            for (size_t move = 0; move < numMoves; move++) {
+                SequenceBatch::size_type n = rng() % batch.size();
+                if (!batch.isValid(n))
+                    continue;
+                
+                counts.decount(batch, n, positions[n]);
+                probs.update(&counts, batch, n, positions[n]);
+                positions[n] = randomPosition(batch, n, width, rng);
+                counts.count(batch, n, positions[n]);
+                probs.update(&counts, batch, n, positions[n]);
+                
+                if (move % 20 != 0 && move != numMoves - 1)
+                    continue;
+                
+                CountModelsV1 fresh (numAlph, width, orders[o], orders[o], aligns[a]);
+                fresh.construct(batch, positions);
+                
+                ProbabilityModelsV1 freshProbs (numAlph, width, orders[o], orders[o], 1, aligns[a]);
+                freshProbs.construct(&fresh);
+                
+                if (describe(probs, batch) != describe(freshProbs, batch))
+                    mismatches++;
+            }
+            
+            INFO("align " << aligns[a] << ", order " << orders[o]);
+            REQUIRE(mismatches == 0);
+        }
+    }
+}
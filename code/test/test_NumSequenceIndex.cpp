@@ -0,0 +1,68 @@
+//
+//  test_NumSequenceIndex.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+#include <string>
+#include <stdexcept>
+
+#include "catch.hpp"
+#include "Sequence.hpp"
+#include "NumSequence.hpp"
+#include "NumSequenceIndex.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+TEST_CASE("Testing NumSequenceIndex") {
+    
+    AlphabetDNA alph;
+    CharNumConverter cnc(&alph);
+    NumAlphabetDNA numAlph(alph, cnc);
+    
+    // long enough to span several blocks, with ambiguous letters on either side of a block boundary
+    string text;
+    for (size_t n = 0; n < 20; n++)
+        text += "ACGTTGCAAT";
+    text[63] = 'N';
+    text[64] = 'R';
+    text[150] = 'N';
+    
+    NumSequence sequence (Sequence(text), cnc);
+    NumSequenceIndex index (sequence, numAlph);
+    
+    SECTION("Counts match a scan of every window") {
+        bool allMatch = true;
+        for (size_t left = 0; left <= text.size(); left += 7) {
+            for (size_t length = 0; left + length <= text.size(); length += 5) {
+                size_t numAmbiguous = 0, numGC = 0;
+                for (size_t i = left; i < left + length; i++) {
+                    numAmbiguous += (text[i] == 'N' || text[i] == 'R');
+                    numGC += (text[i] == 'G' || text[i] == 'C');
+                }
+                
+                allMatch &= (index.numAmbiguous(left, length) == numAmbiguous);
+                allMatch &= (index.numGC(left, length) == numGC);
+            }
+        }
+        
+        REQUIRE(allMatch);
+        REQUIRE(index.gc(0, 10) == 40);
+        REQUIRE(index.gc(5, 0) == 0);
+    }
+    
+    SECTION("Views are checked on either strand") {
+        REQUIRE(index.containsInvalid(NumSequenceView(sequence, cnc, 0, 63)) == false);
+        REQUIRE(index.containsInvalid(NumSequenceView(sequence, cnc, 60, 4, true)) == true);
+        REQUIRE(index.containsInvalid(NumSequenceView(sequence, cnc, 65, 85, true)) == false);
+        
+        NumSequence other (Sequence("ACGT"), cnc);
+        REQUIRE_THROWS_AS(index.containsInvalid(NumSequenceView(other, cnc, 0, 2)), invalid_argument);
+    }
+    
+    SECTION("Windows past the end are rejected") {
+        REQUIRE(index.numGC(text.size(), 0) == 0);
+        REQUIRE_THROWS_AS(index.numGC(text.size() - 1, 2), out_of_range);
+    }
+}
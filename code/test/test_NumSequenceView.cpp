@@ -0,0 +1,67 @@
+//
+//  test_NumSequenceView.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+
+#include "catch.hpp"
+#include "Sequence.hpp"
+#include "NumSequence.hpp"
+#include "NumSequenceView.hpp"
+#include "NonUniformCounts.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+TEST_CASE("Testing NumSequenceView") {
+
+    AlphabetDNA alph;
+    CharNumConverter cnc(&alph);
+    NumAlphabetDNA numAlph(alph, cnc);
+
+    NumSequence sequence (Sequence("AACGTTGCAN"), cnc);
+
+    SECTION("Positive strand reads the window as is") {
+        NumSequenceView view (sequence, cnc, 1, 4);
+
+        NumSequence viewCopy = view.toNumSequence();
+        REQUIRE(view.size() == 4);
+        REQUIRE(cnc.convert(viewCopy.begin(), viewCopy.end()) == "ACGT");
+        REQUIRE(view[2] == cnc.convert('G'));
+    }
+
+    SECTION("Negative strand reads the reverse complement, at the start of the sequence") {
+        NumSequenceView view (sequence, cnc, 0, 3, true);
+        NumSequence copy = sequence.subseq(0, 3);
+        copy.reverseComplement(cnc);
+
+        NumSequence viewCopy = view.toNumSequence();
+        REQUIRE(cnc.convert(viewCopy.begin(), viewCopy.end()) == cnc.convert(copy.begin(), copy.end()));
+        REQUIRE(view.end() - view.begin() == 3);
+    }
+
+    SECTION("Subviews are taken in reading order") {
+        NumSequenceView view (sequence, cnc, 2, 6, true);               // CGTTGC -> GCAACG
+        NumSequence sub = view.subview(1, 3).toNumSequence();
+
+        REQUIRE(cnc.convert(sub.begin(), sub.end()) == "CAA");
+        REQUIRE_THROWS(view.subview(4, 3));
+    }
+
+    SECTION("Counting a view equals counting its copy") {
+        NumSequenceView view (sequence, cnc, 1, 6, true);
+        NumSequence copy = view.toNumSequence();
+
+        NonUniformCounts fromView (1, 6, numAlph), fromCopy (1, 6, numAlph);
+        fromView.count(view);
+        fromCopy.count(copy.begin(), copy.end());
+
+        REQUIRE(fromView.toString() == fromCopy.toString());
+    }
+
+    SECTION("Ambiguous letters are found on either strand") {
+        REQUIRE(NumSequenceView(sequence, cnc, 7, 3, true).containsInvalid(numAlph));
+        REQUIRE(!NumSequenceView(sequence, cnc, 0, 9).containsInvalid(numAlph));
+    }
+}
@@ -0,0 +1,84 @@
+//
+//  test_RandomGenerator.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+#include <set>
+#include <vector>
+
+#include "catch.hpp"
+#include "RandomGenerator.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+typedef RandomGenerator::result_type result_type;
+
+// draw the first values of a generator
+static vector<result_type> draw(RandomGenerator rng, size_t count) {
+    vector<result_type> values (count);
+    for (size_t i = 0; i < count; i++)
+        values[i] = rng();
+    return values;
+}
+
+TEST_CASE("Testing RandomGenerator") {
+    
+    SECTION("A seed gives a fixed sequence (xoshiro256**, seeded through splitmix64)") {
+        RandomGenerator zero (0);
+        REQUIRE(zero() == 0x99ec5f36cb75f2b4ULL);
+        REQUIRE(zero() == 0xbf6e1f784956452aULL);
+        REQUIRE(zero() == 0x1a5f849d4933e6e0ULL);
+        
+        RandomGenerator rng;
+        REQUIRE(rng.getSeed() == RandomGenerator::DEFAULT_SEED);
+        REQUIRE(rng() == 0xef33f17055244b74ULL);
+        REQUIRE(rng() == 0xe1f591112fb5051bULL);
+        REQUIRE(rng() == 0xd8ab05640214863aULL);
+    }
+    
+    SECTION("Reseeding restarts the sequence") {
+        RandomGenerator rng (42);
+        vector<result_type> first = draw(rng, 8);
+        
+        for (size_t i = 0; i < 5; i++)
+            rng();
+        rng.seed(42);
+        
+        REQUIRE(draw(rng, 8) == first);
+        REQUIRE(draw(RandomGenerator(43), 8) != first);
+    }
+    
+    SECTION("Uniform values are in [0,1)") {
+        RandomGenerator rng (7);
+        size_t outside = 0;
+        for (size_t i = 0; i < 10000; i++) {
+            double u = rng.uniform();
+            if (u < 0 || u >= 1)
+                outside++;
+        }
+        
+        REQUIRE(outside == 0);
+    }
+    
+    SECTION("Split streams are distinct, and reproducible") {
+        RandomGenerator rng (42);
+        
+        set<vector<result_type> > streams;
+        for (result_type k = 0; k < 64; k++)
+            streams.insert(draw(rng.split(k), 4));
+        
+        REQUIRE(streams.size() == 64);
+        REQUIRE(streams.count(draw(rng, 4)) == 0);
+        
+        // a stream depends only on the seed and its index, not on values already drawn
+        vector<result_type> stream = draw(rng.split(3), 4);
+        for (size_t i = 0; i < 10; i++)
+            rng();
+        
+        REQUIRE(draw(rng.split(3), 4) == stream);
+        REQUIRE(draw(RandomGenerator(42).split(3), 4) == stream);
+        REQUIRE(draw(RandomGenerator(43).split(3), 4) != stream);
+    }
+}
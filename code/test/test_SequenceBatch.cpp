@@ -0,0 +1,81 @@
+//
+//  test_SequenceBatch.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+
+#include "catch.hpp"
+#include "Sequence.hpp"
+#include "NumSequence.hpp"
+#include "SequenceBatch.hpp"
+#include "MotifFinder.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+TEST_CASE("Testing SequenceBatch") {
+
+    AlphabetDNA alph;
+    CharNumConverter cnc(&alph);
+    NumAlphabetDNA numAlph(alph, cnc);
+
+    vector<NumSequence> sequences;
+    sequences.push_back(NumSequence(Sequence("TTAGGAGGTTACATG"), cnc));
+    sequences.push_back(NumSequence(Sequence("CAGGAGGTCANGT"), cnc));
+    sequences.push_back(NumSequence(Sequence("GGAGGATTTACCGATG"), cnc));
+    sequences.push_back(NumSequence(Sequence("ACTTAAGGAGGTAAT"), cnc));
+
+    SECTION("Rows keep their own length and contents") {
+        SequenceBatch batch (sequences);
+
+        REQUIRE(batch.size() == 4);
+        REQUIRE(batch.stride() == 16);
+        REQUIRE(batch.length(1) == 13);
+
+        NumSequence row = batch.toNumSequence(1);
+        REQUIRE(cnc.convert(row.begin(), row.end()) == "CAGGAGGTCANGT");
+        REQUIRE_THROWS(SequenceBatch(4).push_back(sequences[0]));
+    }
+
+    SECTION("Rows with ambiguous letters are invalidated") {
+        SequenceBatch batch (sequences);
+        batch.invalidateAmbiguous(numAlph);
+
+        REQUIRE(batch.numValid() == 3);
+        REQUIRE(!batch.isValid(1));
+        REQUIRE(batch.isValid(2));
+    }
+
+    SECTION("Searching a batch skips invalid rows") {
+        OptionsMFinder options("mfinder");
+        options.width = 5;
+        options.motifOrder = 0;
+        options.bkgdOrder = 0;
+        options.tries = 3;
+        options.maxIter = 20;
+        options.maxEMIter = 5;
+        options.shiftEvery = 5;
+
+        MotifFinder::Builder b;
+        MotifFinder mfinder = b.build(options);
+
+        SequenceBatch batch (sequences);
+        batch.invalidateAmbiguous(numAlph);
+
+        vector<NumSequence> validOnly;
+        validOnly.push_back(sequences[0]);
+        validOnly.push_back(sequences[2]);
+        validOnly.push_back(sequences[3]);
+
+        vector<NumSequence::size_type> fromBatch, fromValid;
+        mfinder.findMotifs(batch, fromBatch);
+        mfinder.findMotifs(validOnly, fromValid);
+
+        REQUIRE(fromBatch.size() == 4);
+        REQUIRE(fromBatch[1] == (NumSequence::size_type) NumSequence::npos);
+        REQUIRE(fromBatch[0] == fromValid[0]);
+        REQUIRE(fromBatch[2] == fromValid[1]);
+        REQUIRE(fromBatch[3] == fromValid[2]);
+    }
+}
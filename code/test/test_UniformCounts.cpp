@@ -44,7 +44,8 @@ void testOrder(unsigned order) {
     UniformMarkov m(order,numAlph);
     m.construct(&counts);
     
-    NumSequence s = m.emit(10);
+    RandomGenerator rng;
+    NumSequence s = m.emit(10, rng);
     cout << cnc.convert(s.begin(), s.end()) << endl;
     
 }
@@ -0,0 +1,56 @@
+//
+//  test_UnivariatePDF.cpp
+//  GeneMark Suite
+//
+
+#include <stdio.h>
+#include <math.h>
+
+#include "catch.hpp"
+#include "UnivariatePDF.hpp"
+#include "RandomGenerator.hpp"
+
+using namespace std;
+using namespace gmsuite;
+
+TEST_CASE("Testing UnivariatePDF sampling") {
+    
+    RandomGenerator rng (7);
+    const size_t numSamples = 100000;
+    
+    SECTION("Samples follow the distribution") {
+        double weights[] = {1, 0, 3, 6};
+        UnivariatePDF pdf (vector<double>(weights, weights + 4));
+        
+        vector<size_t> counts (pdf.size(), 0);
+        for (size_t n = 0; n < numSamples; n++)
+            counts[pdf.sample(rng)]++;
+        
+        REQUIRE(counts[1] == 0);
+        for (size_t i = 0; i < pdf.size(); i++)
+            REQUIRE(fabs(counts[i] / (double) numSamples - pdf[i]) < 0.01);
+    }
+    
+    SECTION("Samples from log-weights follow the distribution, without overflowing") {
+        // exp(1000) overflows, so these only sample correctly if shifted by their maximum
+        double logWeights[] = {1000, 1000 + log(3.0), -HUGE_VAL};
+        double expected[] = {0.25, 0.75, 0};
+        
+        vector<size_t> counts (3, 0);
+        for (size_t n = 0; n < numSamples; n++) {
+            vector<double> buffer (logWeights, logWeights + 3);
+            counts[UnivariatePDF::sampleFromLogWeights(buffer, rng)]++;
+        }
+        
+        for (size_t i = 0; i < 3; i++)
+            REQUIRE(fabs(counts[i] / (double) numSamples - expected[i]) < 0.01);
+    }
+    
+    SECTION("Empty distributions cannot be sampled") {
+        UnivariatePDF pdf;
+        vector<double> buffer;
+        
+        REQUIRE_THROWS_AS(pdf.sample(rng), domain_error);
+        REQUIRE_THROWS_AS(UnivariatePDF::sampleFromLogWeights(buffer, rng), domain_error);
+    }
+}
@@ -10,6 +10,7 @@ use warnings;
 use Cwd 'abs_path';
 use Getopt::Long;
 use File::Basename;
+use IPC::Open2;
 
 # get script name
 my $scriptName = basename($0);
@@ -25,6 +26,10 @@ my $predictor = "$scriptPath/gmhmmp2";      # predicting genes
 
 my $comparePrediction = "$scriptPath/compp";    # compare prediction files to check for convergence
 
+# Trainer session: a single trainer process runs all training and experiment commands, so that the
+# genome and labels are read once rather than by every command (see RunInSession)
+my ($sessionPid, $sessionIn, $sessionOut);
+
 # ------------------------------ #
 #      Modes for iterations      #
 # ------------------------------ #
@@ -69,6 +74,7 @@ my $D_COD_ORDER                         = 5                                 ;
 my $D_NONCOD_ORDER                      = 2                                 ;
 my $D_START_CONTEXT_ORDER               = 2                                 ;
 my $D_FGIO_DIST_THRESH                  = 25                                ;
+my $D_NUM_THREADS                       = 1                                 ;
 
 # ------------------------------ #
 #    Command-line variables      #
@@ -144,6 +150,7 @@ my $mgmType = $D_MGMTYPE                                                    ;
 my $verbose                                                                 ;       # verbose mode
 my $keepAllFiles                                                            ;
 my $forceGroup                                                              ;
+my $numThreads                          = $D_NUM_THREADS                    ;       # number of threads used in training
 
 # Parse command-line options
 GetOptions (
@@ -204,6 +211,7 @@ GetOptions (
     'mgm-type=s'                            =>  \$mgmType,
     'keep-all-files'                        =>  \$keepAllFiles,
     'force-group=s'                         =>  \$forceGroup,
+    'num-threads=i'                         =>  \$numThreads,
 );
 
 Usage($scriptName) if (!defined $fn_genome or !defined $genomeType or !isValidGenomeType($genomeType));
@@ -215,13 +223,6 @@ my $testGroupB_PromoterMatchedRBS;
 # setup temporary file collection
 my @tempFiles;
 
-# create "single fasta format" from multifasta file
-my $fnseq = "tmpseq.fna";
-MultiToSingleFASTA($fn_genome, $fnseq);
-
-# add temporary files
-push @tempFiles, ($fnseq) unless $keepAllFiles;
-
 my $mgmMod = "$scriptPath/mgm_$geneticCode.mod";        # name of MGM mod file (based on genetic code)
 my $modForFinalPred = "tmp.mod";                        # used to keep a version of the model at every iteration 
 
@@ -242,8 +243,8 @@ my $testGroupAStep2 = $testGroupA;
 # Run initial MGM prediction
 #----------------------------------------
 my $mgmPred = CreatePredFileName("0");                  # create a prediction filename for iteration 0
-#run("$scriptPath/gmhmmp2 -M $mgmMod -s $fnseq -o $mgmPred --mgm_type $mgmType ");       # Run MGM
-run("$predictor -M $mgmMod -s $fnseq -o $mgmPred --mgm_type $mgmType ");       # Run MGM
+#run("$scriptPath/gmhmmp2 -M $mgmMod -s $fn_genome -o $mgmPred --mgm_type $mgmType ");       # Run MGM
+run("$predictor -M $mgmMod -s $fn_genome -o $mgmPred --mgm_type $mgmType ");       # Run MGM
 
 # add temporary files
 push @tempFiles, ($mgmPred) unless $keepAllFiles;
@@ -452,6 +453,7 @@ $extraOutput .= "--NT $fnNN " if defined $fnNN;
 
 run("$predictor -m $finalMod -M $finalMGM -s $fn_genome -o $finalPred --format $formatOutput $extraOutput");
 
+EndSession();
 run ("rm -f @tempFiles");
 
 
@@ -462,82 +464,74 @@ sub NumOfIterRemaining {
     return $maxIter - $prevIter;
 }
 
-# Return true if the FGIO that don't match 16S have a localized signal located before the distance threshold
-sub FGIONotMatching16SHaveSignalBeforeThresh {
-    my ($prevIter, $distThresh, $scoreThresh, $windowSize) = @_;
+# Run group-membership checks on a model in a single experiment process. Checks are given by name,
+# each with its options (named without the check prefix); returns the output of each check, by name.
+# A check that fails to run has an empty output, as if its own experiment had failed.
+sub ValidateGroups {
+    my ($fnmod, %checks) = @_;
+
+    my $command = "experiment validate-groups --fnmod $fnmod --checks " . join(" ", sort keys %checks);
+    foreach my $check (sort keys %checks) {
+        foreach my $option (sort keys %{$checks{$check}}) {
+            my $value = $checks{$check}{$option};
+            $command .= " --$check-$option";
+            $command .= " $value" if defined $value;
+        }
+    }
 
-    $prevPred = "itr_$prevIter.lst";
-    $prevMod = "itr_$prevIter.mod";
-    #my $isBacteriaProm = run("$trainer experiment promoter-is-valid-for-bacteria --fnmod $prevMod --dist-thresh $distThresh --score-thresh $scoreThresh");
-    my $isBacteriaProm = run("$trainer experiment promoter-is-valid-for-bacteria --fnmod $prevMod --dist-thresh $distThresh --score-thresh $scoreThresh --window-size $windowSize --min-leaderless-percent 11 --min-leaderless-count 100 --fnlabels $prevPred --fnseq $fnseq");
+    my %outputs;
+    foreach my $line (split("\n", RunInSession($command))) {
+        my ($check, $output) = split("\t", $line, 2);
+        if ($output =~ /^error\t(.*)$/) {
+            print "Check $check failed: $1\n" if defined $verbose;
+            $output = "";
+        }
+        $outputs{$check} = $output;
+    }
 
-    chomp $isBacteriaProm;
-    return $isBacteriaProm eq "yes";
+    return %outputs;
 }
 
-sub RBSSignalLocalized {
+# Check (for ValidateGroups) that the FGIO that don't match 16S have a localized signal located before the distance threshold
+sub FGIONotMatching16SHaveSignalBeforeThresh {
     my ($prevIter, $distThresh, $scoreThresh, $windowSize) = @_;
 
-    my $fnmod = "itr_$prevIter.mod";
+    return ("promoter-is-valid-for-bacteria" => { "dist-thresh" => $distThresh, "score-thresh" => $scoreThresh, "window-size" => $windowSize,
+                                                  "min-leaderless-percent" => 11, "min-leaderless-count" => 100,
+                                                  "fnlabels" => CreatePredFileName($prevIter), "fnseq" => $fn_genome });
+}
 
-    my $rbsIsLocalized = run("$trainer experiment rbs-is-localized --fnmod $prevMod --dist-thresh $distThresh --score-thresh $scoreThresh --window-size $windowSize");
-    chomp $rbsIsLocalized;
+# Check (for ValidateGroups) that the RBS spacer signal is localized
+sub RBSSignalLocalized {
+    my ($distThresh, $scoreThresh, $windowSize) = @_;
 
-    return $rbsIsLocalized eq "yes";
+    return ("rbs-is-localized" => { "dist-thresh" => $distThresh, "score-thresh" => $scoreThresh, "window-size" => $windowSize });
 }
 
-# Return true if the FGIO have a localized motif signal located further than a distance threshold
+# Check (for ValidateGroups) that the FGIO have a localized motif signal located further than a distance threshold
 sub FGIOHaveSignalAfterThresh {
-    my ($prevIter, $distThresh, $scoreThresh, $windowSize) = @_;
-
-    $prevMod = "itr_$prevIter.mod";
-    #my $isArchaea = run("$trainer experiment promoter-is-valid-for-archaea --fnmod $prevMod --dist-thresh $distThresh");
-    my $isArchaea = run("$trainer experiment promoter-is-valid-for-archaea --fnmod $prevMod --dist-thresh $distThresh --score-thresh $scoreThresh --window-size $windowSize");
+    my ($distThresh, $scoreThresh, $windowSize) = @_;
 
-    chomp $isArchaea;
-
-    return $isArchaea eq "yes";
+    return ("promoter-is-valid-for-archaea" => { "dist-thresh" => $distThresh, "score-thresh" => $scoreThresh, "window-size" => $windowSize });
 }
 
-# Return true if the fraction of predicted RBS is greater than the threshold
+# Check (for ValidateGroups) the number of predicted RBS that match the 16S tail; outputs "<total> <matched>"
 sub PredictedRBSMatch16S {
     my ($fnpred, $seq16S, $minMatch) = @_;
 
-    my $rbsMatchedOutput = run("$trainer experiment match-rbs-to-16s --fnlabels $fnpred --match-to $seq16S --min-match $minMatch --allow-ag-sub");
-
-    my @matchInfo = split(' ', $rbsMatchedOutput);
-    my $percentMatched = $matchInfo[1] / $matchInfo[0];
-
-    # my $denom=system('cat $fnpred | grep -E "(native|atypical)[[:space:]]+[ACGT]+[[:space:]]+[[:digit:]]+[[:space:]]+1[[:space:]]*" | wc -l');
-    # $percentMatched = $matchInfo[1] / $denom;
-
-    print "Percent of matched RBS: $percentMatched\n" if defined $verbose;
-
-    return $percentMatched >= $groupD_percentMatchRBS;
+    return ("match-rbs-to-16s" => { "fnlabels" => $fnpred, "match-to" => $seq16S, "min-match" => $minMatch, "allow-ag-sub" => undef });
 }
 
-# Return true if the Promoter and RBS model consensus sequences match each other
+# Check (for ValidateGroups) that the Promoter and RBS model consensus sequences match each other
 sub PromoterAndRBSConsensusMatch {
-    my ($prevIter, $minMatch) = @_;
+    my ($minMatch) = @_;
 
-    my $fnmod = "itr_$prevIter.mod";
-
-    my $isGroupC = run("$trainer experiment promoter-and-rbs-match --fnmod $fnmod --match-thresh $minMatch");
-    chomp $isGroupC;
-
-    return $isGroupC eq "yes";
+    return ("promoter-and-rbs-match" => { "match-thresh" => $minMatch });
 }
 
-# Return true if the RBS model consensus matches the 16S tail
+# Check (for ValidateGroups) that the RBS model consensus matches the 16S tail
 sub RBSConsensusAnd16SMatch {
-    my ($prevIter, $minMatch) = @_;
-
-    my $fnmod = "itr_$prevIter.mod";
-
-    my $isMatched = run("$trainer experiment rbs-consensus-and-16s-match --fnmod $fnmod --allow-ag-sub");
-    chomp $isMatched;
-
-    return $isMatched eq "yes";
+    return ("rbs-consensus-and-16s-match" => { "allow-ag-sub" => undef });
 }
 
 # Run GMS2 iterations in a particular mode
@@ -571,7 +565,7 @@ sub RunIterations {
 
         # Training step: use prediction of previous iteration
         my $trainingCommand = GetTrainingCommand($iter, $mode);          # construct training command
-        run("$trainingCommand");                                         # run training command
+        RunInSession("$trainingCommand");                                # run training command
 
         # add bacteria and archaea probability to model file
         AddToModel($currMod, "TO_ATYPICAL_FIRST_BACTERIA", $bacProb);
@@ -585,7 +579,7 @@ sub RunIterations {
         AddToModel($currMod, "TO_NATIVE", $toNativeProb);
 
         # Prediction step: using current model file
-        my $errCode = run("$predictor -m $currMod -M $mgmMod -s $fnseq -o $currPred --format train");
+        my $errCode = run("$predictor -m $currMod -M $mgmMod -s $fn_genome -o $currPred --format train");
 
         # Check for convergence
         my $similarity = run("$comparePrediction -n -a $prevPred -b $currPred -G");
@@ -623,6 +617,48 @@ sub run {
     return $value;
 }
 
+# Run a trainer command (its mode followed by its options) in the session, and log it. Returns the
+# command's output, or an empty output if the command failed.
+sub RunInSession {
+    my $command = shift;
+    open(FILE, ">>log");
+    print FILE "$trainer $command\n";
+
+    local $SIG{PIPE} = 'IGNORE';            # a session that died is detected by its missing status
+
+    $sessionPid = open2($sessionOut, $sessionIn, "$trainer session") unless defined $sessionPid;
+    print $sessionIn "$command\n";
+
+    # the command's output is followed by its status line
+    my $value = "";
+    while (my $line = <$sessionOut>) {
+        if ($line =~ /^##status (\S+)\s*(.*)$/) {
+            print "Trainer command failed: $2\n" if ($1 ne "ok" and defined $verbose);
+            $value = "" if ($1 ne "ok");
+            chomp($value);
+            return $value;
+        }
+        $value .= $line;
+    }
+
+    # the session ended without a status: start a new one for the next command
+    print "Trainer session ended unexpectedly\n" if defined $verbose;
+    EndSession();
+    return "";
+}
+
+# End the trainer session, if one is running
+sub EndSession {
+    return unless defined $sessionPid;
+
+    local $SIG{PIPE} = 'IGNORE';
+    print $sessionIn "quit\n";
+    close($sessionIn);
+    close($sessionOut);
+    waitpid($sessionPid, 0);
+    undef $sessionPid;
+}
+
 # Estimate bacteria and archaea probabilities based on the counts in the prediction file
 sub EstimateBacArc {
     my $fname = shift;
@@ -735,16 +771,6 @@ sub EstimateNativeAtypical {
     return ( sprintf( "%.5f", $probNative ), sprintf( "%.5f", $probAtypical) );
 }
 
-# Converts a multifasta file to single fasta by concatenating all sequences into one
-sub MultiToSingleFASTA {
-    # input and output filenames
-    my ($fnin, $fnout) = @_;
-    
-    run ("echo '>anydef' > $fnout");
-    run ("grep -v '>' $fnin >> $fnout");
-    return;
-}
-
 # Add label/value pair to a model file
 sub AddToModel {
     my ( $fname, $label, $value ) = @_;
@@ -794,16 +820,20 @@ sub isValidGenomeType {
 sub IsGroupA {
     my $iter = $_[0];
 
-    my $testResult = FGIOHaveSignalAfterThresh($iter, $groupA_spacerDistThresh, $groupA_spacerScoreThresh, $groupA_spacerWindowSize);
+    my %outputs = ValidateGroups(CreateModFileName($iter), FGIOHaveSignalAfterThresh($groupA_spacerDistThresh, $groupA_spacerScoreThresh, $groupA_spacerWindowSize));
 
-    return $testResult;
+    return $outputs{"promoter-is-valid-for-archaea"} eq "yes";
 }
 
 sub IsGroupB {
     my $iter = $_[0];
 
-    my $test1 = FGIONotMatching16SHaveSignalBeforeThresh($iter, $groupB_spacerDistThresh, $groupB_spacerScoreThresh, $groupB_spacerWindowSize);
-    my $test2 = PromoterAndRBSConsensusMatch($iter, $groupC_minMatchPromoterRBS);
+    my %outputs = ValidateGroups(CreateModFileName($iter),
+                                 FGIONotMatching16SHaveSignalBeforeThresh($iter, $groupB_spacerDistThresh, $groupB_spacerScoreThresh, $groupB_spacerWindowSize),
+                                 PromoterAndRBSConsensusMatch($groupC_minMatchPromoterRBS));
+
+    my $test1 = $outputs{"promoter-is-valid-for-bacteria"} eq "yes";
+    my $test2 = $outputs{"promoter-and-rbs-match"} eq "yes";
 
     $testGroupB_PromoterMatchedRBS = $test2;
 
@@ -818,11 +848,14 @@ sub IsGroupB {
 sub IsGroupC {
     my $iter = $_[0];
 
-    my $test = RBSConsensusAnd16SMatch($iter, $groupC_minMatchRBS16S);
+    # both checks run together, though localization only matters when the consensus doesn't match
+    my %outputs = ValidateGroups(CreateModFileName($iter), RBSConsensusAnd16SMatch(), RBSSignalLocalized(14, 0.15, 1));
+
+    my $test = $outputs{"rbs-consensus-and-16s-match"} eq "yes";
 
     if (!$test) {
 
-        if (RBSSignalLocalized($iter, 14, 0.15, 1)) {
+        if ($outputs{"rbs-is-localized"} eq "yes") {
             return 1;
         }
         return 0;
@@ -852,9 +885,16 @@ sub IsGroupD {
 
     my $fnpred = CreatePredFileName($iter);
 
-    my $test = PredictedRBSMatch16S($fnpred, $groupD_tail16S, $groupD_minMatchRBS16S);
+    my %outputs = ValidateGroups(CreateModFileName($iter), PredictedRBSMatch16S($fnpred, $groupD_tail16S, $groupD_minMatchRBS16S));
 
-    return $test;
+    my @matchInfo = split(' ', $outputs{"match-rbs-to-16s"});
+    return undef if (@matchInfo < 2 or $matchInfo[0] == 0);
+
+    my $percentMatched = $matchInfo[1] / $matchInfo[0];
+
+    print "Percent of matched RBS: $percentMatched\n" if defined $verbose;
+
+    return $percentMatched >= $groupD_percentMatchRBS;
 
 }
 
@@ -888,7 +928,7 @@ sub GetTrainingCommand {
     
 
     # Training step: use prediction of previous iteration
-    my $trainingCommand = "$trainer gms2-training -s $fnseq -l $prevPred -m $currMod --order-coding $orderCod --order-noncoding $orderNon --only-train-on-native $nativeOnly --genetic-code $geneticCode --order-start-context $scOrder --fgio-dist-thr $fgioDistThresh";
+    my $trainingCommand = "gms2-training -s $fn_genome -l $prevPred -m $currMod --order-coding $orderCod --order-noncoding $orderNon --only-train-on-native $nativeOnly --genetic-code $geneticCode --order-start-context $scOrder --fgio-dist-thr $fgioDistThresh --num-threads $numThreads";
 
 
     if ($mode eq $modeNoMotif) {
@@ -985,6 +1025,7 @@ mgm-type                                Type of genome model to use for MGM pred
                                         Option: bac, arc, auto. Default: (default: $D_MGMTYPE)
 keep-all-files                          Keep all intermediary files 
 fgio-dist-thresh                        Distance threshold for FGIO identification
+num-threads                             Number of threads used in training: contig counting and motif searches (default: $D_NUM_THREADS)
 
 # Group-A
 group-a-width-promoter                  Width of the promoter motif model (default: $D_PROM_WIDTH_A)